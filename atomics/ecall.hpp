@@ -2,110 +2,182 @@
 #define ECALL_HPP
 
 #include <cadmium/modeling/devs/atomic.hpp>
-#include <limits>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <ostream>
 
 #include "../data_structures/messages.hpp"
+#include "../data_structures/instrument.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/time_base.hpp"
 
 /**
  * ECall (Call Generator)
  * - Receives calls from inside/outside of the elevator.
- * - Outputs the requested floor(s) immediately through call_gen.
+ * - Stamps each new call with a run-unique id, its issue time and its
+ *   source (see fe::stamp), so served outputs can be traced back to it.
+ * - Outputs the call(s) immediately through call_gen.
+ * - Keeps its clock in Time (see fe::TimeBase); ECall is ECallT<double>.
  *
  * Simplest behavior: pass-through (no additional delay), supporting message bags.
  */
-class ECall : public cadmium::Atomic<struct ECallState> {
+template <typename Time>
+struct ECallStateT;
+
+template <typename Time>
+class ECallT : public cadmium::Atomic<ECallStateT<Time>> {
 public:
+    using State = ECallStateT<Time>;
+
     // Ports
-    cadmium::Port<fe::Floor> inside_call;
-    cadmium::Port<fe::Floor> outside_call;
-    cadmium::Port<fe::Floor> call_gen;
+    cadmium::Port<fe::Call> inside_call;
+    cadmium::Port<fe::Call> outside_call;
+    cadmium::Port<fe::Call> call_gen;
+
+    explicit ECallT(const std::string& id, std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(State& s, double e) const override;
+    void internalTransition(State& s) const override;
+    void confluentTransition(State& s, double e) const override;
+    void output(const State& s) const override;
+    [[nodiscard]] double timeAdvance(const State& s) const override;
 
-    explicit ECall(const std::string& id);
+private:
+    using Base = fe::TimeBase<Time>;
 
-    void externalTransition(ECallState& s, double e) const override;
-    void internalTransition(ECallState& s) const override;
-    void confluentTransition(ECallState& s, double e) const override;
-    void output(const ECallState& s) const override;
-    [[nodiscard]] double timeAdvance(const ECallState& s) const override;
+    mutable const State* live = nullptr;  // current state, for fe::Checkpoint
+    FE_PROBE_MEMBER;
 };
 
+using ECall = ECallT<double>;
+
 // -------------------- State definition --------------------
 
 enum class ECallPhase { idle, emitting };
 
-struct ECallState {
-    double sigma;
+template <typename Time>
+struct ECallStateT {
+    Time sigma;
     ECallPhase phase;
-    std::vector<fe::Floor> pending;
+    std::vector<fe::Call> pending;
+
+    Time clock = fe::TimeBase<Time>::zero();  // absolute time of the last transition (issue times)
+    std::uint64_t last_id = 0;                // id of the last call stamped
 
-    explicit ECallState(ECallPhase p = ECallPhase::idle)
-        : sigma(std::numeric_limits<double>::infinity()), phase(p), pending() {}
+    explicit ECallStateT(ECallPhase p = ECallPhase::idle)
+        : sigma(fe::TimeBase<Time>::infinity()), phase(p), pending() {}
 };
 
-inline std::ostream& operator<<(std::ostream& os, const ECallState& s) {
+using ECallState = ECallStateT<double>;
+
+template <typename Time>
+std::ostream& operator<<(std::ostream& os, const ECallStateT<Time>& s) {
     os << "{phase:" << (s.phase == ECallPhase::idle ? "idle" : "emitting")
        << ",pending:" << s.pending.size()
-       << ",sigma:" << s.sigma << "}";
+       << ",calls:" << s.last_id
+       << ",sigma:" << fe::TimeBase<Time>::to_minutes(s.sigma) << "}";
     return os;
 }
 
+// Times are saved in minutes, so a snapshot restores under any time type.
+template <typename Time>
+void save_state(fe::SnapshotWriter& out, const ECallStateT<Time>& s, double now) {
+    using Base = fe::TimeBase<Time>;
+    out.put(fe::remaining(Base::to_minutes(s.sigma), Base::to_minutes(s.clock), now));
+    out.put(s.phase);
+    out.put(s.pending);
+    out.put(now);
+    out.put(s.last_id);
+}
+
+template <typename Time>
+void load_state(fe::SnapshotReader& in, ECallStateT<Time>& s) {
+    using Base = fe::TimeBase<Time>;
+    double sigma = 0.0;
+    double clock = 0.0;
+    in.get(sigma);
+    in.get(s.phase);
+    in.get(s.pending);
+    in.get(clock);
+    in.get(s.last_id);
+    s.sigma = Base::from_minutes(sigma);
+    s.clock = Base::from_minutes(clock);
+}
+
 // -------------------- Implementation --------------------
 
-inline ECall::ECall(const std::string& id) : cadmium::Atomic<ECallState>(id, ECallState()) {
-    inside_call  = addInPort<fe::Floor>("inside_call");
-    outside_call = addInPort<fe::Floor>("outside_call");
-    call_gen     = addOutPort<fe::Floor>("call_gen");
+template <typename Time>
+ECallT<Time>::ECallT(const std::string& id, std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<State>(id, fe::restore_state(checkpoint.get(), "ECall", id, State())) {
+    inside_call  = this->template addInPort<fe::Call>("inside_call");
+    outside_call = this->template addInPort<fe::Call>("outside_call");
+    call_gen     = this->template addOutPort<fe::Call>("call_gen");
+    fe::track_state(checkpoint.get(), "ECall", id, live);
+    FE_PROBE_REGISTER(id, "ECall");
 }
 
-inline void ECall::externalTransition(ECallState& s, double e) const {
+template <typename Time>
+void ECallT<Time>::externalTransition(State& s, double e) const {
+    FE_PROBE_ELAPSED(external, e);
     // account elapsed time
-    if (s.sigma != std::numeric_limits<double>::infinity()) {
-        s.sigma = std::max(0.0, s.sigma - e);
-    }
-
-    // Collect calls (Cadmium v2 ports store a bag/vector of messages)
-    if (!inside_call->empty()) {
-        const auto& bag = inside_call->getBag();
-        s.pending.insert(s.pending.end(), bag.begin(), bag.end());
+    const Time elapsed = Base::from_minutes(e);
+    s.clock += elapsed;
+    s.sigma = fe::elapse(s.sigma, elapsed);
+
+    // Collect and stamp calls (Cadmium v2 ports store a bag/vector of messages)
+    const double now = Base::to_minutes(s.clock);
+    for (const auto& call : inside_call->getBag()) {
+        s.pending.push_back(call);
+        fe::stamp(s.pending.back(), fe::CallSource::inside, now, s.last_id);
     }
-    if (!outside_call->empty()) {
-        const auto& bag = outside_call->getBag();
-        s.pending.insert(s.pending.end(), bag.begin(), bag.end());
+    for (const auto& call : outside_call->getBag()) {
+        s.pending.push_back(call);
+        fe::stamp(s.pending.back(), fe::CallSource::outside, now, s.last_id);
     }
 
     // If any call received, schedule an immediate output
     if (!s.pending.empty()) {
         s.phase = ECallPhase::emitting;
-        s.sigma = 0.0;
+        s.sigma = Base::zero();
     }
 }
 
-inline void ECall::output(const ECallState& s) const {
+template <typename Time>
+void ECallT<Time>::output(const State& s) const {
+    FE_PROBE(output);
     if (s.phase == ECallPhase::emitting) {
-        for (const auto& floor : s.pending) {
-            call_gen->addMessage(floor);
+        for (const auto& call : s.pending) {
+            call_gen->addMessage(call);
         }
     }
 }
 
-inline void ECall::internalTransition(ECallState& s) const {
+template <typename Time>
+void ECallT<Time>::internalTransition(State& s) const {
+    FE_PROBE(internal);
     if (s.phase == ECallPhase::emitting) {
+        s.clock += s.sigma;
         s.pending.clear();
         s.phase = ECallPhase::idle;
-        s.sigma = std::numeric_limits<double>::infinity();
+        s.sigma = Base::infinity();
     }
 }
 
-inline void ECall::confluentTransition(ECallState& s, double /*e*/) const {
+template <typename Time>
+void ECallT<Time>::confluentTransition(State& s, double /*e*/) const {
+    FE_PROBE(confluent);
     // DEVS confluent: internal then external (with e=0) is the typical choice
     internalTransition(s);
     externalTransition(s, 0.0);
 }
 
-inline double ECall::timeAdvance(const ECallState& s) const {
-    return s.sigma;
+template <typename Time>
+double ECallT<Time>::timeAdvance(const State& s) const {
+    FE_PROBE(time_advance);
+    live = &s;
+    FE_PROBE_SIGMA(Base::to_minutes(s.sigma));
+    return Base::to_minutes(s.sigma);
 }
 
 #endif
@@ -2,59 +2,117 @@
 #define ECONTROL_HPP
 
 #include <cadmium/modeling/devs/atomic.hpp>
-#include <limits>
-#include <deque>
 #include <cmath>
+#include <cstdint>
+#include <memory>
 #include <ostream>
 
 #include "../data_structures/messages.hpp"
+#include "../data_structures/instrument.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/time_base.hpp"
+#include "../data_structures/vehicle_profile.hpp"
 
 /**
  * EControl (Elevator Controller)
  * - Receives floor requests (acall) and completion feedback (fback).
- * - Computes travel time as |target - current| minutes (1 minute per floor).
+ * - Computes travel time as |target - current| minutes (1 minute per floor),
+ *   or looks it up in fe::ControlConfig::travel (motion only: EVehicle adds
+ *   the door dwell of the same profile).
  * - Sends travel time to the vehicle via timem.
- * - When the vehicle reports completion, outputs the reached floor via floor.
+ * - When the vehicle reports completion, outputs the reached floor via floor
+ *   and every request that stop completes via served (same instant), so
+ *   service latency is the output time minus fe::Call::issued.
+ * - Under fe::ControlConfig::en_route, a request for a floor the moving car
+ *   can still stop at on its way (see fe::can_stop_en_route) retargets the
+ *   trip: a new timem gives the motion time from the trip's origin to that
+ *   floor, and the old target waits for a later trip.
+ * - Under fe::ControlConfig::routes (see fe::uses_routes), plans the stops
+ *   the policy would pick next and sends them as one fe::Route on route
+ *   (timem is then for monitoring only). At every arrival it picks the next
+ *   stop as usual: if the vehicle is already on its way there, nothing is
+ *   sent (the route is extended once its last leg has started); otherwise
+ *   the route is replaced at that instant. The stops, times and outputs are
+ *   those of the single-trip commands; only the vehicle's events are fewer.
+ * - Holds at most fe::ControlConfig::request_capacity calls, inline (see
+ *   fe::PendingRequests); a call beyond that is dropped, coalesced into its
+ *   stop or output via rejected at once, per fe::ControlConfig::overflow.
+ * - Keeps sigma in Time (see fe::TimeBase); EControl is EControlT<double>.
  *
  * Simplest behavior:
- * - Single elevator, FIFO queue for requests.
- * - While moving, additional requests are queued.
+ * - Single elevator, FIFO order of requested floors (the default policy).
+ * - While moving, additional requests are queued; a request for a floor
+ *   that is already pending joins that stop instead of adding a trip.
  * - Upon arrival, controller may output both:
  *   (i) the reached floor, and
  *   (ii) the next travel time (if queue is non-empty),
  *   in the same immediate (sigma=0) internal event.
+ *
+ * Scheduling (fe::ControlConfig::policy):
+ * - fifo serves floors in the order they were first requested.
+ * - scan/look/nearest pick the next stop around the car (see fe::SchedulePolicy).
+ * - Under every policy one stop serves every request for that floor, and a
+ *   request for the floor the car is already heading to is absorbed by the
+ *   trip in progress (no zero-length trip after it).
  */
-class EControl : public cadmium::Atomic<struct EControlState> {
+template <typename Time>
+struct EControlStateT;
+
+template <typename Time>
+class EControlT : public cadmium::Atomic<EControlStateT<Time>> {
 public:
+    using State = EControlStateT<Time>;
+
     // Ports
-    cadmium::Port<fe::Floor>      acall;   // input: requested floors
+    cadmium::Port<fe::Call>       acall;   // input: requests
     cadmium::Port<fe::TravelTime> fback;   // input: arrival feedback (value ignored)
     cadmium::Port<fe::TravelTime> timem;   // output: travel time command
+    cadmium::Port<fe::Route>      route;   // output: planned stops (routes only)
     cadmium::Port<fe::Floor>      floor;   // output: reached floor
+    cadmium::Port<fe::Call>       served;  // output: requests completed at that floor
+    cadmium::Port<fe::Call>       rejected;  // output: requests refused when full
 
-    explicit EControl(const std::string& id);
+    explicit EControlT(const std::string& id, const fe::ControlConfig& config = fe::ControlConfig(),
+                       std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
 
-    void externalTransition(EControlState& s, double e) const override;
-    void internalTransition(EControlState& s) const override;
-    void confluentTransition(EControlState& s, double e) const override;
-    void output(const EControlState& s) const override;
-    [[nodiscard]] double timeAdvance(const EControlState& s) const override;
+    void externalTransition(State& s, double e) const override;
+    void internalTransition(State& s) const override;
+    void confluentTransition(State& s, double e) const override;
+    void output(const State& s) const override;
+    [[nodiscard]] double timeAdvance(const State& s) const override;
 
 private:
-    static fe::TravelTime compute_travel_time(fe::Floor from, fe::Floor to) {
-        return static_cast<fe::TravelTime>(std::abs(to - from));
+    using Base = fe::TimeBase<Time>;
+
+    fe::TravelTime compute_travel_time(fe::Floor from, fe::Floor to) const {
+        return config.travel ? config.travel->motion(from, to) : static_cast<fe::TravelTime>(std::abs(to - from));
     }
-    static void start_next_if_idle(EControlState& s);
+    void start_next_if_idle(State& s) const;
+    void plan_route(State& s) const;
+    void stop_on_the_way(State& s, fe::Floor floor) const;
+    void overflowed(State& s, const fe::Call& call, fe::Admission admission) const;
+
+    fe::ControlConfig config;
+    bool routes;                          // fe::uses_routes(config)
+    mutable const State* live = nullptr;  // current state, for fe::Checkpoint
+    FE_PROBE_MEMBER;
 };
 
+using EControl = EControlT<double>;
+
 // -------------------- State --------------------
 
-struct EControlState {
+template <typename Time>
+struct EControlStateT {
     fe::Floor current_floor = 1;
 
     // Movement bookkeeping
     bool moving = false;
     fe::Floor target_floor = 1;
+    fe::Direction direction = fe::Direction::idle;
+    Time moved = fe::TimeBase<Time>::zero();  // time since the trip began (en-route stops)
+    Time clock = fe::TimeBase<Time>::zero();  // absolute time of the last transition (snapshots)
 
     // Pending outputs for next internal event
     bool send_floor = false;
@@ -63,50 +121,192 @@ struct EControlState {
     bool send_timem = false;
     fe::TravelTime timem_to_send = 0;
 
-    // FIFO request queue
-    std::deque<fe::Floor> requests;
+    // Routes: the legs the vehicle holds after the trip in progress, and
+    // the command that changes them
+    fe::Route route;
+    bool send_route = false;
+    fe::Route route_to_send;
+
+    // Requests: pending (ordered according to the scheduling policy), riding
+    // with the trip in progress, and done (output with floor_to_send)
+    fe::PendingRequests requests;
+
+    // Requests refused at this instant, output via rejected (not saved:
+    // empty whenever the model is paused)
+    fe::CallBurst<FE_REJECT_BURST> rejected_to_send;
+    std::uint64_t overflowed = 0;  // calls not held: dropped, coalesced or rejected
 
     // Time until next internal event (0 or infinity in this model)
-    double sigma = std::numeric_limits<double>::infinity();
+    Time sigma = fe::TimeBase<Time>::infinity();
+
+    explicit EControlStateT(const fe::ControlConfig& config = fe::ControlConfig()) : requests(config) {}
 };
 
-inline std::ostream& operator<<(std::ostream& os, const EControlState& s) {
+using EControlState = EControlStateT<double>;
+
+template <typename Time>
+std::ostream& operator<<(std::ostream& os, const EControlStateT<Time>& s) {
     os << "{cur:" << s.current_floor
        << ",moving:" << (s.moving ? "T" : "F")
        << ",target:" << s.target_floor
+       << ",dir:" << fe::to_string(s.direction)
        << ",q:" << s.requests.size()
+       << ",held:" << s.requests.calls()
        << ",send_floor:" << (s.send_floor ? "T" : "F")
        << ",send_timem:" << (s.send_timem ? "T" : "F")
-       << ",sigma:" << s.sigma << "}";
+       << ",sigma:" << fe::TimeBase<Time>::to_minutes(s.sigma) << "}";
     return os;
 }
 
+// sigma is 0 only during the instant of a transition, never while paused,
+// so it is saved as is (in minutes, like every time in a snapshot); the
+// time into the trip is brought up to 'now'.
+template <typename Time>
+void save_state(fe::SnapshotWriter& out, const EControlStateT<Time>& s, double now) {
+    using Base = fe::TimeBase<Time>;
+    out.put(s.current_floor);
+    out.put(s.moving);
+    out.put(s.target_floor);
+    out.put(s.direction);
+    out.put(Base::to_minutes(s.moved) + (s.moving ? now - Base::to_minutes(s.clock) : 0.0));
+    out.put(s.send_floor);
+    out.put(s.floor_to_send);
+    out.put(s.send_timem);
+    out.put(s.timem_to_send);
+    out.put(s.route);
+    out.put(s.send_route);
+    out.put(s.route_to_send);
+    s.requests.save(out);
+    out.put(s.overflowed);
+    out.put(Base::to_minutes(s.sigma));
+    out.put(now);
+}
+
+template <typename Time>
+void load_state(fe::SnapshotReader& in, EControlStateT<Time>& s) {
+    double sigma = 0.0;
+    double moved = 0.0;
+    double clock = 0.0;
+    in.get(s.current_floor);
+    in.get(s.moving);
+    in.get(s.target_floor);
+    in.get(s.direction);
+    in.get(moved);
+    in.get(s.send_floor);
+    in.get(s.floor_to_send);
+    in.get(s.send_timem);
+    in.get(s.timem_to_send);
+    in.get(s.route);
+    in.get(s.send_route);
+    in.get(s.route_to_send);
+    s.requests.load(in);
+    in.get(s.overflowed);
+    in.get(sigma);
+    in.get(clock);
+    s.sigma = fe::TimeBase<Time>::from_minutes(sigma);
+    s.moved = fe::TimeBase<Time>::from_minutes(moved);
+    s.clock = fe::TimeBase<Time>::from_minutes(clock);
+}
+
 // -------------------- Implementation --------------------
 
-inline EControl::EControl(const std::string& id) : cadmium::Atomic<EControlState>(id, EControlState()) {
-    acall = addInPort<fe::Floor>("acall");
-    fback = addInPort<fe::TravelTime>("fback");
-    timem = addOutPort<fe::TravelTime>("timem");
-    floor = addOutPort<fe::Floor>("floor");
+template <typename Time>
+EControlT<Time>::EControlT(const std::string& id, const fe::ControlConfig& config,
+                           std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<State>(id, fe::restore_state(checkpoint.get(), "EControl", id, State(config))),
+      config(config), routes(fe::uses_routes(config)) {
+    acall  = this->template addInPort<fe::Call>("acall");
+    fback  = this->template addInPort<fe::TravelTime>("fback");
+    timem  = this->template addOutPort<fe::TravelTime>("timem");
+    route  = this->template addOutPort<fe::Route>("route");
+    floor  = this->template addOutPort<fe::Floor>("floor");
+    served = this->template addOutPort<fe::Call>("served");
+    rejected = this->template addOutPort<fe::Call>("rejected");
+    fe::track_state(checkpoint.get(), "EControl", id, live);
+    FE_PROBE_REGISTER(id, "EControl");
 }
 
-inline void EControl::start_next_if_idle(EControlState& s) {
+template <typename Time>
+void EControlT<Time>::start_next_if_idle(State& s) const {
     if (!s.moving && !s.requests.empty() && !s.send_timem) {
-        s.target_floor = s.requests.front();
-        s.requests.pop_front();
+        s.target_floor = s.requests.pop_next(s.current_floor, s.direction, config);
 
         s.timem_to_send = compute_travel_time(s.current_floor, s.target_floor);
         s.send_timem = true;
         s.moving = true;
+        s.moved = Base::zero();
+        if (routes) {
+            plan_route(s);
+        }
+
+        s.sigma = Base::zero();  // output timem immediately
+    } else if (routes && !s.moving && !s.route.empty()) {
+        // nothing left to do: drop the legs the vehicle still holds
+        s.route.clear();
+        s.route_to_send.clear();
+        s.route_to_send.append = false;
+        s.send_route = true;
+        s.sigma = Base::zero();
+    }
+}
+
+template <typename Time>
+void EControlT<Time>::plan_route(State& s) const {
+    s.route_to_send.clear();
+    if (!s.route.empty() && s.route.front().floor == s.target_floor) {
+        s.route.pop_front();  // the vehicle set off for this stop at this instant
+        if (!s.route.empty() || s.requests.empty()) {
+            return;
+        }
+        s.route_to_send.append = true;  // its last leg: extend the route
+    } else {
+        s.route.clear();
+        s.route_to_send.append = false;  // replaces the leg that just started, if any
+        s.route_to_send.push_back(s.target_floor, s.timem_to_send);
+    }
 
-        s.sigma = 0.0;  // output timem immediately
+    // The stops pop_next would pick from here on, if no other call came
+    fe::PendingRequests plan = s.requests;
+    fe::Direction direction = s.direction;
+    fe::Floor from = s.target_floor;
+    while (!plan.empty() && !s.route_to_send.full()) {
+        const fe::Floor next = plan.pop_next(from, direction, config);
+        const fe::TravelTime motion = compute_travel_time(from, next);
+        s.route_to_send.push_back(next, motion);
+        s.route.push_back(next, motion);
+        from = next;
     }
+    s.send_route = true;
 }
 
-inline void EControl::externalTransition(EControlState& s, double e) const {
+template <typename Time>
+void EControlT<Time>::stop_on_the_way(State& s, fe::Floor floor) const {
+    // the vehicle shortens its trip to this much motion from the origin
+    s.requests.divert(s.target_floor, floor);
+    s.target_floor = floor;
+    s.timem_to_send = compute_travel_time(s.current_floor, floor);
+    s.send_timem = true;
+    s.sigma = Base::zero();
+}
+
+template <typename Time>
+void EControlT<Time>::overflowed(State& s, const fe::Call& call, fe::Admission admission) const {
+    ++s.overflowed;
+    if (admission == fe::Admission::refused && config.overflow != fe::OverflowPolicy::drop) {
+        s.rejected_to_send.push_back(call);
+        s.sigma = Base::zero();
+    }
+}
+
+template <typename Time>
+void EControlT<Time>::externalTransition(State& s, double e) const {
+    FE_PROBE_ELAPSED(external, e);
     // account elapsed time
-    if (s.sigma != std::numeric_limits<double>::infinity()) {
-        s.sigma = std::max(0.0, s.sigma - e);
+    const Time elapsed = Base::from_minutes(e);
+    s.clock += elapsed;
+    s.sigma = fe::elapse(s.sigma, elapsed);
+    if (s.moving) {
+        s.moved += elapsed;
     }
 
     // 1) If we got feedback: we arrived at the current target
@@ -117,9 +317,10 @@ inline void EControl::externalTransition(EControlState& s, double e) const {
 
             s.send_floor = true;
             s.floor_to_send = s.current_floor;
+            s.requests.arrive();
 
-            s.moving = false;  // we can start another move after enqueueing any new calls
-            s.sigma = 0.0;     // ensure an immediate output event
+            s.moving = false;         // we can start another move after enqueueing any new calls
+            s.sigma = Base::zero();   // ensure an immediate output event
         }
     }
 
@@ -127,7 +328,16 @@ inline void EControl::externalTransition(EControlState& s, double e) const {
     if (!acall->empty()) {
         const auto& bag = acall->getBag();
         for (const auto& req : bag) {
-            s.requests.push_back(req);
+            // a request for the floor the trip in progress stops at rides along
+            const fe::Admission admission = (s.moving && req.floor == s.target_floor) ? s.requests.ride(req)
+                                                                                      : s.requests.push(req);
+            if (admission != fe::Admission::held) {
+                overflowed(s, req, admission);
+            }
+            if (config.en_route && s.moving && admission != fe::Admission::refused
+                && fe::can_stop_en_route(config, s.current_floor, s.target_floor, req.floor, Base::to_minutes(s.moved))) {
+                stop_on_the_way(s, req.floor);
+            }
         }
     }
 
@@ -135,30 +345,48 @@ inline void EControl::externalTransition(EControlState& s, double e) const {
     start_next_if_idle(s);
 }
 
-inline void EControl::output(const EControlState& s) const {
+template <typename Time>
+void EControlT<Time>::output(const State& s) const {
+    FE_PROBE(output);
     if (s.send_floor) {
         floor->addMessage(s.floor_to_send);
+        s.requests.for_each_done([&](const fe::Call& call) { served->addMessage(call); });
     }
+    s.rejected_to_send.for_each([&](const fe::Call& call) { rejected->addMessage(call); });
     if (s.send_timem) {
         timem->addMessage(s.timem_to_send);
     }
+    if (s.send_route) {
+        route->addMessage(s.route_to_send);
+    }
 }
 
-inline void EControl::internalTransition(EControlState& s) const {
+template <typename Time>
+void EControlT<Time>::internalTransition(State& s) const {
+    FE_PROBE(internal);
     // after output, clear pending output flags
     s.send_floor = false;
     s.send_timem = false;
-    s.sigma = std::numeric_limits<double>::infinity();
+    s.send_route = false;
+    s.requests.clear_done();
+    s.rejected_to_send.clear();
+    s.sigma = Base::infinity();
 }
 
-inline void EControl::confluentTransition(EControlState& s, double /*e*/) const {
+template <typename Time>
+void EControlT<Time>::confluentTransition(State& s, double /*e*/) const {
+    FE_PROBE(confluent);
     // internal then external with e=0 (typical)
     internalTransition(s);
     externalTransition(s, 0.0);
 }
 
-inline double EControl::timeAdvance(const EControlState& s) const {
-    return s.sigma;
+template <typename Time>
+double EControlT<Time>::timeAdvance(const State& s) const {
+    FE_PROBE(time_advance);
+    live = &s;
+    FE_PROBE_SIGMA(Base::to_minutes(s.sigma));
+    return Base::to_minutes(s.sigma);
 }
 
 #endif
@@ -0,0 +1,255 @@
+#ifndef EDISPATCH_HPP
+#define EDISPATCH_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+/**
+ * EDispatch (Group Dispatcher)
+ * - Receives floor requests (call_in) for a bank of N cars.
+ * - Assigns every request to the car with the smallest estimated arrival time.
+ * - Forwards the request to that car through car_call[i].
+ * - Listens to each car's reached floor (car_floor[i]) and to the requests it
+ *   completes or refuses (car_served[i], car_rejected[i]); once every request
+ *   assigned to a car is accounted for, its estimate is resynchronised to the
+ *   floor it last reached. Reached floors do not match requests one to one
+ *   (one stop serves every call for its floor, SCAN stops at the shaft ends),
+ *   so only the requests are counted. Under the drop and coalesce overflow
+ *   policies a full car reports neither outcome for the calls it drops or
+ *   merges, and its estimate is then only resynchronised by later calls.
+ *
+ * Estimated arrival time of car i for a request at floor f:
+ *   max(0, busy_until_i - now) + trip(tail_floor_i, f)
+ * where tail_floor_i is the last floor assigned to the car and busy_until_i is
+ * the time its already assigned work is expected to finish. trip() is the
+ * cars' fe::TravelTable (motion plus door dwell) when they run a vehicle
+ * profile, else 1 minute per floor.
+ * Ties go to the car with the lowest index, so runs are deterministic.
+ */
+class EDispatch : public cadmium::Atomic<struct EDispatchState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call> call_in;                   // input: requests
+    std::vector<cadmium::Port<fe::Floor>> car_floor;   // input: floor reached by car i
+    std::vector<cadmium::Port<fe::Call>> car_served;   // input: requests car i completed
+    std::vector<cadmium::Port<fe::Call>> car_rejected; // input: requests car i refused
+    std::vector<cadmium::Port<fe::Call>> car_call;     // output: request assigned to car i
+
+    EDispatch(const std::string& id, std::size_t cars, std::shared_ptr<const fe::TravelTable> travel = nullptr,
+              std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(EDispatchState& s, double e) const override;
+    void internalTransition(EDispatchState& s) const override;
+    void confluentTransition(EDispatchState& s, double e) const override;
+    void output(const EDispatchState& s) const override;
+    [[nodiscard]] double timeAdvance(const EDispatchState& s) const override;
+
+    // Requests assigned to car i that it has not yet served or rejected
+    [[nodiscard]] std::size_t outstanding(std::size_t car) const;
+
+private:
+    [[nodiscard]] double travel_estimate(fe::Floor from, fe::Floor to) const {
+        return travel ? travel->trip(from, to) : static_cast<double>(std::abs(to - from));
+    }
+    [[nodiscard]] std::size_t pick_car(const EDispatchState& s, fe::Floor floor) const;
+
+    std::shared_ptr<const fe::TravelTable> travel;  // the cars' trip times (null: 1 minute per floor)
+    mutable const EDispatchState* live = nullptr;  // current state, for fe::Checkpoint
+};
+
+// -------------------- State --------------------
+
+// Dispatcher's running estimate of one car's committed work.
+struct EDispatchCar {
+    fe::Floor tail_floor = 1;      // floor the car ends at once its assigned work is done
+    double busy_until = 0.0;       // absolute time at which that work is expected to finish
+    fe::Floor at_floor = 1;        // floor the car last reported reaching
+    std::size_t outstanding = 0;   // assigned requests not yet served or rejected
+};
+
+struct EDispatchState {
+    double clock = 0.0;  // absolute time of the last transition
+
+    std::vector<EDispatchCar> cars;
+
+    // Pending outputs for next internal event: (car index, request)
+    std::vector<std::pair<std::size_t, fe::Call>> assignments;
+
+    std::size_t assigned_total = 0;
+
+    // Time until next internal event (0 or infinity in this model)
+    double sigma = std::numeric_limits<double>::infinity();
+
+    explicit EDispatchState(std::size_t n = 0) : cars(n), assignments() {}
+};
+
+inline std::ostream& operator<<(std::ostream& os, const EDispatchState& s) {
+    os << "{cars:" << s.cars.size()
+       << ",assigned:" << s.assigned_total
+       << ",pending:" << s.assignments.size()
+       << ",sigma:" << s.sigma << "}";
+    return os;
+}
+
+// sigma is 0 only during the instant of a transition, never while paused,
+// so it is saved as is.
+inline void save_state(fe::SnapshotWriter& out, const EDispatchState& s, double now) {
+    out.put(now);
+    out.put(s.cars);
+    out.put(static_cast<std::uint64_t>(s.assignments.size()));
+    for (const auto& [car, call] : s.assignments) {
+        out.put(static_cast<std::uint64_t>(car));
+        out.put(call);
+    }
+    out.put(static_cast<std::uint64_t>(s.assigned_total));
+    out.put(s.sigma);
+}
+
+inline void load_state(fe::SnapshotReader& in, EDispatchState& s) {
+    const std::size_t cars = s.cars.size();
+    in.get(s.clock);
+    in.get(s.cars);
+    if (s.cars.size() != cars) {
+        throw std::runtime_error("snapshot: dispatcher saved with " + std::to_string(s.cars.size())
+                                 + " cars, model has " + std::to_string(cars));
+    }
+    std::uint64_t n = 0;
+    in.get(n);
+    s.assignments.clear();
+    for (std::uint64_t i = 0; i < n; ++i) {
+        std::uint64_t car = 0;
+        fe::Call call;
+        in.get(car);
+        in.get(call);
+        s.assignments.emplace_back(static_cast<std::size_t>(car), call);
+    }
+    std::uint64_t total = 0;
+    in.get(total);
+    s.assigned_total = static_cast<std::size_t>(total);
+    in.get(s.sigma);
+}
+
+// -------------------- Implementation --------------------
+
+inline EDispatch::EDispatch(const std::string& id, std::size_t cars, std::shared_ptr<const fe::TravelTable> travel,
+                            std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<EDispatchState>(id, fe::restore_state(checkpoint.get(), "EDispatch", id, EDispatchState(cars))),
+      travel(std::move(travel)) {
+    call_in = addInPort<fe::Call>("call_in");
+
+    car_floor.reserve(cars);
+    car_served.reserve(cars);
+    car_rejected.reserve(cars);
+    car_call.reserve(cars);
+    for (std::size_t i = 0; i < cars; ++i) {
+        car_floor.push_back(addInPort<fe::Floor>("car_floor_" + std::to_string(i)));
+        car_served.push_back(addInPort<fe::Call>("car_served_" + std::to_string(i)));
+        car_rejected.push_back(addInPort<fe::Call>("car_rejected_" + std::to_string(i)));
+        car_call.push_back(addOutPort<fe::Call>("car_call_" + std::to_string(i)));
+    }
+    fe::track_state(checkpoint.get(), "EDispatch", id, live);
+}
+
+inline std::size_t EDispatch::outstanding(std::size_t car) const {
+    return live ? live->cars.at(car).outstanding : 0;
+}
+
+inline std::size_t EDispatch::pick_car(const EDispatchState& s, fe::Floor floor) const {
+    std::size_t best = 0;
+    double best_eta = std::numeric_limits<double>::infinity();
+
+    for (std::size_t i = 0; i < s.cars.size(); ++i) {
+        const auto& car = s.cars[i];
+        const double wait = car.busy_until > s.clock ? car.busy_until - s.clock : 0.0;
+        const double eta = wait + travel_estimate(car.tail_floor, floor);
+        if (eta < best_eta) {
+            best_eta = eta;
+            best = i;
+        }
+    }
+    return best;
+}
+
+inline void EDispatch::externalTransition(EDispatchState& s, double e) const {
+    // account elapsed time
+    s.clock += e;
+    if (s.sigma != std::numeric_limits<double>::infinity()) {
+        s.sigma = std::max(0.0, s.sigma - e);
+    }
+
+    // 1) Car reports: once every request of a car is served or rejected,
+    //    resync its estimate to the floor it last reached
+    for (std::size_t i = 0; i < car_floor.size(); ++i) {
+        auto& car = s.cars[i];
+        if (!car_floor[i]->empty()) {
+            car.at_floor = car_floor[i]->getBag().back();
+        }
+        const std::size_t settled = car_served[i]->getBag().size() + car_rejected[i]->getBag().size();
+        if (settled == 0) {
+            continue;
+        }
+        car.outstanding -= std::min(car.outstanding, settled);
+        if (car.outstanding == 0) {
+            car.tail_floor = car.at_floor;
+            car.busy_until = s.clock;
+        }
+    }
+
+    // 2) Assign every new request to the car with the earliest estimated arrival
+    if (!call_in->empty()) {
+        for (const auto& call : call_in->getBag()) {
+            const std::size_t i = pick_car(s, call.floor);
+            auto& car = s.cars[i];
+
+            const double start = std::max(car.busy_until, s.clock);
+            car.busy_until = start + travel_estimate(car.tail_floor, call.floor);
+            car.tail_floor = call.floor;
+            car.outstanding++;
+
+            s.assignments.emplace_back(i, call);
+            s.assigned_total++;
+        }
+    }
+
+    // 3) Forward assignments immediately
+    if (!s.assignments.empty()) {
+        s.sigma = 0.0;
+    }
+}
+
+inline void EDispatch::output(const EDispatchState& s) const {
+    for (const auto& [car, call] : s.assignments) {
+        car_call[car]->addMessage(call);
+    }
+}
+
+inline void EDispatch::internalTransition(EDispatchState& s) const {
+    s.clock += s.sigma;
+    s.assignments.clear();
+    s.sigma = std::numeric_limits<double>::infinity();
+}
+
+inline void EDispatch::confluentTransition(EDispatchState& s, double /*e*/) const {
+    // internal then external with e=0
+    internalTransition(s);
+    externalTransition(s, 0.0);
+}
+
+inline double EDispatch::timeAdvance(const EDispatchState& s) const {
+    live = &s;
+    return s.sigma;
+}
+
+#endif
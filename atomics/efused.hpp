@@ -0,0 +1,269 @@
+#ifndef EFUSED_HPP
+#define EFUSED_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/instrument.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+/**
+ * EFused (fused single-car elevator)
+ * - One atomic with the ports of FreightElevatorTop (inside_call,
+ *   outside_call in; floor, served out) and the same observable outputs as
+ *   ECall -> EControl <-> EVehicle, including ECall's call stamping.
+ * - ECall's pass-through, EControl's send_timem / send_floor steps and the
+ *   timem / fback messages become plain state updates, so a call costs one
+ *   external transition and a trip one internal transition, with no
+ *   coupling hops and no zero-time events (except for zero-length trips
+ *   without a door dwell, which arrive at the instant they start, as in the
+ *   coupled model).
+ *
+ * Timing matches the coupled model:
+ * - A trip takes |target - current| minutes, or the motion time plus the door
+ *   dwell of fe::ControlConfig::travel (EControl's command plus EVehicle's
+ *   dwell); the floor is output once the doors have cycled.
+ * - On arrival the next stop is chosen before calls of the same instant are
+ *   enqueued (confluent = internal then external), as EControl does when
+ *   fback and acall meet at one instant.
+ * - Requests are enqueued and absorbed by the same fe::PendingRequests and
+ *   policy rules as EControl, with the same capacity and overflow policy:
+ *   a refused call is output via rejected at the instant it arrives (one
+ *   zero-time step that leaves the trip in progress untouched).
+ * - Under fe::ControlConfig::en_route a call the car can still stop for on
+ *   its way shortens the trip in progress, as EControl's retarget does to
+ *   EVehicle.
+ * Only calls of one instant that reach the model through separate zero-time
+ *   steps while a zero-length trip is in progress can be ordered differently
+ *   (the coupled model needs more steps to finish such a trip).
+ */
+class EFused : public cadmium::Atomic<struct EFusedState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call>  inside_call;
+    cadmium::Port<fe::Call>  outside_call;
+    cadmium::Port<fe::Floor> floor;    // output: reached floor
+    cadmium::Port<fe::Call>  served;   // output: requests completed at that floor
+    cadmium::Port<fe::Call>  rejected; // output: requests refused when full
+
+    explicit EFused(const std::string& id, const fe::ControlConfig& config = fe::ControlConfig(),
+                    std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(EFusedState& s, double e) const override;
+    void internalTransition(EFusedState& s) const override;
+    void confluentTransition(EFusedState& s, double e) const override;
+    void output(const EFusedState& s) const override;
+    [[nodiscard]] double timeAdvance(const EFusedState& s) const override;
+
+private:
+    double travel_time(fe::Floor from, fe::Floor to) const {
+        return config.travel ? config.travel->trip(from, to) : static_cast<double>(std::abs(to - from));
+    }
+    double motion_time(fe::Floor from, fe::Floor to) const {
+        return config.travel ? config.travel->motion(from, to) : static_cast<double>(std::abs(to - from));
+    }
+    void enqueue(EFusedState& s, const cadmium::Port<fe::Call>& port, fe::CallSource source) const;
+    void start_next_if_idle(EFusedState& s) const;
+    void stop_on_the_way(EFusedState& s, fe::Floor floor) const;
+
+    fe::ControlConfig config;
+    mutable const EFusedState* live = nullptr;  // current state, for fe::Checkpoint
+    FE_PROBE_MEMBER;
+};
+
+// -------------------- State --------------------
+
+struct EFusedState {
+    fe::Floor current_floor = 1;
+
+    // Trip in progress (EControl's moving/target plus EVehicle's timer)
+    bool moving = false;
+    fe::Floor target_floor = 1;
+    fe::Direction direction = fe::Direction::idle;
+    double moved = 0.0;  // minutes since the trip began (en-route stops)
+
+    // Requests: pending (ordered according to the scheduling policy) and
+    // riding with the trip in progress
+    fe::PendingRequests requests;
+
+    // Requests refused at this instant; while they are output the trip's
+    // remaining time waits in trip_left (not saved: empty whenever paused)
+    fe::CallBurst<FE_REJECT_BURST> rejected_to_send;
+    double trip_left = 0.0;
+    std::uint64_t overflowed = 0;  // calls not held: dropped, coalesced or rejected
+
+    // Call stamping (ECall's part)
+    double clock = 0.0;            // absolute time of the last transition
+    std::uint64_t last_id = 0;
+
+    // Time until the car reaches target_floor (infinity when idle)
+    double sigma = std::numeric_limits<double>::infinity();
+
+    explicit EFusedState(const fe::ControlConfig& config = fe::ControlConfig()) : requests(config) {}
+};
+
+inline std::ostream& operator<<(std::ostream& os, const EFusedState& s) {
+    os << "{cur:" << s.current_floor
+       << ",moving:" << (s.moving ? "T" : "F")
+       << ",target:" << s.target_floor
+       << ",dir:" << fe::to_string(s.direction)
+       << ",q:" << s.requests.size()
+       << ",held:" << s.requests.calls()
+       << ",sigma:" << s.sigma << "}";
+    return os;
+}
+
+inline void save_state(fe::SnapshotWriter& out, const EFusedState& s, double now) {
+    out.put(s.current_floor);
+    out.put(s.moving);
+    out.put(s.target_floor);
+    out.put(s.direction);
+    out.put(s.moving ? s.moved + (now - s.clock) : s.moved);
+    s.requests.save(out);
+    out.put(s.overflowed);
+    out.put(now);
+    out.put(s.last_id);
+    out.put(fe::remaining(s.sigma, s.clock, now));
+}
+
+inline void load_state(fe::SnapshotReader& in, EFusedState& s) {
+    in.get(s.current_floor);
+    in.get(s.moving);
+    in.get(s.target_floor);
+    in.get(s.direction);
+    in.get(s.moved);
+    s.requests.load(in);
+    in.get(s.overflowed);
+    in.get(s.clock);
+    in.get(s.last_id);
+    in.get(s.sigma);
+}
+
+// -------------------- Implementation --------------------
+
+inline EFused::EFused(const std::string& id, const fe::ControlConfig& config,
+                      std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<EFusedState>(id, fe::restore_state(checkpoint.get(), "EFused", id, EFusedState(config))),
+      config(config) {
+    inside_call  = addInPort<fe::Call>("inside_call");
+    outside_call = addInPort<fe::Call>("outside_call");
+    floor        = addOutPort<fe::Floor>("floor");
+    served       = addOutPort<fe::Call>("served");
+    rejected     = addOutPort<fe::Call>("rejected");
+    fe::track_state(checkpoint.get(), "EFused", id, live);
+    FE_PROBE_REGISTER(id, "EFused");
+}
+
+inline void EFused::start_next_if_idle(EFusedState& s) const {
+    if (!s.moving && !s.requests.empty()) {
+        s.target_floor = s.requests.pop_next(s.current_floor, s.direction, config);
+        s.moving = true;
+        s.moved = 0.0;
+        s.sigma = travel_time(s.current_floor, s.target_floor);
+    }
+}
+
+inline void EFused::stop_on_the_way(EFusedState& s, fe::Floor floor) const {
+    // the same departure, less motion (door dwell unchanged)
+    const double shorter = motion_time(s.current_floor, s.target_floor) - motion_time(s.current_floor, floor);
+    s.sigma = std::max(0.0, s.sigma - shorter);
+    s.requests.divert(s.target_floor, floor);
+    s.target_floor = floor;
+}
+
+inline void EFused::enqueue(EFusedState& s, const cadmium::Port<fe::Call>& port, fe::CallSource source) const {
+    for (auto req : port->getBag()) {
+        fe::stamp(req, source, s.clock, s.last_id);
+        // a request for the floor the trip in progress stops at rides along
+        const fe::Admission admission = (s.moving && req.floor == s.target_floor) ? s.requests.ride(req)
+                                                                                  : s.requests.push(req);
+        if (admission != fe::Admission::held) {
+            ++s.overflowed;
+            if (admission == fe::Admission::refused && config.overflow != fe::OverflowPolicy::drop) {
+                s.rejected_to_send.push_back(req);
+            }
+        }
+        if (config.en_route && s.moving && admission != fe::Admission::refused
+            && fe::can_stop_en_route(config, s.current_floor, s.target_floor, req.floor, s.moved)) {
+            stop_on_the_way(s, req.floor);
+        }
+    }
+}
+
+inline void EFused::externalTransition(EFusedState& s, double e) const {
+    FE_PROBE_ELAPSED(external, e);
+    // account elapsed time
+    s.clock += e;
+    if (s.sigma != std::numeric_limits<double>::infinity()) {
+        s.sigma = std::max(0.0, s.sigma - e);
+    }
+    if (s.moving) {
+        s.moved += e;
+    }
+
+    // Inside calls first, as ECall forwards them
+    if (!inside_call->empty()) {
+        enqueue(s, inside_call, fe::CallSource::inside);
+    }
+    if (!outside_call->empty()) {
+        enqueue(s, outside_call, fe::CallSource::outside);
+    }
+
+    start_next_if_idle(s);
+
+    if (!s.rejected_to_send.empty()) {
+        s.trip_left = s.sigma;  // output the refusals now, then resume the trip
+        s.sigma = 0.0;
+    }
+}
+
+inline void EFused::output(const EFusedState& s) const {
+    FE_PROBE(output);
+    s.rejected_to_send.for_each([&](const fe::Call& call) { rejected->addMessage(call); });
+    if (s.moving && (s.rejected_to_send.empty() || s.trip_left == 0.0)) {
+        floor->addMessage(s.target_floor);
+        s.requests.for_each_riding([&](const fe::Call& call) { served->addMessage(call); });
+    }
+}
+
+inline void EFused::internalTransition(EFusedState& s) const {
+    FE_PROBE(internal);
+    s.clock += s.sigma;
+    if (!s.rejected_to_send.empty()) {
+        s.rejected_to_send.clear();
+        s.sigma = s.trip_left;
+        if (!s.moving || s.trip_left > 0.0) {
+            return;  // refusals only: the trip goes on
+        }
+    }
+    // arrival: the car is at its target and may start the next trip at once
+    s.requests.arrive();
+    s.requests.clear_done();
+    s.current_floor = s.target_floor;
+    s.moving = false;
+    s.sigma = std::numeric_limits<double>::infinity();
+    start_next_if_idle(s);
+}
+
+inline void EFused::confluentTransition(EFusedState& s, double /*e*/) const {
+    FE_PROBE(confluent);
+    // internal then external with e=0, like EControl
+    internalTransition(s);
+    externalTransition(s, 0.0);
+}
+
+inline double EFused::timeAdvance(const EFusedState& s) const {
+    FE_PROBE(time_advance);
+    live = &s;
+    FE_PROBE_SIGMA(s.sigma);
+    return s.sigma;
+}
+
+#endif
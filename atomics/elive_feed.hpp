@@ -0,0 +1,124 @@
+#ifndef ELIVE_FEED_HPP
+#define ELIVE_FEED_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/realtime.hpp"
+
+/**
+ * ELiveFeed (Live Call Source)
+ * - Polls a fe::LiveFeed every 'poll' simulated minutes and outputs the calls
+ *   received since the previous poll, through inside_call or outside_call
+ *   according to their source, at the polled instant.
+ * - Stamps every call itself (id, issue time = injection time), so ECall
+ *   leaves it untouched and ERealTimeProbe can follow it by id; records its
+ *   arrival time and feed latency in the caller-owned fe::RealTimeStats.
+ *
+ * Meant to run under a driver that paces the simulation against the wall
+ * clock (top_model/main_realtime.cpp): polls then happen at the wall time
+ * their simulated time is due. Not checkpointable (the feed is live).
+ */
+class ELiveFeed : public cadmium::Atomic<struct ELiveFeedState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call> inside_call;
+    cadmium::Port<fe::Call> outside_call;
+
+    ELiveFeed(const std::string& id, std::shared_ptr<fe::LiveFeed> feed, double poll,
+              std::shared_ptr<fe::RealTimeStats> stats);
+
+    void externalTransition(ELiveFeedState& s, double e) const override;
+    void internalTransition(ELiveFeedState& s) const override;
+    void confluentTransition(ELiveFeedState& s, double e) const override;
+    void output(const ELiveFeedState& s) const override;
+    [[nodiscard]] double timeAdvance(const ELiveFeedState& s) const override;
+
+private:
+    std::shared_ptr<fe::LiveFeed> feed;
+    double poll;                                 // simulated minutes between polls
+    std::shared_ptr<fe::RealTimeStats> stats;    // owned by the caller
+    mutable std::vector<fe::LiveCall> arrivals;  // drain buffer, reused across polls
+};
+
+// -------------------- State --------------------
+
+struct ELiveFeedState {
+    std::vector<fe::Call> batch;  // calls to output at this instant
+    double clock = 0.0;           // absolute time of the last transition
+    double next_poll = 0.0;
+    std::uint64_t last_id = 0;
+    double sigma = 0.0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ELiveFeedState& s) {
+    os << "{batch:" << s.batch.size()
+       << ",next_poll:" << s.next_poll
+       << ",sigma:" << s.sigma << "}";
+    return os;
+}
+
+// -------------------- Implementation --------------------
+
+inline ELiveFeed::ELiveFeed(const std::string& id, std::shared_ptr<fe::LiveFeed> feed, double poll,
+                            std::shared_ptr<fe::RealTimeStats> stats)
+    : cadmium::Atomic<ELiveFeedState>(id, ELiveFeedState()),
+      feed(std::move(feed)), poll(poll), stats(std::move(stats)) {
+    inside_call  = addOutPort<fe::Call>("inside_call");
+    outside_call = addOutPort<fe::Call>("outside_call");
+}
+
+inline void ELiveFeed::externalTransition(ELiveFeedState& s, double e) const {
+    // no inputs: only account elapsed time
+    s.clock += e;
+    s.sigma = std::max(0.0, s.sigma - e);
+}
+
+inline void ELiveFeed::output(const ELiveFeedState& s) const {
+    for (const auto& call : s.batch) {
+        if (call.source == fe::CallSource::inside) {
+            inside_call->addMessage(call);
+        } else {
+            outside_call->addMessage(call);
+        }
+    }
+}
+
+inline void ELiveFeed::internalTransition(ELiveFeedState& s) const {
+    s.clock += s.sigma;
+    if (!s.batch.empty()) {
+        s.batch.clear();  // output at this instant, the poll is done
+    } else {
+        s.clock = s.next_poll;
+        s.next_poll += poll;
+        feed->drain(arrivals);
+        const auto now = fe::WallClock::now();
+        for (auto& live : arrivals) {
+            fe::stamp(live.call, live.call.source, s.clock, s.last_id);
+            stats->calls++;
+            stats->feed.add(fe::elapsed_ms(live.arrived, now));
+            stats->arrivals[live.call.id] = live.arrived;
+            s.batch.push_back(live.call);
+        }
+    }
+    s.sigma = s.batch.empty() ? std::max(0.0, s.next_poll - s.clock) : 0.0;
+}
+
+inline void ELiveFeed::confluentTransition(ELiveFeedState& s, double /*e*/) const {
+    // internal then external with e=0
+    internalTransition(s);
+    externalTransition(s, 0.0);
+}
+
+inline double ELiveFeed::timeAdvance(const ELiveFeedState& s) const {
+    return s.sigma;
+}
+
+#endif
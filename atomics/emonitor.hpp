@@ -0,0 +1,172 @@
+#ifndef EMONITOR_HPP
+#define EMONITOR_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/snapshot.hpp"
+
+/**
+ * EMonitor (KPI Observer)
+ * - Observes the calls entering the system (inside_call, outside_call), the
+ *   requests the system reports as served and those it refuses (rejected).
+ *   Never outputs anything.
+ * - Every served request gives one exact latency sample, output time minus
+ *   fe::Call::issued: outside call -> a wait sample, inside call -> a trip
+ *   sample.
+ * - Every new call also samples the queue depth (calls already open at its
+ *   floor, and in the whole building). A rejected call is counted apart
+ *   (fe::RunKpi::rejected) and is no longer open.
+ * - Accumulates the run's KPIs into a caller-owned fe::RunKpi: running
+ *   means plus constant-memory histograms per floor and overall, so
+ *   percentiles of any run length are available without parsing logs
+ *   (see fe::write_summary).
+ * - Restored from a snapshot, it keeps the calls open at that time (counted
+ *   as calls of the run) but starts a fresh RunKpi, so the restored run
+ *   reports steady state only.
+ */
+class EMonitor : public cadmium::Atomic<struct EMonitorState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call> inside_call;
+    cadmium::Port<fe::Call> outside_call;
+    cadmium::Port<fe::Call> served;
+    cadmium::Port<fe::Call> rejected;
+
+    EMonitor(const std::string& id, std::shared_ptr<fe::RunKpi> kpi,
+             std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(EMonitorState& s, double e) const override;
+    void internalTransition(EMonitorState& s) const override;
+    void confluentTransition(EMonitorState& s, double e) const override;
+    void output(const EMonitorState& s) const override;
+    [[nodiscard]] double timeAdvance(const EMonitorState& s) const override;
+
+private:
+    std::shared_ptr<fe::RunKpi> kpi;  // results of this run, owned by the caller
+    mutable const EMonitorState* live = nullptr;  // current state, for fe::Checkpoint
+
+    static EMonitorState initial_state(fe::RunKpi& kpi, fe::Checkpoint* checkpoint, const std::string& id);
+};
+
+// -------------------- State --------------------
+
+struct EMonitorState {
+    double clock = 0.0;  // absolute time of the last transition
+
+    // Open calls per floor: open_at[i] is floor open_first + i (see fe::floor_slot)
+    std::vector<std::size_t> open_at;
+    fe::Floor open_first = 0;
+    std::size_t open_calls = 0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const EMonitorState& s) {
+    os << "{open:" << s.open_calls << "}";
+    return os;
+}
+
+inline void save_state(fe::SnapshotWriter& out, const EMonitorState& s, double now) {
+    out.put(now);
+    out.put(s.open_at);
+    out.put(s.open_first);
+    out.put(static_cast<std::uint64_t>(s.open_calls));
+}
+
+inline void load_state(fe::SnapshotReader& in, EMonitorState& s) {
+    std::uint64_t open = 0;
+    in.get(s.clock);
+    in.get(s.open_at);
+    in.get(s.open_first);
+    in.get(open);
+    s.open_calls = static_cast<std::size_t>(open);
+}
+
+// -------------------- Implementation --------------------
+
+inline EMonitor::EMonitor(const std::string& id, std::shared_ptr<fe::RunKpi> kpi,
+                          std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<EMonitorState>(id, initial_state(*kpi, checkpoint.get(), id)), kpi(std::move(kpi)) {
+    inside_call  = addInPort<fe::Call>("inside_call");
+    outside_call = addInPort<fe::Call>("outside_call");
+    served       = addInPort<fe::Call>("served");
+    rejected     = addInPort<fe::Call>("rejected");
+    fe::track_state(checkpoint.get(), "EMonitor", id, live);
+}
+
+inline EMonitorState EMonitor::initial_state(fe::RunKpi& kpi, fe::Checkpoint* checkpoint, const std::string& id) {
+    EMonitorState s = fe::restore_state(checkpoint, "EMonitor", id, EMonitorState());
+    kpi.calls += s.open_calls;  // calls carried over from the snapshot are still open
+    kpi.last_time = s.clock;
+    return s;
+}
+
+inline void EMonitor::externalTransition(EMonitorState& s, double e) const {
+    s.clock += e;
+    kpi->last_time = s.clock;
+
+    auto enqueue = [&](const fe::Call& call) {
+        std::size_t& open = fe::floor_slot(s.open_at, s.open_first, call.floor);
+        // queue depth seen by the new call: calls already open at its floor / in the building
+        kpi->floor(call.floor).queue.add(static_cast<double>(open));
+        kpi->overall.queue.add(static_cast<double>(s.open_calls));
+
+        open++;
+        s.open_calls++;
+        kpi->calls++;
+    };
+
+    // Calls first: a call served at the instant it is made is still counted
+    for (const auto& call : outside_call->getBag()) {
+        enqueue(call);
+    }
+    for (const auto& call : inside_call->getBag()) {
+        enqueue(call);
+    }
+    auto close = [&](const fe::Call& call) {
+        std::size_t& open = fe::floor_slot(s.open_at, s.open_first, call.floor);
+        open -= std::min<std::size_t>(open, 1);
+        s.open_calls -= std::min<std::size_t>(s.open_calls, 1);
+    };
+    for (const auto& call : served->getBag()) {
+        const bool wait = call.source == fe::CallSource::outside;
+        const double elapsed = s.clock - call.issued;
+        (wait ? kpi->wait : kpi->trip).add(elapsed);
+        (wait ? kpi->floor(call.floor).wait : kpi->floor(call.floor).trip).add(elapsed);
+        (wait ? kpi->overall.wait : kpi->overall.trip).add(elapsed);
+        close(call);
+        kpi->served++;
+    }
+    for (const auto& call : rejected->getBag()) {
+        close(call);
+        kpi->rejected++;
+    }
+}
+
+inline void EMonitor::output(const EMonitorState& /*s*/) const {
+    // observer only
+}
+
+inline void EMonitor::internalTransition(EMonitorState& /*s*/) const {
+    // never scheduled
+}
+
+inline void EMonitor::confluentTransition(EMonitorState& s, double e) const {
+    externalTransition(s, e);
+}
+
+inline double EMonitor::timeAdvance(const EMonitorState& s) const {
+    live = &s;
+    return std::numeric_limits<double>::infinity();
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef EPORT_LOG_HPP
+#define EPORT_LOG_HPP
+
+#include <cadmium/core/logger/logger.hpp>
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+
+/**
+ * EPortLog (port logger)
+ * - Writes every message reaching 'in' to a cadmium::Logger, as an output
+ *   of (model_name, port_name) with model id -1, in the logger's own format.
+ * - Coupled to one output port of an experiment, it logs that port alone:
+ *   run with no coordinator logger, nothing else is formatted.
+ * - Passive: never outputs and never schedules an event. The caller starts
+ *   and stops the logger.
+ * - Not checkpointed (it holds no state of the model); give it the start
+ *   time of a restored run.
+ */
+template <typename T>
+class EPortLog : public cadmium::Atomic<struct EPortLogState> {
+public:
+    // Ports
+    cadmium::Port<T> in;
+
+    EPortLog(const std::string& id, std::shared_ptr<cadmium::Logger> logger, std::string model_name,
+             std::string port_name, double start_time = 0.0);
+
+    void externalTransition(EPortLogState& s, double e) const override;
+    void internalTransition(EPortLogState& s) const override;
+    void confluentTransition(EPortLogState& s, double e) const override;
+    void output(const EPortLogState& s) const override;
+    [[nodiscard]] double timeAdvance(const EPortLogState& s) const override;
+
+private:
+    std::shared_ptr<cadmium::Logger> logger;  // started and stopped by the caller
+    std::string model_name;
+    std::string port_name;
+};
+
+// -------------------- State --------------------
+
+struct EPortLogState {
+    double clock = 0.0;  // absolute time of the last message
+};
+
+inline std::ostream& operator<<(std::ostream& os, const EPortLogState& s) {
+    os << "{clock:" << s.clock << "}";
+    return os;
+}
+
+// -------------------- Implementation --------------------
+
+template <typename T>
+EPortLog<T>::EPortLog(const std::string& id, std::shared_ptr<cadmium::Logger> logger, std::string model_name,
+                      std::string port_name, double start_time)
+    : cadmium::Atomic<EPortLogState>(id, EPortLogState{start_time}),
+      logger(std::move(logger)), model_name(std::move(model_name)), port_name(std::move(port_name)) {
+    in = addInPort<T>("in");
+}
+
+template <typename T>
+void EPortLog<T>::externalTransition(EPortLogState& s, double e) const {
+    s.clock += e;
+    std::ostringstream text;
+    logger->lock();
+    for (const auto& message : in->getBag()) {
+        text.str(std::string());
+        text << message;
+        logger->logOutput(s.clock, -1, model_name, port_name, text.str());
+    }
+    logger->unlock();
+}
+
+template <typename T>
+void EPortLog<T>::internalTransition(EPortLogState& /*s*/) const {}
+
+template <typename T>
+void EPortLog<T>::confluentTransition(EPortLogState& s, double e) const {
+    externalTransition(s, e);
+}
+
+template <typename T>
+void EPortLog<T>::output(const EPortLogState& /*s*/) const {}
+
+template <typename T>
+double EPortLog<T>::timeAdvance(const EPortLogState& /*s*/) const {
+    return std::numeric_limits<double>::infinity();
+}
+
+#endif
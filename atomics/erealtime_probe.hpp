@@ -0,0 +1,113 @@
+#ifndef EREALTIME_PROBE_HPP
+#define EREALTIME_PROBE_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/realtime.hpp"
+
+/**
+ * ERealTimeProbe (Real-Time Observer)
+ * - Observes the calls entering the system, EControl's travel commands
+ *   (timem) and the floors reached. Never outputs anything.
+ * - Checks every observed event against the wall clock: an event processed
+ *   more than the tolerance after its simulated time is due counts as late.
+ * - Every travel command gives one latency sample (arrival on the live feed
+ *   -> command) for each call that entered the system before it and had no
+ *   command yet; see fe::RealTimeStats for the idle/queued split.
+ * Results go to the caller-owned fe::RealTimeStats.
+ */
+class ERealTimeProbe : public cadmium::Atomic<struct ERealTimeProbeState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call>       inside_call;
+    cadmium::Port<fe::Call>       outside_call;
+    cadmium::Port<fe::TravelTime> timem;
+    cadmium::Port<fe::Floor>      floor;
+
+    ERealTimeProbe(const std::string& id, std::shared_ptr<fe::RealTimeStats> stats);
+
+    void externalTransition(ERealTimeProbeState& s, double e) const override;
+    void internalTransition(ERealTimeProbeState& s) const override;
+    void confluentTransition(ERealTimeProbeState& s, double e) const override;
+    void output(const ERealTimeProbeState& s) const override;
+    [[nodiscard]] double timeAdvance(const ERealTimeProbeState& s) const override;
+
+private:
+    void enter(const ERealTimeProbeState& s, const cadmium::Port<fe::Call>& port, fe::WallClock::time_point now) const;
+
+    std::shared_ptr<fe::RealTimeStats> stats;  // owned by the caller
+};
+
+// -------------------- State --------------------
+
+struct ERealTimeProbeState {
+    double clock = 0.0;  // absolute time of the last transition
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ERealTimeProbeState& s) {
+    os << "{clock:" << s.clock << "}";
+    return os;
+}
+
+// -------------------- Implementation --------------------
+
+inline ERealTimeProbe::ERealTimeProbe(const std::string& id, std::shared_ptr<fe::RealTimeStats> stats)
+    : cadmium::Atomic<ERealTimeProbeState>(id, ERealTimeProbeState()), stats(std::move(stats)) {
+    inside_call  = addInPort<fe::Call>("inside_call");
+    outside_call = addInPort<fe::Call>("outside_call");
+    timem        = addInPort<fe::TravelTime>("timem");
+    floor        = addInPort<fe::Floor>("floor");
+}
+
+inline void ERealTimeProbe::enter(const ERealTimeProbeState& s, const cadmium::Port<fe::Call>& port,
+                                  fe::WallClock::time_point now) const {
+    for (const auto& call : port->getBag()) {
+        stats->event(s.clock, now);
+        const auto it = stats->arrivals.find(call.id);
+        if (it != stats->arrivals.end()) {
+            stats->waiting.push_back(fe::RealTimeStats::Waiting{it->second, s.clock});
+            stats->arrivals.erase(it);
+        }
+    }
+}
+
+inline void ERealTimeProbe::externalTransition(ERealTimeProbeState& s, double e) const {
+    s.clock += e;
+    const auto now = fe::WallClock::now();
+
+    // Commands first: calls entering at this step are not known to EControl yet
+    for (std::size_t i = 0; i < timem->getBag().size(); ++i) {
+        stats->event(s.clock, now);
+        for (const auto& w : stats->waiting) {
+            const double ms = fe::elapsed_ms(w.arrived, now);
+            (w.injected == s.clock ? stats->command_idle : stats->command_queued).add(ms);
+        }
+        stats->waiting.clear();
+    }
+    for (std::size_t i = 0; i < floor->getBag().size(); ++i) {
+        stats->event(s.clock, now);
+    }
+    enter(s, inside_call, now);
+    enter(s, outside_call, now);
+}
+
+inline void ERealTimeProbe::internalTransition(ERealTimeProbeState& /*s*/) const {}
+
+inline void ERealTimeProbe::confluentTransition(ERealTimeProbeState& s, double e) const {
+    externalTransition(s, e);
+}
+
+inline void ERealTimeProbe::output(const ERealTimeProbeState& /*s*/) const {}
+
+inline double ERealTimeProbe::timeAdvance(const ERealTimeProbeState& /*s*/) const {
+    return std::numeric_limits<double>::infinity();
+}
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef ETRACE_READER_HPP
+#define ETRACE_READER_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/snapshot.hpp"
+
+/**
+ * ETraceReader (Binary Call Trace Reader)
+ * - Streams a memory-mapped .fetrace file (see data_structures/call_trace.hpp).
+ * - At each record time, outputs every call recorded for that time through
+ *   inside_call or outside_call, according to the record's source.
+ *
+ * Replaces the two text IEStreams of the experiment: the trace is read in
+ * place, so there is no parsing and no per-event allocation. The state is just
+ * the index of the next record, so it is cheap to copy and to log.
+ */
+class ETraceReader : public cadmium::Atomic<struct ETraceReaderState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call> inside_call;
+    cadmium::Port<fe::Call> outside_call;
+
+    ETraceReader(const std::string& id, std::shared_ptr<const fe::TraceFile> trace,
+                 std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(ETraceReaderState& s, double e) const override;
+    void internalTransition(ETraceReaderState& s) const override;
+    void confluentTransition(ETraceReaderState& s, double e) const override;
+    void output(const ETraceReaderState& s) const override;
+    [[nodiscard]] double timeAdvance(const ETraceReaderState& s) const override;
+
+private:
+    std::shared_ptr<const fe::TraceFile> trace;
+
+    // Schedules the record at s.next (or passivates at the end of the trace).
+    static void schedule(ETraceReaderState& s, const fe::TraceFile& trace);
+    static ETraceReaderState initial_state(const fe::TraceFile& trace);
+
+    mutable const ETraceReaderState* live = nullptr;  // current state, for fe::Checkpoint
+};
+
+// -------------------- State --------------------
+
+struct ETraceReaderState {
+    std::size_t next = 0;   // index of the next record to emit
+    double clock = 0.0;     // absolute time of the last transition
+    double sigma = std::numeric_limits<double>::infinity();
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ETraceReaderState& s) {
+    os << "{next:" << s.next
+       << ",sigma:" << s.sigma << "}";
+    return os;
+}
+
+// The trace itself is not saved: restore with the same .fetrace file.
+inline void save_state(fe::SnapshotWriter& out, const ETraceReaderState& s, double now) {
+    out.put(static_cast<std::uint64_t>(s.next));
+    out.put(now);
+    out.put(fe::remaining(s.sigma, s.clock, now));
+}
+
+inline void load_state(fe::SnapshotReader& in, ETraceReaderState& s) {
+    std::uint64_t next = 0;
+    in.get(next);
+    in.get(s.clock);
+    in.get(s.sigma);
+    s.next = static_cast<std::size_t>(next);
+}
+
+// -------------------- Implementation --------------------
+
+inline ETraceReader::ETraceReader(const std::string& id, std::shared_ptr<const fe::TraceFile> trace,
+                                  std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<ETraceReaderState>(id, fe::restore_state(checkpoint.get(), "ETraceReader", id,
+                                                               initial_state(*trace))),
+      trace(std::move(trace)) {
+    inside_call  = addOutPort<fe::Call>("inside_call");
+    outside_call = addOutPort<fe::Call>("outside_call");
+    fe::track_state(checkpoint.get(), "ETraceReader", id, live);
+}
+
+inline void ETraceReader::schedule(ETraceReaderState& s, const fe::TraceFile& trace) {
+    if (s.next < trace.size()) {
+        s.sigma = std::max(0.0, trace[s.next].time - s.clock);
+    } else {
+        s.sigma = std::numeric_limits<double>::infinity();
+    }
+}
+
+inline ETraceReaderState ETraceReader::initial_state(const fe::TraceFile& trace) {
+    ETraceReaderState s;
+    schedule(s, trace);
+    return s;
+}
+
+inline void ETraceReader::externalTransition(ETraceReaderState& s, double e) const {
+    // no inputs: only account elapsed time
+    s.clock += e;
+    if (s.sigma != std::numeric_limits<double>::infinity()) {
+        s.sigma = std::max(0.0, s.sigma - e);
+    }
+}
+
+inline void ETraceReader::output(const ETraceReaderState& s) const {
+    const std::size_t n = trace->size();
+    if (s.next >= n) {
+        return;
+    }
+    const double t = (*trace)[s.next].time;
+    for (std::size_t i = s.next; i < n && (*trace)[i].time == t; ++i) {
+        const auto& rec = (*trace)[i];
+        fe::Call call;
+        call.floor = rec.floor;
+        call.source = rec.source;
+        call.direction = rec.direction;
+        call.priority = rec.priority;
+        if (rec.source == fe::CallSource::inside) {
+            inside_call->addMessage(call);
+        } else {
+            outside_call->addMessage(call);
+        }
+    }
+}
+
+inline void ETraceReader::internalTransition(ETraceReaderState& s) const {
+    const std::size_t n = trace->size();
+    if (s.next >= n) {
+        return;
+    }
+    const double t = (*trace)[s.next].time;
+    while (s.next < n && (*trace)[s.next].time == t) {
+        ++s.next;
+    }
+    s.clock = t;
+    schedule(s, *trace);
+}
+
+inline void ETraceReader::confluentTransition(ETraceReaderState& s, double /*e*/) const {
+    // internal then external with e=0
+    internalTransition(s);
+    externalTransition(s, 0.0);
+}
+
+inline double ETraceReader::timeAdvance(const ETraceReaderState& s) const {
+    live = &s;
+    return s.sigma;
+}
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef ETRAFFIC_HPP
+#define ETRAFFIC_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <ostream>
+
+#include "../data_structures/messages.hpp"
+#include "../data_structures/rng.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+/**
+ * ETraffic (Synthetic Traffic Generator)
+ * - Generates passengers from a non-homogeneous Poisson process whose rate and
+ *   floor mix follow an fe::TrafficProfile (up-peak, down-peak, inter-floor...).
+ * - Each passenger is an outside call at its origin floor (with the
+ *   direction of its trip) and an inside call for its destination floor,
+ *   both output at the arrival time.
+ *
+ * Replaces the IEStreams of the experiment for load tests: no input file, and
+ * the same seed always gives the same sequence of calls. The RNG lives in the
+ * state, so the generator costs a few arithmetic operations per call.
+ * Restored from a snapshot it continues the saved stream, or, when the
+ * fe::Checkpoint reseeds, keeps the pending arrival and draws the following
+ * ones from 'seed'.
+ */
+class ETraffic : public cadmium::Atomic<struct ETrafficState> {
+public:
+    // Ports
+    cadmium::Port<fe::Call> inside_call;
+    cadmium::Port<fe::Call> outside_call;
+
+    ETraffic(const std::string& id, fe::TrafficProfile profile, std::uint64_t seed,
+             std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(ETrafficState& s, double e) const override;
+    void internalTransition(ETrafficState& s) const override;
+    void confluentTransition(ETrafficState& s, double e) const override;
+    void output(const ETrafficState& s) const override;
+    [[nodiscard]] double timeAdvance(const ETrafficState& s) const override;
+
+private:
+    fe::TrafficProfile profile;
+
+    // Draws the next passenger after s.clock (or passivates if none can arrive).
+    static void schedule(ETrafficState& s, const fe::TrafficProfile& profile);
+    static ETrafficState initial_state(const fe::TrafficProfile& profile, std::uint64_t seed,
+                                       fe::Checkpoint* checkpoint, const std::string& id);
+
+    mutable const ETrafficState* live = nullptr;  // current state, for fe::Checkpoint
+};
+
+// -------------------- State --------------------
+
+struct ETrafficState {
+    fe::Rng rng;
+    double clock = 0.0;        // absolute time of the last transition
+    double next_time = 0.0;    // absolute time of the next arrival
+    std::size_t phase = 0;     // profile phase of the next arrival
+    fe::Passenger next{1, 1};  // passenger output at the next internal event
+    std::uint64_t generated = 0;
+    double sigma = std::numeric_limits<double>::infinity();
+
+    explicit ETrafficState(std::uint64_t seed = 0) : rng(seed) {}
+};
+
+inline std::ostream& operator<<(std::ostream& os, const ETrafficState& s) {
+    os << "{phase:" << s.phase
+       << ",from:" << s.next.origin
+       << ",to:" << s.next.destination
+       << ",n:" << s.generated
+       << ",sigma:" << s.sigma << "}";
+    return os;
+}
+
+inline void save_state(fe::SnapshotWriter& out, const ETrafficState& s, double now) {
+    out.put(s.rng.state);
+    out.put(now);
+    out.put(s.next_time);
+    out.put(static_cast<std::uint64_t>(s.phase));
+    out.put(s.next);
+    out.put(s.generated);
+    out.put(fe::remaining(s.sigma, s.clock, now));
+}
+
+inline void load_state(fe::SnapshotReader& in, ETrafficState& s) {
+    std::uint64_t phase = 0;
+    in.get(s.rng.state);
+    in.get(s.clock);
+    in.get(s.next_time);
+    in.get(phase);
+    in.get(s.next);
+    in.get(s.generated);
+    in.get(s.sigma);
+    s.phase = static_cast<std::size_t>(phase);
+}
+
+// -------------------- Implementation --------------------
+
+inline ETraffic::ETraffic(const std::string& id, fe::TrafficProfile profile, std::uint64_t seed,
+                          std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<ETrafficState>(id, initial_state(profile, seed, checkpoint.get(), id)),
+      profile(std::move(profile)) {
+    inside_call  = addOutPort<fe::Call>("inside_call");
+    outside_call = addOutPort<fe::Call>("outside_call");
+    fe::track_state(checkpoint.get(), "ETraffic", id, live);
+}
+
+inline ETrafficState ETraffic::initial_state(const fe::TrafficProfile& profile, std::uint64_t seed,
+                                             fe::Checkpoint* checkpoint, const std::string& id) {
+    if (checkpoint != nullptr && checkpoint->restoring()) {
+        ETrafficState s = checkpoint->restore("ETraffic", id, ETrafficState(seed));
+        if (checkpoint->reseed()) {
+            s.rng = fe::Rng(seed);
+        }
+        return s;
+    }
+    ETrafficState s(seed);
+    schedule(s, profile);
+    return s;
+}
+
+inline void ETraffic::schedule(ETrafficState& s, const fe::TrafficProfile& profile) {
+    double t = s.clock;
+    if (profile.next_arrival(t, s.phase, s.rng)) {
+        s.next = profile.draw(s.phase, s.rng);
+        s.next_time = t;
+        s.sigma = t - s.clock;
+    } else {
+        s.sigma = std::numeric_limits<double>::infinity();
+    }
+}
+
+inline void ETraffic::externalTransition(ETrafficState& s, double e) const {
+    // no inputs: only account elapsed time
+    s.clock += e;
+    if (s.sigma != std::numeric_limits<double>::infinity()) {
+        s.sigma = std::max(0.0, s.sigma - e);
+    }
+}
+
+inline void ETraffic::output(const ETrafficState& s) const {
+    fe::Call hall;
+    hall.floor = s.next.origin;
+    hall.direction = s.next.destination > s.next.origin ? fe::Direction::up : fe::Direction::down;
+    outside_call->addMessage(hall);
+
+    fe::Call car;
+    car.floor = s.next.destination;
+    car.source = fe::CallSource::inside;
+    inside_call->addMessage(car);
+}
+
+inline void ETraffic::internalTransition(ETrafficState& s) const {
+    s.clock = s.next_time;
+    s.generated++;
+    schedule(s, profile);
+}
+
+inline void ETraffic::confluentTransition(ETrafficState& s, double /*e*/) const {
+    // internal then external with e=0
+    internalTransition(s);
+    externalTransition(s, 0.0);
+}
+
+inline double ETraffic::timeAdvance(const ETrafficState& s) const {
+    live = &s;
+    return s.sigma;
+}
+
+#endif
@@ -2,97 +2,235 @@
 #define EVehicle_HPP
 
 #include <cadmium/modeling/devs/atomic.hpp>
-#include <limits>
+#include <memory>
 #include <ostream>
 
 #include "../data_structures/messages.hpp"
+#include "../data_structures/instrument.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/time_base.hpp"
+#include "../data_structures/vehicle_profile.hpp"
 
 /**
  * EVehicle (Elevator Vehicle)
- * - Receives a travel time (in minutes) and schedules completion after that delay.
+ * - Receives a travel time (in minutes) and schedules completion after that
+ *   delay plus the door dwell of its fe::TravelTable (none without one), so
+ *   the car reports back once its doors have cycled at the stop.
  * - When the delay expires, outputs a feedback message (fback).
+ * - Counts the delay down in Time (see fe::TimeBase); EVehicle is
+ *   EVehicleT<double>.
  *
  * Simplest behavior:
  * - Ignores new commands while already moving.
+ *
+ * Interruptible (EControl's fe::ControlConfig::en_route):
+ * - A shorter command while moving retargets the trip to a floor on its
+ *   way: the car stops once it has moved that many minutes since leaving,
+ *   so the delay left shrinks by the difference (the car is travel_time +
+ *   door dwell - sigma minutes into the trip). Longer commands are ignored.
+ *
+ * Routes (EControl under fe::ControlConfig::routes):
+ * - An fe::Route on route gives several stops at once. The vehicle runs
+ *   them back to back, each leg its motion plus the door dwell, and outputs
+ *   the leg's motion on out at every stop, as for a single command.
+ * - An appended route queues after the legs held; any other replaces the
+ *   legs not started yet, including one that started at this very instant
+ *   (the controller decides at the arrival that started it).
  */
-class EVehicle : public cadmium::Atomic<struct EVehicleState> {
+template <typename Time>
+struct EVehicleStateT;
+
+template <typename Time>
+class EVehicleT : public cadmium::Atomic<EVehicleStateT<Time>> {
 public:
+    using State = EVehicleStateT<Time>;
+
     // Ports
     cadmium::Port<fe::TravelTime> in;   // input: travel time command
+    cadmium::Port<fe::Route> route;     // input: several stops at once
     cadmium::Port<fe::TravelTime> out;  // output: completion feedback (echoes travel time)
 
-    explicit EVehicle(const std::string& id);
+    explicit EVehicleT(const std::string& id, std::shared_ptr<const fe::TravelTable> travel = nullptr,
+                       bool interruptible = false, std::shared_ptr<fe::Checkpoint> checkpoint = nullptr);
+
+    void externalTransition(State& s, double e) const override;
+    void internalTransition(State& s) const override;
+    void confluentTransition(State& s, double e) const override;
+    void output(const State& s) const override;
+    [[nodiscard]] double timeAdvance(const State& s) const override;
 
-    void externalTransition(EVehicleState& s, double e) const override;
-    void internalTransition(EVehicleState& s) const override;
-    void confluentTransition(EVehicleState& s, double e) const override;
-    void output(const EVehicleState& s) const override;
-    [[nodiscard]] double timeAdvance(const EVehicleState& s) const override;
+private:
+    using Base = fe::TimeBase<Time>;
+
+    void start_leg(State& s) const;
+
+    double door_dwell;                    // minutes per stop
+    bool interruptible;                   // accept retargets while moving
+    mutable const State* live = nullptr;  // current state, for fe::Checkpoint
+    FE_PROBE_MEMBER;
 };
 
+using EVehicle = EVehicleT<double>;
+
 // -------------------- State --------------------
 
 enum class EVehiclePhase { idle, moving };
 
-struct EVehicleState {
-    double sigma;
+template <typename Time>
+struct EVehicleStateT {
+    Time sigma;
     EVehiclePhase phase;
     fe::TravelTime travel_time;
+    Time clock = fe::TimeBase<Time>::zero();  // absolute time of the last transition (snapshots)
+    Time departed = fe::TimeBase<Time>::zero();  // clock when the trip in progress started
+    fe::Route legs;                              // route stops after the trip in progress
 
-    explicit EVehicleState(EVehiclePhase p = EVehiclePhase::idle)
-        : sigma(std::numeric_limits<double>::infinity()), phase(p), travel_time(0) {}
+    explicit EVehicleStateT(EVehiclePhase p = EVehiclePhase::idle)
+        : sigma(fe::TimeBase<Time>::infinity()), phase(p), travel_time(0) {}
 };
 
-inline std::ostream& operator<<(std::ostream& os, const EVehicleState& s) {
+using EVehicleState = EVehicleStateT<double>;
+
+template <typename Time>
+std::ostream& operator<<(std::ostream& os, const EVehicleStateT<Time>& s) {
     os << "{phase:" << (s.phase == EVehiclePhase::idle ? "idle" : "moving")
        << ",t:" << s.travel_time
-       << ",sigma:" << s.sigma << "}";
+       << ",sigma:" << fe::TimeBase<Time>::to_minutes(s.sigma)
+       << ",legs:" << s.legs.size() << "}";
     return os;
 }
 
+// Times are saved in minutes, so a snapshot restores under any time type.
+template <typename Time>
+void save_state(fe::SnapshotWriter& out, const EVehicleStateT<Time>& s, double now) {
+    using Base = fe::TimeBase<Time>;
+    out.put(fe::remaining(Base::to_minutes(s.sigma), Base::to_minutes(s.clock), now));
+    out.put(s.phase);
+    out.put(s.travel_time);
+    out.put(now);
+    out.put(Base::to_minutes(s.departed));
+    out.put(s.legs);
+}
+
+template <typename Time>
+void load_state(fe::SnapshotReader& in, EVehicleStateT<Time>& s) {
+    using Base = fe::TimeBase<Time>;
+    double sigma = 0.0;
+    double clock = 0.0;
+    double departed = 0.0;
+    in.get(sigma);
+    in.get(s.phase);
+    in.get(s.travel_time);
+    in.get(clock);
+    in.get(departed);
+    in.get(s.legs);
+    s.sigma = Base::from_minutes(sigma);
+    s.clock = Base::from_minutes(clock);
+    s.departed = Base::from_minutes(departed);
+}
+
 // -------------------- Implementation --------------------
 
-inline EVehicle::EVehicle(const std::string& id) : cadmium::Atomic<EVehicleState>(id, EVehicleState()) {
-    in  = addInPort<fe::TravelTime>("in");
-    out = addOutPort<fe::TravelTime>("out");
+template <typename Time>
+EVehicleT<Time>::EVehicleT(const std::string& id, std::shared_ptr<const fe::TravelTable> travel,
+                           bool interruptible, std::shared_ptr<fe::Checkpoint> checkpoint)
+    : cadmium::Atomic<State>(id, fe::restore_state(checkpoint.get(), "EVehicle", id, State())),
+      door_dwell(travel ? travel->door_dwell() : 0.0), interruptible(interruptible) {
+    in  = this->template addInPort<fe::TravelTime>("in");
+    route = this->template addInPort<fe::Route>("route");
+    out = this->template addOutPort<fe::TravelTime>("out");
+    fe::track_state(checkpoint.get(), "EVehicle", id, live);
+    FE_PROBE_REGISTER(id, "EVehicle");
 }
 
-inline void EVehicle::externalTransition(EVehicleState& s, double e) const {
+template <typename Time>
+void EVehicleT<Time>::externalTransition(State& s, double e) const {
+    FE_PROBE_ELAPSED(external, e);
     // account elapsed time
-    if (s.sigma != std::numeric_limits<double>::infinity()) {
-        s.sigma = std::max(0.0, s.sigma - e);
+    const Time elapsed = Base::from_minutes(e);
+    s.clock += elapsed;
+    s.sigma = fe::elapse(s.sigma, elapsed);
+
+    if (!route->empty()) {
+        const fe::Route& command = route->getBag().back();
+        if (!command.append) {
+            if (s.phase == EVehiclePhase::moving && s.departed == s.clock) {
+                s.phase = EVehiclePhase::idle;  // decided at this instant: not started
+                s.sigma = Base::infinity();
+                s.travel_time = 0;
+            }
+            s.legs.clear();
+        }
+        for (const fe::RouteLeg& leg : command) {
+            s.legs.push_back(leg.floor, leg.motion);
+        }
+        if (s.phase == EVehiclePhase::idle) {
+            start_leg(s);
+        }
     }
-
-    // Only accept a new command if idle
-    if (s.phase == EVehiclePhase::idle && !in->empty()) {
-        s.travel_time = in->getBag().back();
+    if (in->empty()) {
+        return;
+    }
+    const fe::TravelTime command = in->getBag().back();
+    if (s.phase == EVehiclePhase::idle) {
+        s.travel_time = command;
         s.phase = EVehiclePhase::moving;
-        s.sigma = static_cast<double>(s.travel_time);
+        s.sigma = Base::from_minutes(s.travel_time + door_dwell);
+        s.departed = s.clock;
+    } else if (interruptible && command < s.travel_time) {
+        // stop short: the same departure, less motion
+        s.sigma = fe::elapse(s.sigma, Base::from_minutes(s.travel_time - command));
+        s.travel_time = command;
+    }
+}
+
+template <typename Time>
+void EVehicleT<Time>::start_leg(State& s) const {
+    if (s.legs.empty()) {
+        return;
     }
+    s.travel_time = s.legs.front().motion;
+    s.legs.pop_front();
+    s.phase = EVehiclePhase::moving;
+    s.sigma = Base::from_minutes(s.travel_time + door_dwell);
+    s.departed = s.clock;
 }
 
-inline void EVehicle::output(const EVehicleState& s) const {
+template <typename Time>
+void EVehicleT<Time>::output(const State& s) const {
+    FE_PROBE(output);
     if (s.phase == EVehiclePhase::moving) {
         out->addMessage(s.travel_time);
     }
 }
 
-inline void EVehicle::internalTransition(EVehicleState& s) const {
+template <typename Time>
+void EVehicleT<Time>::internalTransition(State& s) const {
+    FE_PROBE(internal);
+    s.clock += s.sigma;
     if (s.phase == EVehiclePhase::moving) {
         s.phase = EVehiclePhase::idle;
-        s.sigma = std::numeric_limits<double>::infinity();
+        s.sigma = Base::infinity();
         s.travel_time = 0;
+        start_leg(s);  // the next stop of a route, if any
     }
 }
 
-inline void EVehicle::confluentTransition(EVehicleState& s, double /*e*/) const {
+template <typename Time>
+void EVehicleT<Time>::confluentTransition(State& s, double /*e*/) const {
+    FE_PROBE(confluent);
     // internal then external with e=0
     internalTransition(s);
     externalTransition(s, 0.0);
 }
 
-inline double EVehicle::timeAdvance(const EVehicleState& s) const {
-    return s.sigma;
+template <typename Time>
+double EVehicleT<Time>::timeAdvance(const State& s) const {
+    FE_PROBE(time_advance);
+    live = &s;
+    FE_PROBE_SIGMA(Base::to_minutes(s.sigma));
+    return Base::to_minutes(s.sigma);
 }
 
 #endif
@@ -0,0 +1,152 @@
+#ifndef BENCH_MODELS_HPP
+#define BENCH_MODELS_HPP
+
+#include <cadmium/modeling/devs/atomic.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../data_structures/messages.hpp"
+
+// Small helper atomics shared by the benchmarks in bench/.
+
+// -------------------- Fixed-rate call source --------------------
+
+struct BenchCallsState {
+  double sigma;
+  uint64_t seed;
+  fe::Call next_call;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const BenchCallsState& s) {
+  return os << "{floor:" << s.next_call.floor << ",sigma:" << s.sigma << "}";
+}
+
+class BenchCalls : public cadmium::Atomic<BenchCallsState> {
+ public:
+  cadmium::Port<fe::Call> out;
+
+  BenchCalls(const std::string& id, double interval, int floors, std::shared_ptr<uint64_t> sent)
+      : cadmium::Atomic<BenchCallsState>(id, BenchCallsState{interval, 1, fe::Call()}),
+        interval(interval), floors(floors), sent(std::move(sent)) {
+    out = addOutPort<fe::Call>("out");
+  }
+
+  void internalTransition(BenchCallsState& s) const override {
+    // 64-bit LCG (Knuth MMIX constants): cheap and identical on every platform
+    s.seed = s.seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    s.next_call.floor = 1 + static_cast<fe::Floor>((s.seed >> 33) % static_cast<uint64_t>(floors));
+    s.sigma = interval;
+    ++*sent;
+  }
+  void externalTransition(BenchCallsState& s, double e) const override { s.sigma -= e; }
+  void output(const BenchCallsState& s) const override { out->addMessage(s.next_call); }
+  [[nodiscard]] double timeAdvance(const BenchCallsState& s) const override { return s.sigma; }
+
+ private:
+  double interval;
+  int floors;
+  std::shared_ptr<uint64_t> sent;  // run counter owned by main()
+};
+
+// -------------------- Message counter --------------------
+
+struct BenchSinkState {};
+
+inline std::ostream& operator<<(std::ostream& os, const BenchSinkState& /*s*/) {
+  return os << "{}";
+}
+
+// Counts the messages of type T it receives (calls, reached floors, ...).
+template <typename T>
+class BenchSink : public cadmium::Atomic<BenchSinkState> {
+ public:
+  cadmium::Port<T> in;
+
+  BenchSink(const std::string& id, std::shared_ptr<uint64_t> served)
+      : cadmium::Atomic<BenchSinkState>(id, BenchSinkState()), served(std::move(served)) {
+    in = addInPort<T>("in");
+  }
+
+  void internalTransition(BenchSinkState& /*s*/) const override {}
+  void externalTransition(BenchSinkState& /*s*/, double /*e*/) const override { *served += in->size(); }
+  void output(const BenchSinkState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const BenchSinkState& /*s*/) const override {
+    return std::numeric_limits<double>::infinity();
+  }
+
+ private:
+  std::shared_ptr<uint64_t> served;  // run counter owned by main()
+};
+
+// -------------------- Wait / travel probe --------------------
+
+// Totals collected by BenchProbe for one run.
+struct BenchWaitStats {
+  uint64_t calls = 0;         // requests seen on 'call'
+  uint64_t served_calls = 0;  // requests whose floor was later reached
+  uint64_t stops = 0;         // floor outputs
+  double wait_sum = 0.0;      // sum of (reached - requested) over served requests
+  double travel_sum = 0.0;    // sum of all timem commands
+  uint64_t zero_trips = 0;    // timem commands of 0 minutes (stops at the car's floor)
+};
+
+struct BenchProbeState {
+  double clock = 0.0;
+  std::unordered_map<fe::Floor, std::vector<double>> waiting;  // request times per floor
+};
+
+inline std::ostream& operator<<(std::ostream& os, const BenchProbeState& s) {
+  return os << "{clock:" << s.clock << "}";
+}
+
+// Reaching a floor serves everybody waiting there, whatever the policy.
+class BenchProbe : public cadmium::Atomic<BenchProbeState> {
+ public:
+  cadmium::Port<fe::Call> call;
+  cadmium::Port<fe::Floor> floor;
+  cadmium::Port<fe::TravelTime> timem;
+
+  BenchProbe(const std::string& id, std::shared_ptr<BenchWaitStats> stats)
+      : cadmium::Atomic<BenchProbeState>(id, BenchProbeState()), stats(std::move(stats)) {
+    call = addInPort<fe::Call>("call");
+    floor = addInPort<fe::Floor>("floor");
+    timem = addInPort<fe::TravelTime>("timem");
+  }
+
+  void internalTransition(BenchProbeState& /*s*/) const override {}
+  void externalTransition(BenchProbeState& s, double e) const override {
+    s.clock += e;
+    for (const auto& c : call->getBag()) {
+      s.waiting[c.floor].push_back(s.clock);
+      stats->calls++;
+    }
+    for (const auto& f : floor->getBag()) {
+      auto& times = s.waiting[f];
+      for (double t : times) {
+        stats->wait_sum += s.clock - t;
+      }
+      stats->served_calls += times.size();
+      stats->stops++;
+      times.clear();
+    }
+    for (const auto& t : timem->getBag()) {
+      stats->travel_sum += static_cast<double>(t);
+      stats->zero_trips += t == 0;
+    }
+  }
+  void output(const BenchProbeState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const BenchProbeState& /*s*/) const override {
+    return std::numeric_limits<double>::infinity();
+  }
+
+ private:
+  std::shared_ptr<BenchWaitStats> stats;  // run totals owned by main()
+};
+
+#endif
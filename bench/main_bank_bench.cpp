@@ -0,0 +1,64 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "bench_models.hpp"
+#include "../top_model/elevator_bank.hpp"
+#include "../data_structures/messages.hpp"
+
+using namespace std;
+
+// Throughput benchmark for ElevatorBank: simulated events per wall-clock
+// second as the number of cars grows. Logging is off; the offered load grows
+// with the car count so every car sees roughly the same traffic.
+
+// -------------------- Experiment --------------------
+
+struct BankBenchExperiment : public Coupled {
+  shared_ptr<uint64_t> sent = make_shared<uint64_t>(0);
+  shared_ptr<uint64_t> served = make_shared<uint64_t>(0);
+
+  BankBenchExperiment(const string& id, size_t cars, double interval, int floors) : Coupled(id) {
+    auto calls = addComponent<BenchCalls>("calls", interval, floors, sent);
+    auto sink = addComponent<BenchSink<fe::Floor>>("sink", served);
+    auto bank = addComponent<ElevatorBank>("bank", cars);
+
+    addCoupling(calls->out, bank->outside_call);
+    addCoupling(bank->floor, sink->in);
+  }
+};
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./bank_bench [max_cars] [horizon_minutes]
+  size_t max_cars = (argc > 1) ? stoul(argv[1]) : 256;
+  double horizon = (argc > 2) ? stod(argv[2]) : 20000.0;
+
+  const int floors = 20;
+  const double calls_per_car_per_minute = 0.1;
+
+  printf("%6s %10s %10s %10s %14s\n", "cars", "calls", "served", "wall_s", "events_per_s");
+  for (size_t cars = 1; cars <= max_cars; cars *= 2) {
+    double interval = 1.0 / (calls_per_car_per_minute * static_cast<double>(cars));
+    auto model = make_shared<BankBenchExperiment>("bank_bench", cars, interval, floors);
+
+    auto root = cadmium::RootCoordinator(model);
+    auto t0 = chrono::steady_clock::now();
+    root.start();
+    root.simulate(horizon);
+    root.stop();
+    double wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    // Every call is one arrival event plus one served-floor event downstream.
+    uint64_t calls = *model->sent;
+    uint64_t served = *model->served;
+    printf("%6zu %10llu %10llu %10.3f %14.0f\n", cars,
+           static_cast<unsigned long long>(calls), static_cast<unsigned long long>(served),
+           wall, static_cast<double>(calls + served) / wall);
+  }
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "../top_model/batch.hpp"
+#include "../top_model/site.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Batch engine throughput: a fleet of independent single-car towers (the day
+// profile and the three presets at several rates, every policy, one seed
+// each) simulated by fe::ElevatorBatch, against one FreightTower per
+// instance under its own RootCoordinator, coupled and fused (a sample of
+// the fleet; their cost per instance does not depend on the fleet size).
+// Reports instances per wall-clock second and the speedup; exit status 1 if
+// a sampled instance gives other KPIs than its Cadmium model.
+
+struct Timing {
+  size_t instances = 0;
+  double wall = 0.0;
+  uint64_t served = 0;
+};
+
+static fe::RunKpi simulate(const fe::TowerSpec& spec, double horizon, bool fused) {
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<FreightTower>(spec.name, spec, kpi, fused);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  return *kpi;
+}
+
+static bool agrees(const fe::BatchKpi& batch, const fe::RunKpi& model) {
+  auto near = [](double a, double b) { return fabs(a - b) <= 1e-9 * max(1.0, fabs(b)); };
+  return batch.calls == model.calls && batch.served == model.served && near(batch.wait.mean, model.wait.mean) &&
+         near(batch.trip.mean, model.trip.mean);
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./batch_bench [instances] [horizon_minutes] [sampled]
+  const size_t count = (argc > 1) ? stoul(argv[1]) : 4096;
+  const double horizon = (argc > 2) ? stod(argv[2]) : 600.0;
+  const size_t sampled = min(count, (argc > 3) ? stoul(argv[3]) : size_t{128});
+
+  const fe::TrafficProfile day = fe::TrafficProfile::load("../input_data/traffic_day.txt");
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  vector<fe::TowerSpec> towers;
+  for (size_t i = 0; i < count; ++i) {
+    const double rate = 0.05 * static_cast<double>(1 + i % 5);
+    fe::TowerSpec tower;
+    tower.name = "instance_" + to_string(i);
+    switch ((i / 4) % 4) {
+      case 0: tower.traffic = day; break;
+      case 1: tower.traffic = fe::TrafficProfile::up_peak(day.top_floor, rate); break;
+      case 2: tower.traffic = fe::TrafficProfile::down_peak(day.top_floor, rate); break;
+      default: tower.traffic = fe::TrafficProfile::inter_floor(day.top_floor, rate); break;
+    }
+    tower.seed = i + 1;
+    tower.control.policy = policies[i % 4];
+    tower.control.bottom_floor = tower.traffic.lobby;
+    tower.control.top_floor = tower.traffic.top_floor;
+    towers.push_back(tower);
+  }
+
+  // Cadmium, one coordinator per instance, on an evenly spread sample
+  const size_t stride = count / max<size_t>(sampled, 1);
+  bool ok = true;
+  Timing models[2];
+  vector<pair<size_t, fe::RunKpi>> expected;
+  for (const bool fused : {false, true}) {
+    Timing& t = models[fused ? 1 : 0];
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < count && t.instances < sampled; i += stride) {
+      fe::RunKpi kpi = simulate(towers[i], horizon, fused);
+      t.served += kpi.served;
+      ++t.instances;
+      if (!fused) {
+        expected.emplace_back(i, std::move(kpi));
+      }
+    }
+    t.wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  }
+
+  // The whole fleet in one batch
+  Timing batch_time;
+  batch_time.instances = count;
+  auto t0 = chrono::steady_clock::now();
+  fe::ElevatorBatch batch(towers);
+  batch.run(horizon);
+  batch_time.wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  for (size_t i = 0; i < count; ++i) {
+    batch_time.served += batch.kpi(i).served;
+  }
+  for (const auto& e : expected) {
+    if (!agrees(batch.kpi(e.first), e.second)) {
+      printf("FAIL: instance %zu differs from its Cadmium model\n", e.first);
+      ok = false;
+    }
+  }
+
+  const double batch_rate = static_cast<double>(count) / batch_time.wall;
+  printf("%zu instances, %g simulated minutes each, %llu transitions in the batch\n", count, horizon,
+         static_cast<unsigned long long>(batch.transitions()));
+  printf("%-8s %10s %10s %12s %14s %9s\n", "model", "instances", "wall_s", "instances/s", "served/s", "speedup");
+  const char* names[] = {"coupled", "fused"};
+  for (size_t m = 0; m < 2; ++m) {
+    const Timing& t = models[m];
+    const double rate = static_cast<double>(t.instances) / t.wall;
+    printf("%-8s %10zu %10.3f %12.1f %14.0f %8.1fx\n", names[m], t.instances, t.wall, rate,
+           static_cast<double>(t.served) / t.wall, batch_rate / rate);
+  }
+  printf("%-8s %10zu %10.3f %12.1f %14.0f %9s\n", "batch", count, batch_time.wall, batch_rate,
+         static_cast<double>(batch_time.served) / batch_time.wall, "-");
+  printf("%s: %zu sampled instances checked against the coupled model\n", ok ? "passed" : "FAILED",
+         expected.size());
+  return ok ? 0 : 1;
+}
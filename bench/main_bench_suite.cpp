@@ -0,0 +1,265 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "bench_models.hpp"
+#include "../atomics/etraffic.hpp"
+#include "../top_model/freight_elevator_top.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+#ifndef FE_BENCH_VERSION
+#define FE_BENCH_VERSION "unknown"
+#endif
+
+using namespace std;
+
+// Simulator benchmark suite (make bench). Every scenario drives
+// FreightElevatorTop from a seeded ETraffic generator with logging off and
+// reports:
+//  - events/s: calls generated plus floors reached, per wall-clock second
+//  - wall seconds per simulated hour
+//  - peak RSS of the scenario (each one runs in its own forked process)
+//  - heap allocations per event (global operator new is counted below)
+// Results go to a JSON file, one scenario per line; --compare flags
+// scenarios whose events/s dropped by more than --tolerance.
+
+// -------------------- Allocation counter --------------------
+
+static uint64_t g_allocs = 0;
+
+// GCC flags free() on memory from operator new once these are inlined into
+// library code, although both sides are replaced together here.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new(size_t size) {
+  ++g_allocs;
+  if (void* p = malloc(size ? size : 1)) {
+    return p;
+  }
+  throw bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+#pragma GCC diagnostic pop
+
+// -------------------- Scenarios --------------------
+
+struct Scenario {
+  const char* name;
+  const char* pattern;  // up / down / inter
+  fe::Floor floors;
+  double rate;          // passengers per minute
+  fe::SchedulePolicy policy;
+  double horizon;       // simulated minutes
+};
+
+// Load is relative to one car: ~0.1 passengers/min keeps a 10-floor car busy
+static const Scenario kScenarios[] = {
+  {"light",          "inter",   10, 0.02, fe::SchedulePolicy::fifo, 1.0e7},
+  {"peak",           "up",      10, 0.08, fe::SchedulePolicy::look, 5.0e6},
+  {"saturated",      "inter",   10, 0.50, fe::SchedulePolicy::look, 1.0e6},
+  {"tall_peak",      "up",     500, 0.02, fe::SchedulePolicy::look, 5.0e6},
+  {"tall_saturated", "inter", 1000, 0.50, fe::SchedulePolicy::look, 1.0e6},
+};
+
+struct BenchExperiment : public Coupled {
+  shared_ptr<uint64_t> calls = make_shared<uint64_t>(0);
+  shared_ptr<uint64_t> floors = make_shared<uint64_t>(0);
+
+  BenchExperiment(const string& id, const fe::TrafficProfile& profile, const fe::ControlConfig& config)
+      : Coupled(id) {
+    auto traffic = addComponent<ETraffic>("traffic", profile, 1);
+    auto system = addComponent<FreightElevatorTop>("freight_elevator", config);
+    auto call_sink = addComponent<BenchSink<fe::Call>>("call_sink", calls);
+    auto floor_sink = addComponent<BenchSink<fe::Floor>>("floor_sink", floors);
+
+    addCoupling(traffic->inside_call, system->inside_call);
+    addCoupling(traffic->outside_call, system->outside_call);
+    addCoupling(traffic->inside_call, call_sink->in);
+    addCoupling(traffic->outside_call, call_sink->in);
+    addCoupling(system->floor, floor_sink->in);
+  }
+};
+
+struct Result {
+  uint64_t events = 0;
+  double wall_s = 0.0;
+  long peak_rss_kb = 0;
+  uint64_t allocs = 0;
+};
+
+static fe::TrafficProfile make_profile(const Scenario& sc, double rate) {
+  if (strcmp(sc.pattern, "up") == 0) {
+    return fe::TrafficProfile::up_peak(sc.floors, rate);
+  }
+  if (strcmp(sc.pattern, "down") == 0) {
+    return fe::TrafficProfile::down_peak(sc.floors, rate);
+  }
+  return fe::TrafficProfile::inter_floor(sc.floors, rate);
+}
+
+static Result run_scenario(const Scenario& sc, double scale) {
+  fe::ControlConfig config;
+  config.policy = sc.policy;
+  config.top_floor = sc.floors;
+
+  auto model = make_shared<BenchExperiment>("bench", make_profile(sc, sc.rate), config);
+  auto root = cadmium::RootCoordinator(model);
+
+  Result r;
+  const uint64_t allocs0 = g_allocs;
+  auto t0 = chrono::steady_clock::now();
+  root.start();
+  root.simulate(sc.horizon * scale);
+  root.stop();
+  r.wall_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  r.allocs = g_allocs - allocs0;
+  r.events = *model->calls + *model->floors;
+
+  rusage usage {};
+  getrusage(RUSAGE_SELF, &usage);
+  r.peak_rss_kb = usage.ru_maxrss;  // kilobytes on Linux
+  return r;
+}
+
+// Runs the scenario in a child process so its peak RSS is its own.
+static bool run_isolated(const Scenario& sc, double scale, Result& r) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    Result child = run_scenario(sc, scale);
+    const bool ok = write(fds[1], &child, sizeof(child)) == static_cast<ssize_t>(sizeof(child));
+    _exit(ok ? 0 : 1);
+  }
+  close(fds[1]);
+  const bool ok = read(fds[0], &r, sizeof(r)) == static_cast<ssize_t>(sizeof(r));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// events_per_s of every scenario of a previous result file
+static vector<pair<string, double>> read_baseline(const string& path) {
+  vector<pair<string, double>> out;
+  ifstream file(path);
+  string line;
+  while (getline(file, line)) {
+    const size_t n = line.find("\"name\": \"");
+    const size_t e = line.find("\"events_per_s\": ");
+    if (n == string::npos || e == string::npos) {
+      continue;
+    }
+    const size_t start = n + 9;
+    out.emplace_back(line.substr(start, line.find('"', start) - start), strtod(line.c_str() + e + 16, nullptr));
+  }
+  return out;
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./bench_suite [--out file] [--scale f] [--only name] [--compare file] [--tolerance f]
+  string out_path = "../simulation_results/bench.json";
+  string compare_path;
+  string only;
+  double scale = 1.0;
+  double tolerance = 0.10;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const string arg = argv[i];
+    if (arg == "--out") {
+      out_path = argv[i + 1];
+    } else if (arg == "--scale") {
+      scale = stod(argv[i + 1]);
+    } else if (arg == "--only") {
+      only = argv[i + 1];
+    } else if (arg == "--compare") {
+      compare_path = argv[i + 1];
+    } else if (arg == "--tolerance") {
+      tolerance = stod(argv[i + 1]);
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      return 2;
+    }
+  }
+
+  const auto baseline = compare_path.empty() ? vector<pair<string, double>>() : read_baseline(compare_path);
+
+  vector<string> entries;
+
+  printf("%-15s %12s %9s %14s %12s %10s %12s\n",
+         "scenario", "events", "wall_s", "events_per_s", "s_per_sim_h", "rss_kb", "allocs_per_ev");
+  int regressions = 0;
+  for (const Scenario& sc : kScenarios) {
+    if (!only.empty() && only != sc.name) {
+      continue;
+    }
+    Result r;
+    if (!run_isolated(sc, scale, r)) {
+      fprintf(stderr, "scenario %s failed\n", sc.name);
+      return 1;
+    }
+    const double events_per_s = static_cast<double>(r.events) / r.wall_s;
+    const double per_hour = r.wall_s / (sc.horizon * scale / 60.0);
+    const double allocs_per_event = r.events ? static_cast<double>(r.allocs) / static_cast<double>(r.events) : 0.0;
+
+    printf("%-15s %12llu %9.3f %14.0f %12.3e %10ld %12.2f", sc.name, static_cast<unsigned long long>(r.events),
+           r.wall_s, events_per_s, per_hour, r.peak_rss_kb, allocs_per_event);
+    for (const auto& [name, base] : baseline) {
+      if (name == sc.name && base > 0.0) {
+        const double ratio = events_per_s / base;
+        printf("  %.2fx vs baseline%s", ratio, ratio < 1.0 - tolerance ? "  REGRESSION" : "");
+        regressions += ratio < 1.0 - tolerance;
+      }
+    }
+    printf("\n");
+
+    char line[512];
+    snprintf(line, sizeof(line),
+             "    {\"name\": \"%s\", \"pattern\": \"%s\", \"floors\": %d, \"rate\": %g, \"policy\": \"%s\", "
+             "\"horizon_min\": %g, \"events\": %llu, \"wall_s\": %.6f, \"events_per_s\": %.1f, "
+             "\"wall_s_per_sim_hour\": %.6e, \"peak_rss_kb\": %ld, \"allocs\": %llu, \"allocs_per_event\": %.4f}",
+             sc.name, sc.pattern, sc.floors, sc.rate, fe::to_string(sc.policy),
+             sc.horizon * scale, static_cast<unsigned long long>(r.events), r.wall_s, events_per_s, per_hour,
+             r.peak_rss_kb, static_cast<unsigned long long>(r.allocs), allocs_per_event);
+    entries.push_back(line);
+  }
+
+  ofstream out(out_path);
+  out << "{\n  \"version\": \"" << FE_BENCH_VERSION << "\",\n  \"scale\": " << scale << ",\n  \"scenarios\": [\n";
+  for (size_t i = 0; i < entries.size(); ++i) {
+    out << entries[i] << (i + 1 < entries.size() ? ",\n" : "\n");
+  }
+  out << "  ]\n}\n";
+  printf("results written to %s\n", out_path.c_str());
+  if (regressions > 0) {
+    printf("%d scenario(s) regressed by more than %.0f%%\n", regressions, tolerance * 100.0);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "../top_model/experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// En-route stops: one car under synthetic up-peak traffic (ETraffic, fixed
+// seed), each policy with fe::ControlConfig::en_route off and on, at 1
+// minute per floor and with a 4 m storey S-curve vehicle profile. Reports
+// the served calls, the wait (outside call -> car at the origin) and trip
+// (inside call -> car at the destination) means and p90, and the change of
+// both means with en-route stops. Up-peak hall calls are at the lobby, which
+// a car on its way up never passes, so the stops mostly shorten trips.
+// Exit status 1 if a run with en-route stops serves fewer calls than without.
+
+struct Outcome {
+  uint64_t calls = 0;
+  uint64_t served = 0;
+  double wait = 0.0;
+  double wait_p90 = 0.0;
+  double trip = 0.0;
+  double trip_p90 = 0.0;
+  double wall_s = 0.0;
+};
+
+static Outcome run(const fe::TrafficProfile& profile, const fe::ControlConfig& config, double horizon) {
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<FreightElevatorTrafficExperiment>("enroute_bench", profile, 11, config, kpi, true);
+  auto root = cadmium::RootCoordinator(model);
+  auto t0 = chrono::steady_clock::now();
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+
+  Outcome o;
+  o.wall_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  o.calls = kpi->calls;
+  o.served = kpi->served;
+  o.wait = kpi->overall.wait.mean();
+  o.wait_p90 = kpi->overall.wait.quantile(0.9);
+  o.trip = kpi->overall.trip.mean();
+  o.trip_p90 = kpi->overall.trip.quantile(0.9);
+  return o;
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./enroute_bench [horizon_minutes] [floors]
+  const double horizon = (argc > 1) ? stod(argv[1]) : 1000000.0;
+  const fe::Floor floors = (argc > 2) ? stoi(argv[2]) : 20;
+
+  // Passengers per minute: light, peak and near saturation for one car (the
+  // S-curve car covers a storey in seconds, but dwells 20 s at every stop)
+  const double linear_rates[] = {0.02, 0.04, 0.06};
+  const double profiled_rates[] = {0.3, 0.6, 0.9};
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::look,
+                                         fe::SchedulePolicy::nearest};
+  const auto table = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, floors, 4.0));
+
+  printf("%-7s %6s %-8s %-9s %8s %8s %9s %9s %9s %9s %8s %8s %8s\n", "vehicle", "rate", "policy", "en_route",
+         "calls", "served", "wait", "wait_p90", "trip", "trip_p90", "wait_%", "trip_%", "wall_s");
+  bool ok = true;
+  for (const bool profiled : {false, true}) {
+    for (const double rate : profiled ? profiled_rates : linear_rates) {
+      const auto profile = fe::TrafficProfile::up_peak(floors, rate);
+      for (const auto policy : policies) {
+        fe::ControlConfig config;
+        config.policy = policy;
+        config.top_floor = floors;
+        config.travel = profiled ? table : nullptr;
+        Outcome base;
+        for (const bool en_route : {false, true}) {
+          config.en_route = en_route;
+          const Outcome o = run(profile, config, horizon);
+          if (!en_route) {
+            base = o;
+          }
+          const double wait_change = base.wait > 0.0 ? 100.0 * (o.wait - base.wait) / base.wait : 0.0;
+          const double trip_change = base.trip > 0.0 ? 100.0 * (o.trip - base.trip) / base.trip : 0.0;
+          printf("%-7s %6.3f %-8s %-9s %8llu %8llu %9.2f %9.2f %9.2f %9.2f %+8.1f %+8.1f %8.3f\n",
+                 profiled ? "s-curve" : "linear", rate, fe::to_string(policy), en_route ? "on" : "off",
+                 static_cast<unsigned long long>(o.calls), static_cast<unsigned long long>(o.served), o.wait,
+                 o.wait_p90, o.trip, o.trip_p90, wait_change, trip_change, o.wall_s);
+          if (en_route && o.served + o.served / 100 < base.served) {
+            printf("FAIL: en-route stops served fewer calls\n");
+            ok = false;
+          }
+        }
+      }
+    }
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+#include <malloc.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "../atomics/econtrol.hpp"
+#include "../atomics/efused.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+
+using namespace std;
+
+// Per-instance memory footprint of the controller states (EControlState and
+// EFusedState), as held by the thousands of models of a sweep: sizeof plus
+// the heap each state owns, after a busy history (a burst of calls over the
+// whole building, all served) and with a number of calls left pending.
+// Heap bytes are counted by the global operator new below.
+
+static int64_t g_heap = 0;  // live heap bytes (usable size of each block)
+
+// GCC flags free() on memory from operator new once these are inlined into
+// callers; they are the replacement allocation functions, so that is moot.
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size) {
+  if (void* p = malloc(size ? size : 1)) {
+    g_heap += static_cast<int64_t>(malloc_usable_size(p));
+    return p;
+  }
+  throw bad_alloc();
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept {
+  if (p) {
+    g_heap -= static_cast<int64_t>(malloc_usable_size(p));
+  }
+  free(p);
+}
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+
+// Drives one state through 'burst' calls over 'floors' floors (all served),
+// then leaves 'pending' calls queued.
+template <typename State>
+static void exercise(State& s, const fe::ControlConfig& config, int floors, int burst, int pending) {
+  fe::Call call;
+  for (int i = 0; i < burst; ++i) {
+    call.id = static_cast<uint64_t>(i + 1);
+    call.floor = 1 + (i * 7) % floors;
+    s.requests.push(call);
+  }
+  while (!s.requests.empty()) {
+    s.current_floor = s.requests.pop_next(s.current_floor, s.direction, config);
+    s.requests.arrive();
+    s.requests.clear_done();
+  }
+  for (int i = 0; i < pending; ++i) {
+    call.id = static_cast<uint64_t>(burst + i + 1);
+    call.floor = 1 + (i * 3) % floors;
+    s.requests.push(call);
+  }
+}
+
+template <typename State>
+static void measure(const char* name, int floors, int pending, size_t instances) {
+  fe::ControlConfig config;
+  config.policy = fe::SchedulePolicy::look;
+  config.top_floor = floors;
+
+  vector<State> states(instances, State(config));
+  const int64_t heap0 = g_heap;
+  for (auto& s : states) {
+    exercise(s, config, floors, 64, pending);
+  }
+  const double heap = static_cast<double>(g_heap - heap0) / static_cast<double>(instances);
+  printf("%-14s %7d %8d %8zu %10.0f %10.0f\n", name, floors, pending, sizeof(State), heap,
+         static_cast<double>(sizeof(State)) + heap);
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./footprint_bench [instances]
+  size_t instances = (argc > 1) ? stoul(argv[1]) : 10000;
+
+  printf("%-14s %7s %8s %8s %10s %10s\n", "state", "floors", "pending", "sizeof", "heap_B", "total_B");
+  for (int floors : {10, 100}) {
+    for (int pending : {0, 8, 32, 64}) {
+      measure<EControlState>("EControlState", floors, pending, instances);
+    }
+  }
+  for (int floors : {10, 100}) {
+    for (int pending : {0, 8, 32, 64}) {
+      measure<EFusedState>("EFusedState", floors, pending, instances);
+    }
+  }
+  return 0;
+}
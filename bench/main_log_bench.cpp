@@ -0,0 +1,187 @@
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "cadmium/core/logger/csv.hpp"
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "../top_model/experiment.hpp"
+#include "../data_structures/binary_log.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/log_select.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+
+using namespace std;
+
+// Logging overhead on a large trace: the trace-driven top model is run with
+// no logger, with a logger that discards everything, with cadmium::CSVLogger
+// and with fe::AsyncBinaryLogger. Cadmium formats every state and message
+// with operator<< before calling any logger, so the discard run is the floor
+// no logger can go below; the table reports the overhead of each logger both
+// against the unlogged run and against that floor. The binary log is then
+// decoded and compared with the CSV byte for byte. Two selective logs follow
+// (freight_elevator_top --log): the floor_out port alone through an EPortLog
+// sink with no coordinator logger, and the Econtrol model alone through
+// fe::FilteredLogger; each must hold exactly the matching lines of the full
+// CSV.
+
+// Receives the formatted strings and drops them
+struct DiscardLogger : public cadmium::Logger {
+  void start() override {}
+  void stop() override {}
+  void logOutput(double, long, const string&, const string&, const string&) override {}
+  void logState(double, long, const string&, const string&) override {}
+};
+
+static double timed(const function<void()>& fn) {
+  auto t0 = chrono::steady_clock::now();
+  fn();
+  return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+static double run(const string& trace, const fe::ControlConfig& config, const shared_ptr<cadmium::Logger>& logger) {
+  auto model = make_shared<FreightElevatorTraceExperiment>("log_bench", trace, config);
+  return timed([&] {
+    auto root = cadmium::RootCoordinator(model);
+    if (logger) {
+      root.setLogger(logger);
+    }
+    root.start();
+    root.simulate(numeric_limits<double>::infinity());
+    root.stop();
+  });
+}
+
+static double run_ports(const string& trace, const fe::ControlConfig& config,
+                        const shared_ptr<cadmium::Logger>& logger) {
+  auto model = make_shared<PortLoggedExperiment<FreightElevatorTraceExperiment>>(
+      "log_bench", logger, vector<string>{"floor_out"}, 0.0, trace, config);
+  return timed([&] {
+    auto root = cadmium::RootCoordinator(model);
+    logger->start();
+    root.start();
+    root.simulate(numeric_limits<double>::infinity());
+    root.stop();
+    logger->stop();
+  });
+}
+
+// Data lines of a CSV log whose model name (third field) is 'model' and, if
+// 'port' is set, whose port name is 'port', as "time;data"
+static vector<string> select_lines(const string& path, const string& model, const string& port) {
+  ifstream file(path);
+  vector<string> lines;
+  string line;
+  getline(file, line);  // header
+  while (getline(file, line)) {
+    const size_t a = line.find(';');
+    const size_t b = line.find(';', a + 1);
+    const size_t c = line.find(';', b + 1);
+    const size_t d = line.find(';', c + 1);
+    if (d == string::npos || line.compare(b + 1, c - b - 1, model) != 0) {
+      continue;
+    }
+    if (port.empty()) {
+      lines.push_back(line);
+    } else if (line.compare(c + 1, d - c - 1, port) == 0) {
+      lines.push_back(line.substr(0, a) + line.substr(d));
+    }
+  }
+  return lines;
+}
+
+static vector<string> all_lines(const string& path) {
+  ifstream file(path);
+  vector<string> lines;
+  string line;
+  getline(file, line);  // header
+  while (getline(file, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+static string slurp(const string& path) {
+  ifstream file(path, ios::binary);
+  stringstream ss;
+  ss << file.rdbuf();
+  return ss.str();
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./log_bench [calls]
+  uint64_t calls = (argc > 1) ? stoull(argv[1]) : 200000;
+  const int floors = 20;
+
+  const string inside = "../simulation_results/log_bench_inside.txt";
+  const string outside = "../simulation_results/log_bench_outside.txt";
+  const string trace = "../simulation_results/log_bench.fetrace";
+  const string csv = "../simulation_results/log_bench.csv";
+  const string felog = "../simulation_results/log_bench.felog";
+  const string decoded = "../simulation_results/log_bench_decoded.csv";
+  const string floor_csv = "../simulation_results/log_bench_floor_out.csv";
+  const string econtrol_csv = "../simulation_results/log_bench_econtrol.csv";
+
+  // Alternate inside/outside calls, one every half minute
+  {
+    ofstream in_file(inside), out_file(outside);
+    uint64_t seed = 1;
+    for (uint64_t i = 0; i < calls; ++i) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      fe::Floor floor = 1 + static_cast<fe::Floor>((seed >> 33) % floors);
+      (i % 2 ? out_file : in_file) << (0.5 * static_cast<double>(i)) << ' ' << floor << '\n';
+    }
+  }
+  fe::convert_text_trace(inside, outside, trace);
+
+  fe::ControlConfig config;
+  config.policy = fe::SchedulePolicy::look;
+  config.top_floor = floors;
+
+  double none_s = run(trace, config, nullptr);
+  double discard_s = run(trace, config, make_shared<DiscardLogger>());
+  double csv_s = run(trace, config, make_shared<cadmium::CSVLogger>(csv, ";"));
+  auto binary = make_shared<fe::AsyncBinaryLogger>(felog);
+  double binary_s = run(trace, config, binary);
+  double floor_s = run_ports(trace, config, make_shared<cadmium::CSVLogger>(floor_csv, ";"));
+  auto filtered = make_shared<fe::FilteredLogger>(make_shared<cadmium::CSVLogger>(econtrol_csv, ";"),
+                                                  vector<string>{"Econtrol"});
+  double filtered_s = run(trace, config, filtered);
+
+  size_t lines = 0;
+  double decode_s = timed([&] {
+    ofstream out(decoded);
+    lines = fe::decode_binary_log(felog, out);
+  });
+  const bool identical = slurp(csv) == slurp(decoded);
+  // floor_out carries Econtrol's floor outputs; the filtered log keeps Econtrol's lines
+  const bool floor_ok = select_lines(csv, "Econtrol", "floor") == select_lines(floor_csv, "log_bench", "floor_out");
+  const bool filtered_ok = select_lines(csv, "Econtrol", "") == all_lines(econtrol_csv);
+
+  printf("calls: %llu, log lines: %zu (%llu binary records)\n", static_cast<unsigned long long>(calls), lines,
+         static_cast<unsigned long long>(binary->records()));
+  printf("%-14s %10s %12s %16s\n", "logger", "wall_s", "overhead_s", "beyond_format_s");
+  printf("%-14s %10.3f %12s %16s\n", "none", none_s, "-", "-");
+  printf("%-14s %10.3f %12.3f %16s\n", "discard", discard_s, discard_s - none_s, "-");
+  printf("%-14s %10.3f %12.3f %16.3f\n", "csv", csv_s, csv_s - none_s, csv_s - discard_s);
+  printf("%-14s %10.3f %12.3f %16.3f\n", "async_binary", binary_s, binary_s - none_s, binary_s - discard_s);
+  printf("%-14s %10.3f %12.3f %16s\n", "floor_out", floor_s, floor_s - none_s, "-");
+  printf("%-14s %10.3f %12.3f %16.3f\n", "Econtrol", filtered_s, filtered_s - none_s, filtered_s - discard_s);
+  printf("overhead reduction: %.1fx total, %.1fx beyond formatting (decode afterwards: %.3f s, matches csv: %s)\n",
+         (csv_s - none_s) / (binary_s - none_s), (csv_s - discard_s) / max(binary_s - discard_s, 1e-9),
+         decode_s, identical ? "yes" : "NO");
+  printf("selective logs: floor_out %s, Econtrol %s (%llu of %llu records kept)\n",
+         floor_ok ? "matches csv" : "DIFFERS", filtered_ok ? "matches csv" : "DIFFERS",
+         static_cast<unsigned long long>(filtered->kept()),
+         static_cast<unsigned long long>(filtered->kept() + filtered->dropped()));
+  return identical && floor_ok && filtered_ok ? 0 : 1;
+}
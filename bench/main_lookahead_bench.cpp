@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "../top_model/experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/lookahead.hpp"
+#include "../data_structures/rng.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Lookahead dispatching: single fused cars under up-peak, inter-floor and
+// the day profile, several seeds, dispatched by fifo, look, nearest and
+// lookahead (fe::ElevatorFork rollouts of ControlConfig::lookahead minutes).
+// Reports hall-call wait (mean, p90, max) and trip time per policy, summed
+// over the seeds, and the change against fifo; then the cost of one
+// decision (ns per pop_next) against the number of pending stops.
+// Exit status 1 if lookahead does not cut the mean wait of fifo on every load.
+
+struct Outcome {
+  uint64_t served = 0;
+  double wait = 0.0;
+  double p90 = 0.0;
+  double max = 0.0;
+  double trip = 0.0;
+  double wall_s = 0.0;
+};
+
+static Outcome run(const fe::TrafficProfile& profile, const fe::ControlConfig& config, double horizon,
+                   const vector<uint64_t>& seeds) {
+  fe::Histogram wait(1e-3);
+  fe::Histogram trip(1e-3);
+  Outcome o;
+  auto t0 = chrono::steady_clock::now();
+  for (const uint64_t seed : seeds) {
+    auto kpi = make_shared<fe::RunKpi>();
+    auto model = make_shared<FreightElevatorTrafficExperiment>("lookahead_bench", profile, seed, config, kpi, true);
+    auto root = cadmium::RootCoordinator(model);
+    root.start();
+    root.simulate(horizon);
+    root.stop();
+    o.served += kpi->served;
+    wait.merge(kpi->overall.wait);
+    trip.merge(kpi->overall.trip);
+  }
+  o.wall_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  o.wait = wait.mean();
+  o.p90 = wait.quantile(0.9);
+  o.max = wait.max();
+  o.trip = trip.mean();
+  return o;
+}
+
+// ns per decision from a car at the middle of a 'floors' building holding
+// 'calls' calls on random floors
+static double decision_ns(fe::SchedulePolicy policy, size_t calls, fe::Floor floors, size_t rounds) {
+  fe::ControlConfig config;
+  config.policy = policy;
+  config.top_floor = floors;
+  fe::Rng rng(calls);
+  vector<fe::PendingRequests> queues;
+  for (size_t q = 0; q < 64; ++q) {
+    fe::PendingRequests r(config);
+    for (size_t k = 0; k < calls; ++k) {
+      fe::Call c;
+      c.floor = 1 + static_cast<fe::Floor>(rng.below(static_cast<uint64_t>(floors)));
+      c.id = k + 1;
+      c.issued = static_cast<double>(k);
+      r.push(c);
+    }
+    queues.push_back(r);
+  }
+  int64_t sink = 0;
+  auto t0 = chrono::steady_clock::now();
+  for (size_t i = 0; i < rounds; ++i) {
+    fe::PendingRequests r = queues[i % queues.size()];
+    fe::Direction direction = fe::Direction::idle;
+    sink += r.pop_next(floors / 2, direction, config);
+  }
+  const double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+  if (sink == 0) {
+    printf("(no decision)\n");
+  }
+  return ns / static_cast<double>(rounds);
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./lookahead_bench [horizon_minutes] [seeds] [lookahead_minutes]
+  const double horizon = (argc > 1) ? stod(argv[1]) : 20000.0;
+  const size_t seed_count = (argc > 2) ? stoul(argv[2]) : 4;
+  const double lookahead = (argc > 3) ? stod(argv[3]) : 20.0;
+  vector<uint64_t> seeds;
+  for (size_t s = 0; s < seed_count; ++s) {
+    seeds.push_back(s + 1);
+  }
+
+  struct Load {
+    const char* name;
+    fe::TrafficProfile profile;
+  };
+  const Load loads[] = {
+    {"up", fe::TrafficProfile::up_peak(20, 0.06)},
+    {"inter", fe::TrafficProfile::inter_floor(20, 0.08)},
+    {"day", fe::TrafficProfile::load("../input_data/traffic_day.txt")},
+  };
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::look,
+                                         fe::SchedulePolicy::nearest, fe::SchedulePolicy::lookahead};
+
+  printf("%zu seeds x %g simulated minutes per load, lookahead %g minutes\n", seeds.size(), horizon, lookahead);
+  printf("%-6s %-10s %9s %9s %9s %9s %9s %9s %8s\n", "load", "policy", "served", "wait", "p90", "max", "trip",
+         "vs_fifo", "wall_s");
+  bool ok = true;
+  for (const Load& load : loads) {
+    fe::ControlConfig config;
+    config.bottom_floor = load.profile.lobby;
+    config.top_floor = load.profile.top_floor;
+    config.lookahead = lookahead;
+    double fifo_wait = 0.0;
+    for (const auto policy : policies) {
+      config.policy = policy;
+      const Outcome o = run(load.profile, config, horizon, seeds);
+      if (policy == fe::SchedulePolicy::fifo) {
+        fifo_wait = o.wait;
+      }
+      printf("%-6s %-10s %9llu %9.3f %9.3f %9.3f %9.3f %+8.1f%% %8.3f\n", load.name, fe::to_string(policy),
+             static_cast<unsigned long long>(o.served), o.wait, o.p90, o.max, o.trip,
+             100.0 * (o.wait - fifo_wait) / fifo_wait, o.wall_s);
+      if (policy == fe::SchedulePolicy::lookahead && !(o.wait < fifo_wait)) {
+        printf("FAIL: lookahead does not cut the fifo wait\n");
+        ok = false;
+      }
+    }
+  }
+
+  printf("\n%-8s %12s %12s %12s %12s\n", "calls", "fifo_ns", "look_ns", "nearest_ns", "lookahead_ns");
+  for (const size_t calls : {2, 4, 8, 16, 32, 64}) {
+    if (calls > FE_REQUEST_CAPACITY) {
+      break;
+    }
+    const size_t rounds = 200000 / calls;
+    printf("%-8zu %12.1f %12.1f %12.1f %12.1f\n", calls,
+           decision_ns(fe::SchedulePolicy::fifo, calls, 20, rounds),
+           decision_ns(fe::SchedulePolicy::look, calls, 20, rounds),
+           decision_ns(fe::SchedulePolicy::nearest, calls, 20, rounds),
+           decision_ns(fe::SchedulePolicy::lookahead, calls, 20, rounds / 4));
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "../top_model/experiment.hpp"
+#include "../data_structures/instrument.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Route commands: the same runs with fe::ControlConfig::routes off (one
+// travel time per stop) and on (planned stops as one fe::Route), single cars
+// and banks under up-peak and inter-floor traffic. Built with FE_INSTRUMENT,
+// so the FE_PROBE counters give the state transitions the simulator ran for
+// the probed atomics (ECall, EControl, EVehicle) per served call. The KPIs
+// must not change; exit status 1 if they do, or if routes do not cut the
+// transitions per served call.
+
+struct Outcome {
+  uint64_t served = 0;
+  double wait = 0.0;
+  double trip = 0.0;
+  uint64_t vehicle = 0;  // EVehicle transitions
+  uint64_t control = 0;  // EControl transitions
+  uint64_t all = 0;      // every probed transition
+  double wall_s = 0.0;
+};
+
+template <typename Experiment, typename... Args>
+static Outcome run(double horizon, Args&&... args) {
+  auto& profiler = fe::instrument::Profiler::current();
+  const uint64_t vehicle0 = profiler.transitions("EVehicle");
+  const uint64_t control0 = profiler.transitions("EControl");
+  const uint64_t all0 = profiler.transitions();
+
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<Experiment>("route_bench", std::forward<Args>(args)..., kpi, false);
+  auto root = cadmium::RootCoordinator(model);
+  auto t0 = chrono::steady_clock::now();
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+
+  Outcome o;
+  o.wall_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  o.served = kpi->served;
+  o.wait = kpi->overall.wait.mean();
+  o.trip = kpi->overall.trip.mean();
+  o.vehicle = profiler.transitions("EVehicle") - vehicle0;
+  o.control = profiler.transitions("EControl") - control0;
+  o.all = profiler.transitions() - all0;
+  return o;
+}
+
+static double per(uint64_t n, uint64_t served) {
+  return served > 0 ? static_cast<double>(n) / static_cast<double>(served) : 0.0;
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./route_bench [horizon_minutes]
+  const double horizon = (argc > 1) ? stod(argv[1]) : 200000.0;
+  fe::instrument::Profiler::current().set_trace_limit(0);
+
+  struct Load {
+    const char* name;
+    fe::TrafficProfile profile;
+    size_t cars;
+  };
+  const Load loads[] = {
+    {"up/1", fe::TrafficProfile::up_peak(20, 0.05), 1},
+    {"inter/1", fe::TrafficProfile::inter_floor(20, 0.08), 1},
+    {"up/4", fe::TrafficProfile::up_peak(20, 0.2), 4},
+    {"inter/4", fe::TrafficProfile::inter_floor(20, 0.3), 4},
+  };
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::look,
+                                         fe::SchedulePolicy::nearest};
+
+  printf("%-8s %-8s %-7s %9s %9s %9s %10s %10s %10s %9s %8s\n", "load", "policy", "routes", "served", "wait",
+         "trip", "veh_per", "ctl_per", "all_per", "change", "wall_s");
+  bool ok = true;
+  for (const Load& load : loads) {
+    for (const auto policy : policies) {
+      fe::ControlConfig config;
+      config.policy = policy;
+      config.bottom_floor = load.profile.lobby;
+      config.top_floor = load.profile.top_floor;
+      Outcome base;
+      for (const bool routes : {false, true}) {
+        config.routes = routes;
+        const Outcome o = load.cars == 1
+            ? run<FreightElevatorTrafficExperiment>(horizon, load.profile, uint64_t{5}, config)
+            : run<ElevatorBankTrafficExperiment>(horizon, load.cars, load.profile, uint64_t{5}, config);
+        if (!routes) {
+          base = o;
+        }
+        const double change = 100.0 * (per(o.all, o.served) - per(base.all, base.served)) / per(base.all, base.served);
+        printf("%-8s %-8s %-7s %9llu %9.3f %9.3f %10.2f %10.2f %10.2f %+8.1f%% %8.3f\n", load.name,
+               fe::to_string(policy), routes ? "on" : "off", static_cast<unsigned long long>(o.served), o.wait,
+               o.trip, per(o.vehicle, o.served), per(o.control, o.served), per(o.all, o.served), change, o.wall_s);
+        if (routes && (o.served != base.served || fabs(o.wait - base.wait) > 1e-9 * max(1.0, base.wait) ||
+                       fabs(o.trip - base.trip) > 1e-9 * max(1.0, base.trip))) {
+          printf("FAIL: routes changed the KPIs\n");
+          ok = false;
+        }
+        if (routes && o.all >= base.all) {
+          printf("FAIL: routes did not cut the transitions\n");
+          ok = false;
+        }
+      }
+    }
+  }
+  return ok ? 0 : 1;
+}
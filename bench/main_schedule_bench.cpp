@@ -0,0 +1,147 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/lib/iestream.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "bench_models.hpp"
+#include "../atomics/econtrol.hpp"
+#include "../atomics/evehicle.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+
+using namespace std;
+
+// Compares EControl scheduling policies against FIFO on the input_data traces
+// and on synthetic uniform traces: served calls per hour, commanded travel time
+// per served call (and the saving relative to FIFO), mean wait (request ->
+// floor reached) and wall time. Under saturation the car travels for the whole
+// horizon whatever the policy, so the per-call figure is the one to compare.
+// 'synthetic_mash' presses three buttons every few seconds: repeated calls
+// for a pending floor must merge into its stop (no extra or zero-length trips).
+
+// Same wiring as ElevatorCoupled, with timem exposed so it can be measured.
+struct TappedElevator : public Coupled {
+  Port<fe::Call> acall;
+  Port<fe::Floor> floor;
+  Port<fe::TravelTime> timem;
+
+  TappedElevator(const string& id, const fe::ControlConfig& config) : Coupled(id) {
+    acall = addInPort<fe::Call>("acall");
+    floor = addOutPort<fe::Floor>("floor");
+    timem = addOutPort<fe::TravelTime>("timem");
+
+    auto control = addComponent<EControl>("Econtrol", config);
+    auto vehicle = addComponent<EVehicle>("Evehicle", config.travel);
+
+    addCoupling(acall, control->acall);
+    addCoupling(control->timem, vehicle->in);
+    addCoupling(vehicle->out, control->fback);
+    addCoupling(control->floor, floor);
+    addCoupling(control->timem, timem);
+  }
+};
+
+struct ScheduleBenchExperiment : public Coupled {
+  shared_ptr<BenchWaitStats> stats = make_shared<BenchWaitStats>();
+  shared_ptr<uint64_t> sent = make_shared<uint64_t>(0);
+
+  // Trace files replayed through IEStream
+  ScheduleBenchExperiment(const string& id, const vector<string>& files, const fe::ControlConfig& config)
+      : Coupled(id) {
+    auto [elevator, probe] = build(config);
+    for (size_t i = 0; i < files.size(); ++i) {
+      auto stream = addComponent<cadmium::lib::IEStream<fe::Call>>("calls_" + to_string(i), files[i]);
+      addCoupling(stream->out, elevator->acall);
+      addCoupling(stream->out, probe->call);
+    }
+  }
+
+  // Synthetic uniform trace: one call every 'interval' minutes
+  ScheduleBenchExperiment(const string& id, double interval, int floors, const fe::ControlConfig& config)
+      : Coupled(id) {
+    auto [elevator, probe] = build(config);
+    auto calls = addComponent<BenchCalls>("calls", interval, floors, sent);
+    addCoupling(calls->out, elevator->acall);
+    addCoupling(calls->out, probe->call);
+  }
+
+ private:
+  pair<shared_ptr<TappedElevator>, shared_ptr<BenchProbe>> build(const fe::ControlConfig& config) {
+    auto elevator = addComponent<TappedElevator>("elevator", config);
+    auto probe = addComponent<BenchProbe>("probe", stats);
+    addCoupling(elevator->floor, probe->floor);
+    addCoupling(elevator->timem, probe->timem);
+    return {elevator, probe};
+  }
+};
+
+struct Scenario {
+  string name;
+  vector<string> files;  // empty: synthetic
+  double interval;
+  int floors;
+  double horizon;
+};
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./schedule_bench [synthetic_horizon_minutes]
+  double horizon = (argc > 1) ? stod(argv[1]) : 100000.0;
+  const double drain = numeric_limits<double>::infinity();
+
+  vector<Scenario> scenarios = {
+      {"top_inputs", {"../input_data/inside_calls.txt", "../input_data/outside_calls.txt"}, 0, 5, drain},
+      {"elevator_calls", {"../input_data/elevator_calls_test.txt"}, 0, 5, drain},
+      {"synthetic_light", {}, 8.0, 20, horizon},
+      {"synthetic_peak", {}, 4.0, 20, horizon},
+      {"synthetic_saturated", {}, 1.0, 20, horizon},
+      {"synthetic_tall", {}, 2.0, 100, horizon},
+      {"synthetic_mash", {}, 0.05, 3, horizon / 10},
+  };
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+
+  printf("%-20s %-8s %8s %8s %9s %8s %10s %11s %12s %8s %11s %8s\n", "scenario", "policy", "calls", "served",
+         "served/h", "stops", "zero_trips", "travel_min", "travel/call", "saved_%", "mean_wait", "wall_s");
+  for (const auto& sc : scenarios) {
+    double fifo_per_call = 0.0;
+    for (auto policy : policies) {
+      fe::ControlConfig config;
+      config.policy = policy;
+      config.top_floor = sc.floors;
+
+      auto model = sc.files.empty()
+          ? make_shared<ScheduleBenchExperiment>("schedule_bench", sc.interval, sc.floors, config)
+          : make_shared<ScheduleBenchExperiment>("schedule_bench", sc.files, config);
+
+      auto root = cadmium::RootCoordinator(model);
+      auto t0 = chrono::steady_clock::now();
+      root.start();
+      root.simulate(sc.horizon);
+      root.stop();
+      double wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+      const auto& st = *model->stats;
+      double served = static_cast<double>(st.served_calls);
+      double per_call = served > 0 ? st.travel_sum / served : 0.0;
+      if (policy == fe::SchedulePolicy::fifo) {
+        fifo_per_call = per_call;
+      }
+      double saved = fifo_per_call > 0 ? 100.0 * (fifo_per_call - per_call) / fifo_per_call : 0.0;
+      double mean_wait = served > 0 ? st.wait_sum / served : 0.0;
+      double span = sc.horizon != drain ? sc.horizon : st.travel_sum;
+      double per_hour = span > 0 ? 60.0 * served / span : 0.0;
+      printf("%-20s %-8s %8llu %8llu %9.2f %8llu %10llu %11.0f %12.2f %8.1f %11.2f %8.3f\n", sc.name.c_str(),
+             fe::to_string(policy), static_cast<unsigned long long>(st.calls),
+             static_cast<unsigned long long>(st.served_calls), per_hour, static_cast<unsigned long long>(st.stops),
+             static_cast<unsigned long long>(st.zero_trips), st.travel_sum, per_call, saved, mean_wait, wall);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../top_model/site.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Scaling benchmark for fe::run_site: a site of independent towers on the
+// day profile (one seed each), simulated sequentially under one coordinator,
+// then on 1, 2, 4 ... threads. Reports calls per wall-clock second, the
+// speedup over the sequential run and whether the KPIs match it exactly.
+
+struct SiteResult {
+  double wall = 0.0;
+  uint64_t calls = 0;
+  vector<shared_ptr<fe::RunKpi>> kpis;
+};
+
+static SiteResult run(const vector<fe::TowerSpec>& towers, const fe::SiteOptions& options) {
+  SiteResult r;
+  for (size_t i = 0; i < towers.size(); ++i) {
+    r.kpis.push_back(make_shared<fe::RunKpi>());
+  }
+  auto t0 = chrono::steady_clock::now();
+  fe::run_site(towers, options, r.kpis);
+  r.wall = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  for (const auto& k : r.kpis) {
+    r.calls += k->calls;
+  }
+  return r;
+}
+
+static bool identical(const SiteResult& a, const SiteResult& b) {
+  for (size_t i = 0; i < a.kpis.size(); ++i) {
+    const fe::RunKpi& x = *a.kpis[i];
+    const fe::RunKpi& y = *b.kpis[i];
+    if (x.calls != y.calls || x.served != y.served || x.wait.mean != y.wait.mean || x.wait.m2 != y.wait.m2
+        || x.trip.mean != y.trip.mean || x.trip.m2 != y.trip.m2) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./site_bench [towers] [horizon_minutes] [sync_minutes] [profile]
+  size_t tower_count = (argc > 1) ? stoul(argv[1]) : 32;
+  double horizon = (argc > 2) ? stod(argv[2]) : 600.0;
+  double sync = (argc > 3) ? stod(argv[3]) : 0.0;
+  string profile_path = (argc > 4) ? argv[4] : "../input_data/traffic_day.txt";
+
+  const fe::TrafficProfile profile = fe::TrafficProfile::load(profile_path);
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::look, fe::SchedulePolicy::nearest,
+                                         fe::SchedulePolicy::scan, fe::SchedulePolicy::fifo};
+  vector<fe::TowerSpec> towers;
+  for (size_t i = 0; i < tower_count; ++i) {
+    fe::TowerSpec tower;
+    tower.name = "tower_" + to_string(i);
+    tower.traffic = profile;
+    tower.seed = i + 1;
+    tower.control.policy = policies[i % 4];
+    tower.control.bottom_floor = profile.lobby;
+    tower.control.top_floor = profile.top_floor;
+    towers.push_back(tower);
+  }
+
+  fe::SiteOptions options;
+  options.horizon = horizon;
+  options.sync = sync;
+  options.sequential = true;
+  const SiteResult reference = run(towers, options);
+
+  printf("%zu towers, %g minutes, sync %g\n", tower_count, horizon, sync);
+  printf("%10s %10s %10s %14s %8s %10s\n", "threads", "calls", "wall_s", "calls_per_s", "speedup", "identical");
+  printf("%10s %10llu %10.3f %14.0f %8.2f %10s\n", "seq", static_cast<unsigned long long>(reference.calls),
+         reference.wall, static_cast<double>(reference.calls) / reference.wall, 1.0, "-");
+
+  const size_t max_threads = max<size_t>(1, thread::hardware_concurrency());
+  options.sequential = false;
+  for (size_t threads = 1;; threads *= 2) {
+    threads = min(threads, max_threads);
+    options.threads = threads;
+    const SiteResult r = run(towers, options);
+    printf("%10zu %10llu %10.3f %14.0f %8.2f %10s\n", threads, static_cast<unsigned long long>(r.calls), r.wall,
+           static_cast<double>(r.calls) / r.wall, reference.wall / r.wall, identical(reference, r) ? "yes" : "NO");
+    if (threads == max_threads) {
+      break;
+    }
+  }
+  return 0;
+}
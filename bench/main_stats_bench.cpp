@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cadmium/core/logger/csv.hpp"
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "../top_model/experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/log_stats.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Log analytics throughput: a bank of cars under up-peak traffic is logged
+// to CSV in full, then fe::analyze_log parses the log on 1, 2, 4 ... threads.
+// The reference is a newline count over the same mapping (memchr, i.e. the
+// rate at which the machine can touch the bytes). Every thread count must
+// give the same statistics, and those must agree with the run's own EMonitor
+// KPIs (calls, served, waits and trips; means up to the log's 6 digits).
+// Exit status 1 on any mismatch.
+
+static double timed(const function<void()>& fn) {
+  auto t0 = chrono::steady_clock::now();
+  fn();
+  return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+static bool close(double a, double b, double tolerance) {
+  return fabs(a - b) <= tolerance * max(1.0, fabs(a));
+}
+
+// Same statistics, up to summation order
+static bool same(const fe::LogStats& a, const fe::LogStats& b) {
+  bool ok = a.lines == b.lines && a.states == b.states && a.outputs == b.outputs &&
+            a.service.calls == b.service.calls && a.service.served == b.service.served &&
+            a.controllers.size() == b.controllers.size() && a.vehicles.size() == b.vehicles.size() &&
+            a.queue.size() == b.queue.size() && a.service.overall.wait.count() == b.service.overall.wait.count() &&
+            close(a.service.overall.wait.mean(), b.service.overall.wait.mean(), 1e-9);
+  for (size_t i = 0; ok && i < a.controllers.size(); ++i) {
+    ok = a.controllers[i].trips == b.controllers[i].trips && a.controllers[i].served == b.controllers[i].served &&
+         a.controllers[i].peak_calls == b.controllers[i].peak_calls;
+  }
+  for (size_t i = 0; ok && i < a.vehicles.size(); ++i) {
+    ok = a.vehicles[i].trips == b.vehicles[i].trips && close(a.vehicles[i].busy, b.vehicles[i].busy, 1e-9);
+  }
+  for (size_t i = 0; ok && i < a.queue.size(); ++i) {
+    ok = close(a.queue[i].calls, b.queue[i].calls, 1e-9) && a.queue[i].peak == b.queue[i].peak;
+  }
+  return ok;
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./stats_bench [horizon_minutes] [cars]
+  const double horizon = (argc > 1) ? stod(argv[1]) : 20000.0;
+  const size_t cars = (argc > 2) ? stoul(argv[2]) : 4;
+  const string csv = "../simulation_results/stats_bench.csv";
+
+  const auto profile = fe::TrafficProfile::up_peak(20, 0.4);
+  fe::ControlConfig config;
+  config.policy = fe::SchedulePolicy::look;
+  config.top_floor = profile.top_floor;
+  auto kpi = make_shared<fe::RunKpi>();
+  const double log_s = timed([&] {
+    auto model = make_shared<ElevatorBankTrafficExperiment>("stats_bench", cars, profile, 3, config, kpi);
+    auto root = cadmium::RootCoordinator(model);
+    root.setLogger(make_shared<cadmium::CSVLogger>(csv, ";"));
+    root.start();
+    root.simulate(horizon);
+    root.stop();
+  });
+
+  // Reference: touch every byte of the mapping once
+  size_t newlines = 0;
+  size_t bytes = 0;
+  const double scan_s = timed([&] {
+    fe::MappedFile file(csv);
+    bytes = file.size();
+    const char* p = file.data();
+    const char* end = p + file.size();
+    while (p < end) {
+      const void* nl = memchr(p, '\n', static_cast<size_t>(end - p));
+      if (nl == nullptr) {
+        break;
+      }
+      ++newlines;
+      p = static_cast<const char*>(nl) + 1;
+    }
+  });
+
+  printf("log: %.1f MB, %zu lines, written in %.3f s; newline scan %.3f s (%.0f MB/s)\n",
+         static_cast<double>(bytes) / 1e6, newlines, log_s, scan_s, static_cast<double>(bytes) / 1e6 / scan_s);
+  printf("%8s %10s %10s %12s\n", "threads", "wall_s", "MB_per_s", "vs_scan");
+
+  bool ok = true;
+  fe::LogStats first;
+  const unsigned cores = max(1U, thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= max(4U, cores); threads *= 2) {
+    fe::LogStatsOptions options;
+    options.threads = threads;
+    fe::LogStats stats;
+    const double wall = timed([&] { stats = fe::analyze_log(csv, options); });
+    printf("%8u %10.3f %10.0f %11.2fx\n", threads, wall, static_cast<double>(bytes) / 1e6 / wall, wall / scan_s);
+    if (threads == 1) {
+      first = stats;
+    } else if (!same(first, stats)) {
+      printf("FAIL: %u threads differ from 1 thread\n", threads);
+      ok = false;
+    }
+  }
+
+  // Against the EMonitor of the same run
+  const fe::FloorKpi& k = first.service.overall;
+  const bool kpi_ok = first.service.calls == kpi->calls && first.service.served == kpi->served &&
+                      k.wait.count() == kpi->overall.wait.count() && k.trip.count() == kpi->overall.trip.count() &&
+                      close(k.wait.mean(), kpi->overall.wait.mean(), 1e-3) &&
+                      close(k.trip.mean(), kpi->overall.trip.mean(), 1e-3);
+  uint64_t commanded = 0;
+  uint64_t completed = 0;
+  double busy = 0.0;
+  for (const auto& c : first.controllers) {
+    commanded += c.trips;
+  }
+  for (const auto& v : first.vehicles) {
+    completed += v.trips;
+    busy += v.busy;
+  }
+  const bool trips_ok = first.controllers.size() == cars && first.vehicles.size() == cars &&
+                        completed <= commanded && commanded - completed <= cars;
+  printf("calls %llu (monitor %llu), served %llu (monitor %llu), mean wait %.4f (monitor %.4f), "
+         "trips %llu, utilization %.1f%%: %s\n",
+         static_cast<unsigned long long>(first.service.calls), static_cast<unsigned long long>(kpi->calls),
+         static_cast<unsigned long long>(first.service.served), static_cast<unsigned long long>(kpi->served),
+         k.wait.mean(), kpi->overall.wait.mean(), static_cast<unsigned long long>(commanded),
+         100.0 * busy / (static_cast<double>(cars) * first.end_time),
+         kpi_ok && trips_ok ? "matches the run" : "MISMATCH");
+  return ok && kpi_ok && trips_ok ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/lib/iestream.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "bench_models.hpp"
+#include "../atomics/etrace_reader.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+
+using namespace std;
+
+// Input throughput: text IEStreams vs the memory-mapped ETraceReader, on a
+// generated trace of N calls. Measured once with the inputs alone (parsing
+// cost only) and once driving FreightElevatorTop with LOOK scheduling.
+
+struct TextInputsOnly : public Coupled {
+  shared_ptr<uint64_t> received = make_shared<uint64_t>(0);
+
+  TextInputsOnly(const string& id, const string& inside, const string& outside) : Coupled(id) {
+    auto in_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("inside_calls", inside);
+    auto out_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("outside_calls", outside);
+    auto sink = addComponent<BenchSink<fe::Call>>("sink", received);
+    addCoupling(in_calls->out, sink->in);
+    addCoupling(out_calls->out, sink->in);
+  }
+};
+
+struct TraceInputsOnly : public Coupled {
+  shared_ptr<uint64_t> received = make_shared<uint64_t>(0);
+
+  TraceInputsOnly(const string& id, const string& trace) : Coupled(id) {
+    auto calls = addComponent<ETraceReader>("calls", make_shared<const fe::TraceFile>(trace));
+    auto sink = addComponent<BenchSink<fe::Call>>("sink", received);
+    addCoupling(calls->inside_call, sink->in);
+    addCoupling(calls->outside_call, sink->in);
+  }
+};
+
+static double timed(const function<void()>& fn) {
+  auto t0 = chrono::steady_clock::now();
+  fn();
+  return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+static double run(const shared_ptr<Coupled>& model) {
+  return timed([&] {
+    auto root = cadmium::RootCoordinator(model);
+    root.start();
+    root.simulate(numeric_limits<double>::infinity());
+    root.stop();
+  });
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./trace_bench [calls]
+  uint64_t calls = (argc > 1) ? stoull(argv[1]) : 2000000;
+  const int floors = 20;
+
+  const string inside = "../simulation_results/trace_bench_inside.txt";
+  const string outside = "../simulation_results/trace_bench_outside.txt";
+  const string trace = "../simulation_results/trace_bench.fetrace";
+
+  // Alternate inside/outside calls, one every half minute
+  {
+    ofstream in_file(inside), out_file(outside);
+    uint64_t seed = 1;
+    for (uint64_t i = 0; i < calls; ++i) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      fe::Floor floor = 1 + static_cast<fe::Floor>((seed >> 33) % floors);
+      (i % 2 ? out_file : in_file) << (0.5 * static_cast<double>(i)) << ' ' << floor << '\n';
+    }
+  }
+
+  double convert_s = timed([&] { fe::convert_text_trace(inside, outside, trace); });
+
+  fe::ControlConfig config;
+  config.policy = fe::SchedulePolicy::look;
+  config.top_floor = floors;
+
+  auto text_only = make_shared<TextInputsOnly>("text_only", inside, outside);
+  auto trace_only = make_shared<TraceInputsOnly>("trace_only", trace);
+  double text_only_s = run(text_only);
+  double trace_only_s = run(trace_only);
+  double text_full_s = run(make_shared<FreightElevatorExperiment>("text_full", inside, outside, config));
+  double trace_full_s = run(make_shared<FreightElevatorTraceExperiment>("trace_full", trace, config));
+
+  auto rate = [&](double s) { return static_cast<double>(calls) / s; };
+  printf("calls: %llu (text inputs delivered %llu, trace delivered %llu)\n",
+         static_cast<unsigned long long>(calls), static_cast<unsigned long long>(*text_only->received),
+         static_cast<unsigned long long>(*trace_only->received));
+  printf("convert text -> fetrace: %.3f s\n", convert_s);
+  printf("%-22s %10s %14s\n", "run", "wall_s", "calls_per_s");
+  printf("%-22s %10.3f %14.0f\n", "inputs_only/iestream", text_only_s, rate(text_only_s));
+  printf("%-22s %10.3f %14.0f\n", "inputs_only/fetrace", trace_only_s, rate(trace_only_s));
+  printf("%-22s %10.3f %14.0f\n", "top_model/iestream", text_full_s, rate(text_full_s));
+  printf("%-22s %10.3f %14.0f\n", "top_model/fetrace", trace_full_s, rate(trace_full_s));
+  printf("speedup: inputs %.1fx, top model %.1fx\n", text_only_s / trace_only_s, text_full_s / trace_full_s);
+  return 0;
+}
@@ -0,0 +1,70 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "bench_models.hpp"
+#include "../atomics/etraffic.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// ETraffic throughput: generated calls per wall-clock second with the
+// generator alone, and driving FreightElevatorTop (LOOK), for each preset.
+
+struct TrafficOnly : public Coupled {
+  shared_ptr<uint64_t> received = make_shared<uint64_t>(0);
+
+  TrafficOnly(const string& id, const fe::TrafficProfile& profile, uint64_t seed) : Coupled(id) {
+    auto traffic = addComponent<ETraffic>("traffic", profile, seed);
+    auto sink = addComponent<BenchSink<fe::Call>>("sink", received);
+    addCoupling(traffic->inside_call, sink->in);
+    addCoupling(traffic->outside_call, sink->in);
+  }
+};
+
+static double run(const shared_ptr<Coupled>& model, double horizon) {
+  auto t0 = chrono::steady_clock::now();
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./traffic_bench [passengers] [seed]
+  double passengers = (argc > 1) ? stod(argv[1]) : 1000000.0;
+  uint64_t seed = (argc > 2) ? stoull(argv[2]) : 1;
+
+  const fe::Floor floors = 20;
+  const double rate = 0.5;  // passengers per minute, about what one car can serve with LOOK
+  const double horizon = passengers / rate;
+
+  const pair<const char*, fe::TrafficProfile> presets[] = {
+      {"up_peak", fe::TrafficProfile::up_peak(floors, rate)},
+      {"down_peak", fe::TrafficProfile::down_peak(floors, rate)},
+      {"inter_floor", fe::TrafficProfile::inter_floor(floors, rate)},
+  };
+
+  fe::ControlConfig config;
+  config.policy = fe::SchedulePolicy::look;
+  config.top_floor = floors;
+
+  printf("%-12s %12s %10s %14s %10s %14s\n", "profile", "calls", "gen_s", "gen_calls/s", "top_s", "top_calls/s");
+  for (const auto& [name, profile] : presets) {
+    auto gen = make_shared<TrafficOnly>("traffic_only", profile, seed);
+    double gen_s = run(gen, horizon);
+    double top_s = run(make_shared<FreightElevatorTrafficExperiment>("traffic_top", profile, seed, config), horizon);
+
+    double calls = static_cast<double>(*gen->received);  // two calls per passenger
+    printf("%-12s %12.0f %10.3f %14.0f %10.3f %14.0f\n", name, calls, gen_s, calls / gen_s, top_s, calls / top_s);
+  }
+  return 0;
+}
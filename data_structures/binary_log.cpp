@@ -0,0 +1,232 @@
+#include "binary_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace fe {
+
+namespace {
+    constexpr char kLogMagic[8] = {'F', 'E', 'L', 'O', 'G', '\0', '\0', '\0'};
+
+    std::size_t round_up_pow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+}
+
+AsyncBinaryLogger::AsyncBinaryLogger(std::string path, std::size_t ring_records)
+    : path(std::move(path)),
+      ring(new LogRecord[round_up_pow2(std::max<std::size_t>(ring_records, 64))]),
+      mask(round_up_pow2(std::max<std::size_t>(ring_records, 64)) - 1) {}
+
+AsyncBinaryLogger::~AsyncBinaryLogger() {
+    if (writer.joinable()) {
+        try {
+            stop();
+        } catch (...) {
+            // destructors must not throw; the file is incomplete anyway
+        }
+    }
+}
+
+void AsyncBinaryLogger::start() {
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("cannot open binary log: " + path);
+    }
+    LogFileHeader header {};
+    std::memcpy(header.magic, kLogMagic, sizeof(kLogMagic));
+    header.version = kLogVersion;
+    header.record_size = sizeof(LogRecord);
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    head.store(0);
+    tail.store(0);
+    model_names.clear();
+    strings.clear();
+    running.store(true, std::memory_order_release);
+    writer = std::thread([this] { write_loop(); });
+}
+
+void AsyncBinaryLogger::stop() {
+    if (!writer.joinable()) {
+        return;
+    }
+    running.store(false, std::memory_order_release);
+    writer.join();
+    const bool failed = std::ferror(file) != 0;
+    std::fclose(file);
+    file = nullptr;
+    if (failed) {
+        throw std::runtime_error("error writing binary log: " + path);
+    }
+}
+
+void AsyncBinaryLogger::write_loop() {
+    const std::size_t capacity = mask + 1;
+    for (;;) {
+        // Read the flag before head: everything published before stop() is flushed
+        const bool stopping = !running.load(std::memory_order_acquire);
+        const std::uint64_t h = head.load(std::memory_order_acquire);
+        std::uint64_t t = tail.load(std::memory_order_relaxed);
+        if (h == t) {
+            if (stopping) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            continue;
+        }
+        while (t != h) {
+            const std::size_t start = static_cast<std::size_t>(t & mask);
+            const std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(h - t, capacity - start));
+            std::fwrite(&ring[start], sizeof(LogRecord), n, file);
+            t += n;
+        }
+        tail.store(t, std::memory_order_release);
+    }
+    std::fflush(file);
+}
+
+LogRecord& AsyncBinaryLogger::claim() {
+    const std::uint64_t h = head.load(std::memory_order_relaxed);
+    while (h - tail.load(std::memory_order_acquire) > mask) {
+        std::this_thread::yield();  // ring full: let the writer catch up
+    }
+    return ring[static_cast<std::size_t>(h & mask)];
+}
+
+void AsyncBinaryLogger::append(LogKind kind, double time, long model_id, std::uint16_t name, std::uint16_t port,
+                               const std::string& text) {
+    const char* data = text.data();
+    std::size_t left = text.size();
+    bool first = true;
+    do {
+        LogRecord& r = claim();
+        const std::size_t n = std::min(left, sizeof(r.payload));
+        r.time = time;
+        r.model_id = static_cast<std::int32_t>(model_id);
+        r.name = name;
+        r.port = port;
+        r.length = static_cast<std::uint16_t>(n);
+        r.kind = first ? kind : LogKind::continuation;
+        r.flags = (left > n) ? kLogMore : 0;
+        std::memcpy(r.payload, data, n);
+        publish();
+
+        data += n;
+        left -= n;
+        first = false;
+    } while (left > 0);
+}
+
+std::uint16_t AsyncBinaryLogger::intern(const std::string& text) {
+    auto it = strings.find(text);
+    if (it != strings.end()) {
+        return it->second;
+    }
+    const auto id = static_cast<std::uint16_t>(strings.size());
+    if (id == kLogNoPort) {
+        throw std::runtime_error("binary log: too many distinct model/port names");
+    }
+    strings.emplace(text, id);
+    append(LogKind::string, 0.0, 0, id, kLogNoPort, text);
+    return id;
+}
+
+std::uint16_t AsyncBinaryLogger::model_name(long model_id, const std::string& name) {
+    const auto i = static_cast<std::size_t>(model_id);
+    if (i >= model_names.size()) {
+        model_names.resize(i + 1, kLogNoPort);
+    }
+    if (model_names[i] == kLogNoPort) {
+        model_names[i] = intern(name);
+    }
+    return model_names[i];
+}
+
+void AsyncBinaryLogger::logOutput(double time, long modelId, const std::string& modelName,
+                                  const std::string& portName, const std::string& output) {
+    const std::uint16_t name = model_name(modelId, modelName);
+    const std::uint16_t port = intern(portName);
+    append(LogKind::output, time, modelId, name, port, output);
+}
+
+void AsyncBinaryLogger::logState(double time, long modelId, const std::string& modelName,
+                                 const std::string& state) {
+    const std::uint16_t name = model_name(modelId, modelName);
+    append(LogKind::state, time, modelId, name, kLogNoPort, state);
+}
+
+std::size_t decode_binary_log(const std::string& path, std::ostream& out, const std::string& sep) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("cannot open binary log: " + path);
+    }
+    LogFileHeader header {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, kLogMagic, sizeof(kLogMagic)) != 0
+        || header.version != kLogVersion
+        || header.record_size != sizeof(LogRecord)) {
+        throw std::runtime_error("not a binary log (or unsupported version): " + path);
+    }
+
+    out << "sim time" << sep << "model id" << sep << "model name" << sep << "port name" << sep << "data" << '\n';
+
+    std::vector<std::string> strings;
+    auto lookup = [&](std::uint16_t id) -> const std::string& {
+        if (id >= strings.size()) {
+            throw std::runtime_error("binary log refers to an undefined name: " + path);
+        }
+        return strings[id];
+    };
+
+    std::size_t lines = 0;
+    std::string text;
+    LogRecord r {};
+    while (file.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+        if (r.kind == LogKind::continuation) {
+            throw std::runtime_error("binary log has a stray continuation record: " + path);
+        }
+        const LogRecord first = r;
+        text.assign(r.payload, r.length);
+        while (r.flags & kLogMore) {
+            if (!file.read(reinterpret_cast<char*>(&r), sizeof(r)) || r.kind != LogKind::continuation) {
+                throw std::runtime_error("binary log is truncated: " + path);
+            }
+            text.append(r.payload, r.length);
+        }
+
+        switch (first.kind) {
+            case LogKind::string:
+                if (first.name != strings.size()) {
+                    throw std::runtime_error("binary log name table is out of order: " + path);
+                }
+                strings.push_back(text);
+                break;
+            case LogKind::state:
+                out << first.time << sep << static_cast<long>(first.model_id) << sep << lookup(first.name)
+                    << sep << sep << text << '\n';
+                ++lines;
+                break;
+            case LogKind::output:
+                out << first.time << sep << static_cast<long>(first.model_id) << sep << lookup(first.name)
+                    << sep << lookup(first.port) << sep << text << '\n';
+                ++lines;
+                break;
+            default:
+                throw std::runtime_error("binary log has an unknown record kind: " + path);
+        }
+    }
+    if (file.gcount() != 0) {
+        throw std::runtime_error("binary log is truncated: " + path);
+    }
+    return lines;
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef FE_BINARY_LOG_HPP
+#define FE_BINARY_LOG_HPP
+
+#include <cadmium/core/logger/logger.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fe {
+    /**
+     * Binary simulation log (.felog), little-endian, native layout:
+     *   LogFileHeader, then fixed-size LogRecords in logging order.
+     * - Model and port names are interned: the first use of a name writes a
+     *   'string' record defining its id, later records only carry the id.
+     * - A payload longer than one record continues in the following
+     *   'continuation' records (flag kLogMore set on every record but the last).
+     */
+    struct LogFileHeader {
+        char magic[8];                 // "FELOG\0\0\0"
+        std::uint32_t version;         // kLogVersion
+        std::uint32_t record_size;     // sizeof(LogRecord)
+    };
+
+    enum class LogKind : std::uint8_t { state = 0, output = 1, string = 2, continuation = 3 };
+
+    struct LogRecord {
+        double time;                   // simulation time (state/output)
+        std::int32_t model_id;         // Cadmium model id (state/output)
+        std::uint16_t name;            // interned model name; string id for 'string' records
+        std::uint16_t port;            // interned port name, kLogNoPort for state records
+        std::uint16_t length;          // payload bytes used in this record
+        LogKind kind;
+        std::uint8_t flags;            // kLogMore
+        char payload[44];
+    };
+
+    static_assert(sizeof(LogFileHeader) == 16, "LogFileHeader layout is part of the file format");
+    static_assert(sizeof(LogRecord) == 64, "LogRecord layout is part of the file format");
+
+    constexpr std::uint32_t kLogVersion = 1;
+    constexpr std::uint16_t kLogNoPort = 0xFFFF;
+    constexpr std::uint8_t kLogMore = 1;
+
+    /**
+     * Drop-in replacement for cadmium::CSVLogger that keeps file I/O off the
+     * simulation thread:
+     * - logState/logOutput copy the (already formatted) text into fixed-size
+     *   records of a single-producer/single-consumer lock-free ring.
+     * - A background thread writes filled spans of the ring straight to disk.
+     * - If the ring is full the simulation waits for the writer; nothing is dropped.
+     * Cadmium serialises logger calls (lock()/unlock()), so there is one producer.
+     * Use decode_binary_log (or tools/log_decode) to get the CSVLogger output back.
+     */
+    class AsyncBinaryLogger : public cadmium::Logger {
+    public:
+        explicit AsyncBinaryLogger(std::string path, std::size_t ring_records = std::size_t(1) << 16);
+        ~AsyncBinaryLogger() override;
+
+        AsyncBinaryLogger(const AsyncBinaryLogger&) = delete;
+        AsyncBinaryLogger& operator=(const AsyncBinaryLogger&) = delete;
+
+        void start() override;
+        void stop() override;
+        void logOutput(double time, long modelId, const std::string& modelName,
+                       const std::string& portName, const std::string& output) override;
+        void logState(double time, long modelId, const std::string& modelName,
+                      const std::string& state) override;
+
+        // Records written so far (including name definitions and continuations)
+        [[nodiscard]] std::uint64_t records() const { return head.load(std::memory_order_relaxed); }
+
+    private:
+        std::string path;
+        std::FILE* file = nullptr;
+
+        std::unique_ptr<LogRecord[]> ring;
+        std::size_t mask;  // capacity - 1 (capacity is a power of two)
+
+        // head: next slot the producer fills; tail: next slot the writer flushes
+        alignas(64) std::atomic<std::uint64_t> head{0};
+        alignas(64) std::atomic<std::uint64_t> tail{0};
+        alignas(64) std::atomic<bool> running{false};
+        std::thread writer;
+
+        // Producer-side name tables
+        std::vector<std::uint16_t> model_names;                 // by model id, kLogNoPort = unknown
+        std::unordered_map<std::string, std::uint16_t> strings;
+
+        std::uint16_t intern(const std::string& text);
+        std::uint16_t model_name(long model_id, const std::string& name);
+        void append(LogKind kind, double time, long model_id, std::uint16_t name, std::uint16_t port,
+                    const std::string& text);
+        LogRecord& claim();
+        void publish() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+        void write_loop();
+    };
+
+    /**
+     * Rebuilds the CSVLogger text of a .felog ('sep'-separated, same header
+     * and number formatting). Returns the number of state/output lines written.
+     * Throws std::runtime_error if the file is not a binary log or is truncated.
+     */
+    std::size_t decode_binary_log(const std::string& path, std::ostream& out, const std::string& sep = ";");
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include "call_trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fe {
+
+namespace {
+    constexpr char kTraceMagic[8] = {'F', 'E', 'T', 'R', 'A', 'C', 'E', '\0'};
+
+    void read_text_calls(const std::string& path, CallSource source, std::vector<TraceRecord>& out) {
+        if (path.empty()) {
+            return;
+        }
+        std::ifstream file(path);
+        if (!file) {
+            throw std::runtime_error("cannot open call file: " + path);
+        }
+        std::string line;
+        while (std::getline(file, line)) {
+            std::istringstream fields(line);
+            double time;
+            Call call;
+            if (fields >> time >> call) {
+                out.push_back(TraceRecord{time, call.floor, source, call.direction, call.priority, 0});
+            }
+        }
+    }
+}
+
+TraceFile::TraceFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open trace: " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(TraceHeader)) {
+        ::close(fd);
+        throw std::runtime_error("not a call trace: " + path);
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        throw std::runtime_error("cannot map trace: " + path);
+    }
+    ::madvise(base, length, MADV_SEQUENTIAL);
+
+    TraceHeader header {};
+    std::memcpy(&header, base, sizeof(header));
+    if (std::memcmp(header.magic, kTraceMagic, sizeof(kTraceMagic)) != 0
+        || (header.version != 1 && header.version != kTraceVersion)
+        || header.record_size != sizeof(TraceRecord)
+        || header.count > (length - sizeof(TraceHeader)) / sizeof(TraceRecord)) {
+        ::munmap(base, length);
+        base = nullptr;
+        throw std::runtime_error("not a call trace (or unsupported version): " + path);
+    }
+    records = reinterpret_cast<const TraceRecord*>(static_cast<const char*>(base) + sizeof(TraceHeader));
+    count = header.count;
+}
+
+TraceFile::~TraceFile() {
+    if (base != nullptr) {
+        ::munmap(base, length);
+    }
+}
+
+std::size_t convert_text_trace(const std::string& inside_calls_file,
+                               const std::string& outside_calls_file,
+                               const std::string& trace_file) {
+    std::vector<TraceRecord> records;
+    read_text_calls(inside_calls_file, CallSource::inside, records);
+    read_text_calls(outside_calls_file, CallSource::outside, records);
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord& a, const TraceRecord& b) {
+        return a.time < b.time || (a.time == b.time && a.source < b.source);
+    });
+
+    TraceHeader header {};
+    std::memcpy(header.magic, kTraceMagic, sizeof(kTraceMagic));
+    header.version = kTraceVersion;
+    header.record_size = sizeof(TraceRecord);
+    header.count = records.size();
+
+    std::ofstream out(trace_file, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("cannot write trace: " + trace_file);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+    if (!out) {
+        throw std::runtime_error("cannot write trace: " + trace_file);
+    }
+    return records.size();
+}
+
+bool floor_range(const TraceFile& trace, Floor& lowest, Floor& highest) {
+    if (trace.size() == 0) {
+        return false;
+    }
+    lowest = std::numeric_limits<Floor>::max();
+    highest = std::numeric_limits<Floor>::min();
+    for (const TraceRecord& record : trace) {
+        lowest = std::min(lowest, static_cast<Floor>(record.floor));
+        highest = std::max(highest, static_cast<Floor>(record.floor));
+    }
+    return true;
+}
+
+bool floor_range(const std::string& inside_calls_file, const std::string& outside_calls_file,
+                 Floor& lowest, Floor& highest) {
+    std::vector<TraceRecord> records;
+    read_text_calls(inside_calls_file, CallSource::inside, records);
+    read_text_calls(outside_calls_file, CallSource::outside, records);
+    if (records.empty()) {
+        return false;
+    }
+    lowest = std::numeric_limits<Floor>::max();
+    highest = std::numeric_limits<Floor>::min();
+    for (const TraceRecord& record : records) {
+        lowest = std::min(lowest, static_cast<Floor>(record.floor));
+        highest = std::max(highest, static_cast<Floor>(record.floor));
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,84 @@
+#ifndef FE_CALL_TRACE_HPP
+#define FE_CALL_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "messages.hpp"
+
+namespace fe {
+    /**
+     * Binary call trace (.fetrace), little-endian, native layout:
+     *   TraceHeader, then 'count' TraceRecords sorted by time.
+     * Records are fixed-size and 8-byte aligned so a mapped file can be
+     * read in place with no parsing and no per-event allocation.
+     */
+    struct TraceHeader {
+        char magic[8];                 // "FETRACE\0"
+        std::uint32_t version;         // kTraceVersion
+        std::uint32_t record_size;     // sizeof(TraceRecord)
+        std::uint64_t count;           // number of records
+    };
+
+    struct TraceRecord {
+        double time;                   // minutes
+        std::int32_t floor;            // fe::Floor
+        CallSource source;             // which ECall input the call enters through
+        Direction direction;           // hall call direction (version 2)
+        std::uint8_t priority;         // (version 2)
+        std::uint8_t reserved;
+    };
+
+    static_assert(sizeof(TraceHeader) == 24, "TraceHeader layout is part of the file format");
+    static_assert(sizeof(TraceRecord) == 16, "TraceRecord layout is part of the file format");
+
+    // Version 1 stored the source as a little-endian uint32, whose upper
+    // bytes are zero: it reads as version 2 with no direction and priority 0.
+    constexpr std::uint32_t kTraceVersion = 2;
+
+    /**
+     * Read-only memory mapping of a .fetrace file.
+     * Throws std::runtime_error if the file cannot be mapped or is not a trace.
+     */
+    class TraceFile {
+    public:
+        explicit TraceFile(const std::string& path);
+        ~TraceFile();
+
+        TraceFile(const TraceFile&) = delete;
+        TraceFile& operator=(const TraceFile&) = delete;
+
+        [[nodiscard]] const TraceRecord* begin() const { return records; }
+        [[nodiscard]] const TraceRecord* end() const { return records + count; }
+        [[nodiscard]] std::size_t size() const { return count; }
+        [[nodiscard]] const TraceRecord& operator[](std::size_t i) const { return records[i]; }
+
+    private:
+        void* base = nullptr;
+        std::size_t length = 0;
+        const TraceRecord* records = nullptr;
+        std::size_t count = 0;
+    };
+
+    /**
+     * Converts the 'time call' text files read by IEStream (see fe::Call's
+     * text form; direction and priority are kept) into one .fetrace.
+     * Either input path may be empty to skip it. Calls are merged by time;
+     * at equal times inside calls come first, then file order is kept.
+     * Returns the number of records written; throws std::runtime_error on I/O errors.
+     */
+    std::size_t convert_text_trace(const std::string& inside_calls_file,
+                                   const std::string& outside_calls_file,
+                                   const std::string& trace_file);
+
+    // Lowest and highest floor called in 'trace'; false (and both left
+    // unchanged) if it holds no call.
+    bool floor_range(const TraceFile& trace, Floor& lowest, Floor& highest);
+    // The same over the 'time call' text files (an empty path is skipped);
+    // throws std::runtime_error if a file cannot be read.
+    bool floor_range(const std::string& inside_calls_file, const std::string& outside_calls_file,
+                     Floor& lowest, Floor& highest);
+}
+
+#endif
@@ -0,0 +1,163 @@
+#include "instrument.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace fe::instrument {
+
+const char* to_string(Hook hook) {
+    switch (hook) {
+        case Hook::external: return "external";
+        case Hook::internal: return "internal";
+        case Hook::confluent: return "confluent";
+        case Hook::output: return "output";
+        case Hook::time_advance: return "timeAdvance";
+    }
+    return "?";
+}
+
+Profiler& Profiler::current() {
+    static thread_local Profiler profiler;
+    return profiler;
+}
+
+std::size_t Profiler::add_model(const std::string& name, const char* kind) {
+    models.push_back(Model{name, kind, {}, 0.0, 0.0, 0});
+    return models.size() - 1;
+}
+
+void Profiler::reset() {
+    for (auto& m : models) {
+        m = Model{m.name, m.kind, {}, 0.0, 0.0, 0};
+    }
+    trace.clear();
+    origin_ns = now_ns();
+    depth = 0;
+    instant = -1.0;
+    chain = 0;
+    chains = Histogram(1.0);
+}
+
+void Profiler::close_chain() {
+    if (chain > 0) {
+        chains.add(static_cast<double>(chain));
+        chain = 0;
+    }
+}
+
+void Profiler::enter(std::size_t model, Hook hook, double elapsed) {
+    if (depth++ > 0 || hook == Hook::output || hook == Hook::time_advance) {
+        return;  // nested call of a confluent transition, or no transition at all
+    }
+    Model& m = models[model];
+    const bool imminent = hook == Hook::internal || hook == Hook::confluent;
+    m.clock += imminent ? m.sigma : elapsed;
+
+    if (m.clock != instant) {
+        close_chain();
+        instant = m.clock;
+    }
+    if (imminent && m.sigma == 0.0) {
+        m.zero_time++;
+        chain++;
+    }
+}
+
+void Profiler::leave(std::size_t model, Hook hook, std::uint64_t begin_ns, std::uint64_t end_ns) {
+    --depth;
+    Model& m = models[model];
+    HookStats& h = m.hooks[static_cast<std::size_t>(hook)];
+    h.calls++;
+    h.ns += end_ns - begin_ns;
+
+    if (trace.size() < trace_limit) {
+        const double sim_time = hook == Hook::output ? m.clock + m.sigma : m.clock;
+        trace.push_back(TraceEvent{static_cast<std::uint32_t>(model), hook, begin_ns, end_ns, sim_time});
+    }
+}
+
+void Profiler::time_advance(std::size_t model, double sigma) {
+    models[model].sigma = sigma;
+}
+
+std::uint64_t Profiler::transitions(const char* kind) const {
+    std::uint64_t n = 0;
+    for (const Model& m : models) {
+        if (kind != nullptr && std::strcmp(m.kind, kind) != 0) {
+            continue;
+        }
+        // a confluent transition runs the probed internal and external ones
+        n += m.hooks[static_cast<std::size_t>(Hook::external)].calls
+             + m.hooks[static_cast<std::size_t>(Hook::internal)].calls
+             - m.hooks[static_cast<std::size_t>(Hook::confluent)].calls;
+    }
+    return n;
+}
+
+void Profiler::write_summary(std::ostream& os) const {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-28s %-12s %12s %12s %10s\n", "model", "function", "calls", "total_ms", "ns_per_call");
+    os << line;
+    std::uint64_t zero_time = 0;
+    for (const Model& m : models) {
+        for (std::size_t k = 0; k < kHooks; ++k) {
+            const HookStats& h = m.hooks[k];
+            if (h.calls == 0) {
+                continue;
+            }
+            std::snprintf(line, sizeof(line), "%-28s %-12s %12llu %12.3f %10.1f\n",
+                          (m.name + " (" + m.kind + ")").c_str(), to_string(static_cast<Hook>(k)),
+                          static_cast<unsigned long long>(h.calls), static_cast<double>(h.ns) / 1e6,
+                          static_cast<double>(h.ns) / static_cast<double>(h.calls));
+            os << line;
+        }
+        zero_time += m.zero_time;
+    }
+
+    os << "zero-time (sigma = 0) events:";
+    for (const Model& m : models) {
+        os << " " << m.name << "=" << m.zero_time;
+    }
+    os << " (total " << zero_time << ")\n";
+
+    Histogram all = chains;
+    if (chain > 0) {
+        all.add(static_cast<double>(chain));
+    }
+    std::snprintf(line, sizeof(line),
+                  "zero-time chains per instant: %llu, length mean %.2f p50 %.0f p99 %.0f max %.0f\n",
+                  static_cast<unsigned long long>(all.count()), all.mean(), all.quantile(0.5),
+                  all.quantile(0.99), all.max());
+    os << line;
+    if (trace.size() == trace_limit) {
+        os << "timeline truncated at " << trace_limit << " events\n";
+    }
+}
+
+void Profiler::write_chrome_trace(const std::string& path) const {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        throw std::runtime_error("cannot write trace: " + path);
+    }
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    // one named track per model
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        std::fprintf(f, "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%zu,\"args\":{\"name\":\"%s (%s)\"}},\n",
+                     i + 1, models[i].name.c_str(), models[i].kind);
+    }
+    for (const TraceEvent& ev : trace) {
+        std::fprintf(f, "{\"ph\":\"X\",\"name\":\"%s\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"sim_t\":%g}},\n",
+                     to_string(ev.hook), ev.model + 1,
+                     static_cast<double>(ev.begin_ns - origin_ns) / 1e3,
+                     static_cast<double>(ev.end_ns - ev.begin_ns) / 1e3, ev.sim_time);
+    }
+    std::fprintf(f, "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"args\":{\"name\":\"freight elevator\"}}\n]}\n");
+    const bool failed = std::ferror(f) != 0;
+    std::fclose(f);
+    if (failed) {
+        throw std::runtime_error("error writing trace: " + path);
+    }
+}
+
+}
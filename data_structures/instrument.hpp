@@ -0,0 +1,134 @@
+#ifndef FE_INSTRUMENT_HPP
+#define FE_INSTRUMENT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "kpi.hpp"
+
+namespace fe::instrument {
+    // The DEVS functions of an atomic that can be probed.
+    enum class Hook : std::uint8_t { external, internal, confluent, output, time_advance };
+    constexpr std::size_t kHooks = 5;
+
+    const char* to_string(Hook hook);
+
+    /**
+     * Hot-path profiler for atomic models (one per thread, see current()).
+     * - Counts calls and wall time of every probed function of every model.
+     * - Follows each model's simulated clock from the elapsed times it
+     *   receives and the time advances it returns, so it can tell which
+     *   internal events happen after sigma = 0 and group the zero-time
+     *   events that chain at the same simulated instant.
+     * - Keeps a bounded timeline of the probed calls for write_chrome_trace.
+     * The probes are macros (FE_PROBE_*) that compile to nothing unless
+     * FE_INSTRUMENT is defined, so uninstrumented builds pay nothing.
+     */
+    class Profiler {
+    public:
+        // Profiler of the calling thread; models register with it when built
+        static Profiler& current();
+
+        std::size_t add_model(const std::string& name, const char* kind);
+
+        // Timeline entries kept for the Chrome trace (the counters are always complete)
+        void set_trace_limit(std::size_t events) { trace_limit = events; }
+        void reset();
+
+        // Called by the probes
+        void enter(std::size_t model, Hook hook, double elapsed);
+        void leave(std::size_t model, Hook hook, std::uint64_t begin_ns, std::uint64_t end_ns);
+        void time_advance(std::size_t model, double sigma);
+
+        // State transitions the simulator ran (external, internal and
+        // confluent, each confluent counted once) of the models of 'kind'
+        // ("EControl", ...), or of every model
+        [[nodiscard]] std::uint64_t transitions(const char* kind = nullptr) const;
+
+        // Per model and hook: calls and time; zero-time events; chain lengths
+        void write_summary(std::ostream& os) const;
+
+        // Chrome trace / Perfetto JSON: one track per model, wall-clock timeline
+        void write_chrome_trace(const std::string& path) const;
+
+        [[nodiscard]] static std::uint64_t now_ns() {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+    private:
+        struct HookStats {
+            std::uint64_t calls = 0;
+            std::uint64_t ns = 0;
+        };
+        struct Model {
+            std::string name;
+            const char* kind;
+            HookStats hooks[kHooks];
+            double clock = 0.0;      // simulated time of the last transition
+            double sigma = 0.0;      // last time advance returned
+            std::uint64_t zero_time = 0;  // internal/confluent events after sigma = 0
+        };
+        struct TraceEvent {
+            std::uint32_t model;
+            Hook hook;
+            std::uint64_t begin_ns;
+            std::uint64_t end_ns;
+            double sim_time;
+        };
+
+        std::vector<Model> models;
+        std::vector<TraceEvent> trace;
+        std::size_t trace_limit = 1000000;
+        std::uint64_t origin_ns = now_ns();
+        std::size_t depth = 0;    // nested probes (confluent calls internal + external)
+
+        // Zero-time chains: sigma-0 events at the same simulated instant
+        double instant = -1.0;
+        std::uint64_t chain = 0;
+        Histogram chains{1.0};
+
+        void close_chain();
+    };
+
+    // Times one probed call (RAII)
+    class Scope {
+    public:
+        Scope(std::size_t model, Hook hook, double elapsed = 0.0)
+            : model(model), hook(hook), begin(Profiler::now_ns()) {
+            Profiler::current().enter(model, hook, elapsed);
+        }
+        ~Scope() { Profiler::current().leave(model, hook, begin, Profiler::now_ns()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        std::size_t model;
+        Hook hook;
+        std::uint64_t begin;
+    };
+}
+
+#ifdef FE_INSTRUMENT
+// Declares the probe id of an atomic (in its class body) and registers it (in its constructor)
+#define FE_PROBE_MEMBER std::size_t probe_id = 0
+#define FE_PROBE_REGISTER(id, kind) (probe_id = ::fe::instrument::Profiler::current().add_model((id), (kind)))
+// Times the enclosing DEVS function
+#define FE_PROBE(hook) ::fe::instrument::Scope fe_probe_scope(probe_id, ::fe::instrument::Hook::hook)
+#define FE_PROBE_ELAPSED(hook, e) ::fe::instrument::Scope fe_probe_scope(probe_id, ::fe::instrument::Hook::hook, (e))
+// Reports the value timeAdvance returns
+#define FE_PROBE_SIGMA(sigma) ::fe::instrument::Profiler::current().time_advance(probe_id, (sigma))
+#else
+#define FE_PROBE_MEMBER static_assert(true, "")
+#define FE_PROBE_REGISTER(id, kind) ((void)0)
+#define FE_PROBE(hook) ((void)0)
+#define FE_PROBE_ELAPSED(hook, e) ((void)0)
+#define FE_PROBE_SIGMA(sigma) ((void)0)
+#endif
+
+#endif
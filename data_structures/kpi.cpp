@@ -0,0 +1,110 @@
+#include "kpi.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace fe {
+
+std::size_t Histogram::index(std::uint64_t ticks) {
+    if (ticks < (std::uint64_t(1) << kSubBits)) {
+        return static_cast<std::size_t>(ticks);
+    }
+    if (ticks >= (std::uint64_t(1) << kMaxBits)) {
+        return kBuckets - 1;
+    }
+    const auto msb = static_cast<unsigned>(63 - __builtin_clzll(ticks));
+    const unsigned shift = msb - kSubBits;
+    return (static_cast<std::size_t>(shift + 1) << kSubBits)
+           + static_cast<std::size_t>(ticks >> shift) - (std::size_t(1) << kSubBits);
+}
+
+std::uint64_t Histogram::lower_ticks(std::size_t index) {
+    if (index < (std::size_t(1) << kSubBits)) {
+        return index;
+    }
+    const unsigned shift = static_cast<unsigned>(index >> kSubBits) - 1;
+    const std::uint64_t sub = (index & ((std::size_t(1) << kSubBits) - 1)) + (std::uint64_t(1) << kSubBits);
+    return sub << shift;
+}
+
+void Histogram::add(double value) {
+    const double ticks = std::max(0.0, value / unit + 0.5);
+    const double cap = static_cast<double>(std::uint64_t(1) << kMaxBits);
+    counts[index(ticks >= cap ? (std::uint64_t(1) << kMaxBits) : static_cast<std::uint64_t>(ticks))]++;
+
+    lo = n ? std::min(lo, value) : value;
+    hi = n ? std::max(hi, value) : value;
+    sum += value;
+    ++n;
+}
+
+void Histogram::merge(const Histogram& other) {
+    if (other.n == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        counts[i] += other.counts[i];
+    }
+    lo = n ? std::min(lo, other.lo) : other.lo;
+    hi = n ? std::max(hi, other.hi) : other.hi;
+    sum += other.sum;
+    n += other.n;
+}
+
+double Histogram::quantile(double q) const {
+    if (n == 0) {
+        return 0.0;
+    }
+    const double wanted = std::clamp(q, 0.0, 1.0) * static_cast<double>(n);
+    const auto target = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(wanted)));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < kBuckets; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            // middle of the bucket: at most half a bucket (~0.8%) off
+            const double mid = 0.5 * static_cast<double>(lower_ticks(i) + lower_ticks(i + 1) - 1);
+            return std::clamp(mid * unit, lo, hi);
+        }
+    }
+    return hi;
+}
+
+namespace {
+    void write_scope(std::ostream& os, const char* label, const FloorKpi& k) {
+        char line[256];
+        const Histogram& w = k.wait;
+        const Histogram& t = k.trip;
+        std::snprintf(line, sizeof(line),
+                      "%-9s %8llu %7.2f %7.2f %7.2f %7.2f %7.2f | %8llu %7.2f %7.2f %7.2f %7.2f %7.2f | %5.0f %5.0f\n",
+                      label,
+                      static_cast<unsigned long long>(w.count()), w.mean(),
+                      w.quantile(0.5), w.quantile(0.9), w.quantile(0.99), w.max(),
+                      static_cast<unsigned long long>(t.count()), t.mean(),
+                      t.quantile(0.5), t.quantile(0.9), t.quantile(0.99), t.max(),
+                      k.queue.quantile(0.99), k.queue.max());
+        os << line;
+    }
+}
+
+void write_summary(std::ostream& os, const RunKpi& kpi) {
+    os << "calls " << kpi.calls << ", served " << kpi.served << ", rejected " << kpi.rejected << ", open "
+       << (kpi.calls - kpi.served - kpi.rejected)
+       << ", last event at " << kpi.last_time << " min\n";
+    char header[256];
+    std::snprintf(header, sizeof(header),
+                  "%-9s %8s %7s %7s %7s %7s %7s | %8s %7s %7s %7s %7s %7s | %5s %5s\n",
+                  "scope", "waits", "mean", "p50", "p90", "p99", "max",
+                  "trips", "mean", "p50", "p90", "p99", "max", "q_p99", "q_max");
+    os << header;
+    write_scope(os, "all", kpi.overall);
+    for (std::size_t i = 0; i < kpi.floors.size(); ++i) {
+        const FloorKpi& k = kpi.floors[i];
+        if (k.wait.count() || k.trip.count() || k.queue.count()) {
+            char label[32];
+            std::snprintf(label, sizeof(label), "floor %ld", static_cast<long>(kpi.first_floor) + static_cast<long>(i));
+            write_scope(os, label, k);
+        }
+    }
+}
+
+}
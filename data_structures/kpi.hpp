@@ -0,0 +1,134 @@
+#ifndef FE_KPI_HPP
+#define FE_KPI_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "messages.hpp"
+
+namespace fe {
+    // Streaming mean/variance (Welford), mergeable across runs.
+    struct RunningStats {
+        std::uint64_t n = 0;
+        double mean = 0.0;
+        double m2 = 0.0;
+
+        void add(double x) {
+            ++n;
+            const double d = x - mean;
+            mean += d / static_cast<double>(n);
+            m2 += d * (x - mean);
+        }
+
+        void merge(const RunningStats& o) {
+            if (o.n == 0) {
+                return;
+            }
+            const double total = static_cast<double>(n + o.n);
+            const double d = o.mean - mean;
+            mean += d * static_cast<double>(o.n) / total;
+            m2 += o.m2 + d * d * static_cast<double>(n) * static_cast<double>(o.n) / total;
+            n += o.n;
+        }
+
+        [[nodiscard]] double variance() const { return n > 1 ? m2 / static_cast<double>(n - 1) : 0.0; }
+        [[nodiscard]] double stddev() const { return std::sqrt(variance()); }
+    };
+
+    /**
+     * Constant-memory streaming histogram with bounded relative error
+     * (HDR-style log-linear buckets).
+     * - Values are counted in integer ticks of 'unit' (e.g. 0.001 minute).
+     * - Below 2^kSubBits ticks every tick has its own bucket; above that,
+     *   every power of two is split into 2^kSubBits buckets, so a bucket is
+     *   at most 1/64 of its value wide (quantiles are within ~0.8%).
+     * - Values above 2^kMaxBits ticks land in the last bucket.
+     * Exact count, mean, min and max are tracked alongside.
+     */
+    class Histogram {
+    public:
+        static constexpr unsigned kSubBits = 6;
+        static constexpr unsigned kMaxBits = 32;
+        static constexpr std::size_t kBuckets = (kMaxBits - kSubBits + 1) << kSubBits;
+
+        explicit Histogram(double unit = 1e-3) : unit(unit), counts(kBuckets, 0) {}
+
+        void add(double value);
+        void merge(const Histogram& other);  // 'other' must use the same unit
+
+        [[nodiscard]] std::uint64_t count() const { return n; }
+        [[nodiscard]] double mean() const { return n ? sum / static_cast<double>(n) : 0.0; }
+        [[nodiscard]] double min() const { return n ? lo : 0.0; }
+        [[nodiscard]] double max() const { return n ? hi : 0.0; }
+
+        // Middle of the bucket holding the q-quantile, clamped to [min, max]
+        [[nodiscard]] double quantile(double q) const;
+
+    private:
+        double unit;
+        std::vector<std::uint64_t> counts;
+        std::uint64_t n = 0;
+        double sum = 0.0;
+        double lo = 0.0;
+        double hi = 0.0;
+
+        static std::size_t index(std::uint64_t ticks);
+        static std::uint64_t lower_ticks(std::size_t index);  // smallest tick count in the bucket
+    };
+
+    /**
+     * Entry of 'slots' for floor 'f', where slots[0] is floor 'first'. The
+     * vector grows on demand in both directions, so it only spans the floors
+     * seen (a tower at floors 500-520 holds 21 entries) and floors below 0
+     * keep entries of their own.
+     */
+    template <typename T>
+    T& floor_slot(std::vector<T>& slots, Floor& first, Floor f) {
+        if (slots.empty()) {
+            first = f;
+        } else if (f < first) {
+            slots.insert(slots.begin(), static_cast<std::size_t>(first - f), T{});
+            first = f;
+        }
+        const auto i = static_cast<std::size_t>(f - first);
+        if (i >= slots.size()) {
+            slots.resize(i + 1);
+        }
+        return slots[i];
+    }
+
+    // Histograms of one floor (or of the whole building).
+    struct FloorKpi {
+        Histogram wait{1e-3};   // minutes, outside call -> car reaches the origin floor
+        Histogram trip{1e-3};   // minutes, inside call -> car reaches the destination floor
+        Histogram queue{1.0};   // calls already waiting at the floor when a call arrives
+    };
+
+    // Key performance indicators of one simulation run, filled by EMonitor.
+    struct RunKpi {
+        std::uint64_t calls = 0;     // outside + inside calls seen
+        std::uint64_t served = 0;    // calls reported on the served port
+        std::uint64_t rejected = 0;  // calls reported on the rejected port (refused when full)
+        RunningStats wait;           // outside call -> car reaches the origin floor
+        RunningStats trip;           // inside call -> car reaches the destination floor
+        double last_time = 0.0;      // time of the last observed event
+
+        FloorKpi overall;            // queue: calls open in the whole building
+        std::vector<FloorKpi> floors;  // floors[i] is floor first_floor + i, grown on demand
+        Floor first_floor = 0;
+
+        FloorKpi& floor(Floor f) { return floor_slot(floors, first_floor, f); }
+    };
+
+    /**
+     * Compact end-of-run summary: totals, then one line per scope (all
+     * floors, then every floor with samples) with count, mean, p50, p90,
+     * p99 and max of wait and trip time and p99/max of the queue depth.
+     */
+    void write_summary(std::ostream& os, const RunKpi& kpi);
+}
+
+#endif
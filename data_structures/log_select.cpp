@@ -0,0 +1,81 @@
+#include "log_select.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace fe {
+
+namespace {
+    std::vector<std::string> split_list(const std::string& list) {
+        std::vector<std::string> names;
+        std::size_t begin = 0;
+        while (begin <= list.size()) {
+            const std::size_t end = std::min(list.find(',', begin), list.size());
+            if (end > begin) {
+                names.push_back(list.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        return names;
+    }
+}
+
+LogSelection parse_log_selection(const std::string& text) {
+    LogSelection selection;
+    const std::size_t eq = text.find('=');
+    const std::string mode = text.substr(0, eq);
+    if (mode == "all" && eq == std::string::npos) {
+        selection.mode = LogSelection::Mode::all;
+    } else if (mode == "none" && eq == std::string::npos) {
+        selection.mode = LogSelection::Mode::none;
+    } else if (mode == "ports" || mode == "models") {
+        selection.mode = mode == "ports" ? LogSelection::Mode::ports : LogSelection::Mode::models;
+        selection.names = split_list(eq == std::string::npos ? std::string() : text.substr(eq + 1));
+        if (selection.names.empty()) {
+            throw std::invalid_argument("--log " + mode + " needs a list: " + mode + "=NAME[,NAME...]");
+        }
+    } else {
+        throw std::invalid_argument("unknown log selection: " + text
+                                    + " (expected all, none, ports=P[,P...] or models=M[,M...])");
+    }
+    return selection;
+}
+
+FilteredLogger::FilteredLogger(std::shared_ptr<cadmium::Logger> inner, std::vector<std::string> models)
+    : inner(std::move(inner)), models(std::move(models)) {}
+
+bool FilteredLogger::selected(long model_id, const std::string& name) {
+    if (model_id < 0) {
+        return std::find(models.begin(), models.end(), name) != models.end();
+    }
+    const auto i = static_cast<std::size_t>(model_id);
+    if (i >= selected_by_id.size()) {
+        selected_by_id.resize(i + 1, -1);
+    }
+    if (selected_by_id[i] < 0) {
+        selected_by_id[i] = std::find(models.begin(), models.end(), name) != models.end() ? 1 : 0;
+    }
+    return selected_by_id[i] == 1;
+}
+
+void FilteredLogger::logOutput(double time, long modelId, const std::string& modelName,
+                               const std::string& portName, const std::string& output) {
+    if (!selected(modelId, modelName)) {
+        ++skipped;
+        return;
+    }
+    ++forwarded;
+    inner->logOutput(time, modelId, modelName, portName, output);
+}
+
+void FilteredLogger::logState(double time, long modelId, const std::string& modelName, const std::string& state) {
+    if (!selected(modelId, modelName)) {
+        ++skipped;
+        return;
+    }
+    ++forwarded;
+    inner->logState(time, modelId, modelName, state);
+}
+
+}
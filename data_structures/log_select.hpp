@@ -0,0 +1,64 @@
+#ifndef FE_LOG_SELECT_HPP
+#define FE_LOG_SELECT_HPP
+
+#include <cadmium/core/logger/logger.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fe {
+    /**
+     * What a run logs (freight_elevator_top --log):
+     *  - all:    every state and output, through the coordinator's logger
+     *  - none:   nothing (no logger at all)
+     *  - ports:  only the messages of the listed experiment output ports
+     *            (floor_out, served_out), written by EPortLog sinks; no
+     *            coordinator logger, so no other model is formatted
+     *  - models: states and outputs of the listed models only (Cadmium ids
+     *            such as Econtrol or Evehicle), through FilteredLogger
+     */
+    struct LogSelection {
+        enum class Mode { all, none, ports, models };
+        Mode mode = Mode::all;
+        std::vector<std::string> names;  // ports or models
+    };
+
+    // Parses "all", "none", "ports=P[,P...]" or "models=M[,M...]"; throws
+    // std::invalid_argument otherwise (or if the list is empty).
+    LogSelection parse_log_selection(const std::string& text);
+
+    /**
+     * Forwards to 'inner' the states and outputs of the models whose name is
+     * in 'models', and drops the rest. The decision is taken once per model
+     * id, so a dropped record costs one indexed load. Cadmium formats every
+     * record before calling any logger: that cost remains (use
+     * LogSelection::Mode::ports to avoid it for a port-only log).
+     */
+    class FilteredLogger : public cadmium::Logger {
+    public:
+        FilteredLogger(std::shared_ptr<cadmium::Logger> inner, std::vector<std::string> models);
+
+        void start() override { inner->start(); }
+        void stop() override { inner->stop(); }
+        void logOutput(double time, long modelId, const std::string& modelName,
+                       const std::string& portName, const std::string& output) override;
+        void logState(double time, long modelId, const std::string& modelName,
+                      const std::string& state) override;
+
+        // Records forwarded and dropped so far
+        [[nodiscard]] std::uint64_t kept() const { return forwarded; }
+        [[nodiscard]] std::uint64_t dropped() const { return skipped; }
+
+    private:
+        std::shared_ptr<cadmium::Logger> inner;
+        std::vector<std::string> models;
+        std::vector<std::int8_t> selected_by_id;  // -1 undecided, 0 dropped, 1 kept
+        std::uint64_t forwarded = 0;
+        std::uint64_t skipped = 0;
+
+        bool selected(long model_id, const std::string& name);
+    };
+}
+
+#endif
@@ -0,0 +1,505 @@
+#include "log_stats.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace fe {
+
+// -------------------- MappedFile --------------------
+
+MappedFile::MappedFile(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat " + path);
+    }
+    length = static_cast<std::size_t>(st.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return;
+    }
+    base = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+        throw std::runtime_error("cannot map " + path);
+    }
+    ::madvise(base, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const char*>(base);
+}
+
+MappedFile::~MappedFile() {
+    if (base != nullptr) {
+        ::munmap(base, length);
+    }
+}
+
+// -------------------- Chunk parsing --------------------
+
+namespace {
+    enum class Kind : std::uint8_t { unknown, vehicle, controller, call };
+
+    // Value of a model between two of its states: vehicle a = moving;
+    // controller a = pending stops, b = calls held
+    struct Sample {
+        std::uint64_t a = 0;
+        std::uint64_t b = 0;
+    };
+
+    // Per-bucket integrals of the controllers' queues
+    struct Series {
+        double width = 60.0;
+        std::vector<double> stops;
+        std::vector<double> calls;
+        std::vector<std::uint64_t> peak;
+
+        void grow(std::size_t i) {
+            if (i >= stops.size()) {
+                stops.resize(i + 1, 0.0);
+                calls.resize(i + 1, 0.0);
+                peak.resize(i + 1, 0);
+            }
+        }
+
+        void merge(const Series& o) {
+            if (!o.stops.empty()) {
+                grow(o.stops.size() - 1);
+            }
+            for (std::size_t i = 0; i < o.stops.size(); ++i) {
+                stops[i] += o.stops[i];
+                calls[i] += o.calls[i];
+                peak[i] = std::max(peak[i], o.peak[i]);
+            }
+        }
+    };
+
+    // What one model did within one chunk (or, merged, within the log)
+    struct ModelPart {
+        Kind kind = Kind::unknown;
+        std::string name;
+        bool seen = false;           // a state was seen
+        double first_time = 0.0;
+        double last_time = 0.0;
+        Sample first;
+        Sample last;
+        double busy = 0.0;           // vehicle: moving minutes
+        std::uint64_t timem = 0;     // outputs per port
+        std::uint64_t floor = 0;
+        std::uint64_t out = 0;
+        std::uint64_t served = 0;
+        std::uint64_t calls = 0;     // ECall: calls stamped so far
+        std::uint64_t peak_calls = 0;
+    };
+
+    // The model holds 'v' over [t0, t1)
+    void account(ModelPart& m, double t0, double t1, const Sample& v, Series& series) {
+        if (!(t1 > t0)) {
+            return;
+        }
+        if (m.kind == Kind::vehicle) {
+            m.busy += v.a ? t1 - t0 : 0.0;
+        } else if (m.kind == Kind::controller) {
+            auto i = static_cast<std::size_t>(t0 / series.width);
+            while (t0 < t1) {
+                series.grow(i);
+                const double t = std::min(t1, static_cast<double>(i + 1) * series.width);
+                series.stops[i] += static_cast<double>(v.a) * (t - t0);
+                series.calls[i] += static_cast<double>(v.b) * (t - t0);
+                series.peak[i] = std::max(series.peak[i], v.b);
+                t0 = t;
+                ++i;
+            }
+        }
+    }
+
+    struct ChunkResult {
+        std::uint64_t lines = 0;
+        std::uint64_t states = 0;
+        std::uint64_t outputs = 0;
+        std::uint64_t skipped = 0;
+        double end_time = 0.0;
+        std::vector<ModelPart> models;  // by model id
+        Series series;
+        RunKpi service;
+    };
+
+    template <typename T>
+    bool parse_number(std::string_view text, T& value) {
+        return std::from_chars(text.data(), text.data() + text.size(), value).ec == std::errc();
+    }
+
+    // The unsigned number after 'key' in 'text', searched from 'from' on (0
+    // if missing); 'from' moves past the key, so fields in the order of the
+    // state's operator<< are found in one pass.
+    std::uint64_t field_after(std::string_view text, std::string_view key, std::size_t& from) {
+        const std::size_t at = text.find(key, from);
+        std::uint64_t value = 0;
+        if (at != std::string_view::npos) {
+            from = at + key.size();
+            std::from_chars(text.data() + from, text.data() + text.size(), value);
+        }
+        return value;
+    }
+
+    class ChunkParser {
+    public:
+        explicit ChunkParser(ChunkResult& result) : r(result) {}
+
+        void line(const std::string_view* f) {
+            ++r.lines;
+            long id = 0;
+            if (f[0] != time_text) {
+                // consecutive lines mostly share their time: parse it once
+                if (!parse_number(f[0], line_time)) {
+                    time_text = std::string_view();
+                    ++r.skipped;  // header or a truncated line
+                    return;
+                }
+                time_text = f[0];
+                r.end_time = std::max(r.end_time, line_time);
+            }
+            if (!parse_number(f[1], id)) {
+                ++r.skipped;
+                return;
+            }
+            ModelPart* m = nullptr;
+            if (id >= 0) {
+                const auto i = static_cast<std::size_t>(id);
+                if (i >= r.models.size()) {
+                    r.models.resize(i + 1);
+                }
+                m = &r.models[i];
+                if (m->name.empty()) {
+                    m->name = std::string(f[2]);
+                }
+            }
+            if (f[3].empty()) {
+                ++r.states;
+                if (m != nullptr) {
+                    state(*m, line_time, f[4]);
+                }
+            } else {
+                ++r.outputs;
+                output(m, line_time, f[3], f[4]);
+            }
+        }
+
+    private:
+        ChunkResult& r;
+        std::string_view time_text;  // text of line_time, in the mapped file
+        double line_time = 0.0;
+
+        void state(ModelPart& m, double time, std::string_view data) {
+            Sample v;
+            if (data.compare(0, 5, "{cur:") == 0) {
+                m.kind = Kind::controller;
+                std::size_t from = 5;
+                v.a = field_after(data, ",q:", from);
+                v.b = field_after(data, ",held:", from);
+                m.peak_calls = std::max(m.peak_calls, v.b);
+            } else if (data.compare(0, 7, "{phase:") == 0 && data.find(",t:") != std::string_view::npos) {
+                m.kind = Kind::vehicle;
+                v.a = data.compare(7, 6, "moving") == 0 ? 1 : 0;
+            } else if (data.compare(0, 7, "{phase:") == 0 && data.find(",pending:") != std::string_view::npos) {
+                m.kind = Kind::call;
+                std::size_t from = 7;
+                m.calls = std::max(m.calls, field_after(data, ",calls:", from));
+                return;
+            } else {
+                return;
+            }
+            if (m.seen) {
+                account(m, m.last_time, time, m.last, r.series);
+            } else {
+                m.seen = true;
+                m.first_time = time;
+                m.first = v;
+            }
+            m.last_time = time;
+            m.last = v;
+        }
+
+        void output(ModelPart* m, double time, std::string_view port, std::string_view data) {
+            if (port == "served" || port == "served_out") {
+                served(time, data);
+                if (m != nullptr) {
+                    ++m->served;
+                }
+            } else if (m == nullptr) {
+                return;
+            } else if (port == "timem") {
+                ++m->timem;
+            } else if (port == "floor") {
+                ++m->floor;
+            } else if (port == "out") {
+                ++m->out;
+            }
+        }
+
+        // fe::Call text: "<floor> <in|out> [up|down] [p<n>] [#<id> @<issued>]"
+        void served(double time, std::string_view data) {
+            Floor floor = 0;
+            const auto parsed = std::from_chars(data.data(), data.data() + data.size(), floor);
+            const std::size_t at = data.find(" @");
+            if (parsed.ec != std::errc() || at == std::string_view::npos) {
+                return;
+            }
+            double issued = 0.0;
+            parse_number(data.substr(at + 2), issued);
+            const bool outside = data.compare(static_cast<std::size_t>(parsed.ptr - data.data()), 4, " out") == 0;
+            const double latency = time - issued;
+            ++r.service.served;
+            FloorKpi& k = r.service.floor(floor);
+            (outside ? k.wait : k.trip).add(latency);
+            (outside ? r.service.overall.wait : r.service.overall.trip).add(latency);
+        }
+    };
+
+    // Splits every line of [p, end) into 5 fields at the first 4 ';' (the
+    // last field, the data, keeps any further ';') and hands it to 'parser'.
+    // Separators are found 16 bytes at a time with SSE2 where available.
+    void scan_lines(const char* p, const char* end, ChunkParser& parser) {
+        std::string_view fields[5];
+        std::size_t field = 0;
+        const char* start = p;
+
+        auto separator = [&](const char* at) {
+            if (*at == '\n') {
+                fields[field] = std::string_view(start, static_cast<std::size_t>(at - start));
+                for (std::size_t i = field + 1; i < 5; ++i) {
+                    fields[i] = std::string_view();
+                }
+                parser.line(fields);
+                field = 0;
+                start = at + 1;
+            } else if (field < 4) {
+                fields[field++] = std::string_view(start, static_cast<std::size_t>(at - start));
+                start = at + 1;
+            }
+        };
+
+#if defined(__SSE2__)
+        const __m128i semicolon = _mm_set1_epi8(';');
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; p + 16 <= end; p += 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(block, semicolon), _mm_cmpeq_epi8(block, newline))));
+            while (mask != 0) {
+                separator(p + __builtin_ctz(mask));
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; p < end; ++p) {
+            if (*p == ';' || *p == '\n') {
+                separator(p);
+            }
+        }
+        if (start < end) {
+            // last line without a newline
+            fields[field] = std::string_view(start, static_cast<std::size_t>(end - start));
+            for (std::size_t i = field + 1; i < 5; ++i) {
+                fields[i] = std::string_view();
+            }
+            parser.line(fields);
+        }
+    }
+
+    void merge_floor(FloorKpi& into, const FloorKpi& from) {
+        into.wait.merge(from.wait);
+        into.trip.merge(from.trip);
+        into.queue.merge(from.queue);
+    }
+
+    // Appends chunk 'part' (the next one in file order) to 'acc'
+    void merge_model(ModelPart& acc, const ModelPart& part, Series& series) {
+        if (acc.name.empty()) {
+            acc.name = part.name;
+        }
+        if (part.kind != Kind::unknown) {
+            acc.kind = part.kind;
+        }
+        if (part.seen) {
+            if (acc.seen) {
+                account(acc, acc.last_time, part.first_time, acc.last, series);
+            } else {
+                acc.seen = true;
+                acc.first_time = part.first_time;
+                acc.first = part.first;
+            }
+            acc.last_time = part.last_time;
+            acc.last = part.last;
+        }
+        acc.busy += part.busy;
+        acc.timem += part.timem;
+        acc.floor += part.floor;
+        acc.out += part.out;
+        acc.served += part.served;
+        acc.calls = std::max(acc.calls, part.calls);
+        acc.peak_calls = std::max(acc.peak_calls, part.peak_calls);
+    }
+}
+
+// -------------------- analyze_log --------------------
+
+LogStats analyze_log(const std::string& path, const LogStatsOptions& options) {
+    MappedFile file(path);
+    const char* begin = file.data();
+    const char* end = begin + file.size();
+
+    // Skip the CSVLogger header
+    if (file.size() > 0 && std::strncmp(begin, "sim time", std::min<std::size_t>(8, file.size())) == 0) {
+        const void* nl = std::memchr(begin, '\n', file.size());
+        begin = nl ? static_cast<const char*>(nl) + 1 : end;
+    }
+
+    unsigned threads = options.threads ? options.threads : std::max(1U, std::thread::hardware_concurrency());
+    const auto body = static_cast<std::size_t>(end - begin);
+    threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, body / 4096 + 1)));
+
+    // Chunk boundaries, each moved forward to the start of a line
+    std::vector<const char*> cuts {begin};
+    for (unsigned t = 1; t < threads; ++t) {
+        const char* cut = std::max(begin + body / threads * t, cuts.back());
+        const void* nl = std::memchr(cut, '\n', static_cast<std::size_t>(end - cut));
+        cuts.push_back(nl ? static_cast<const char*>(nl) + 1 : end);
+    }
+    cuts.push_back(end);
+
+    std::vector<ChunkResult> chunks(threads);
+    auto parse = [&](unsigned t) {
+        chunks[t].series.width = options.bucket;
+        ChunkParser parser(chunks[t]);
+        scan_lines(cuts[t], cuts[t + 1], parser);
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back(parse, t);
+    }
+    parse(0);
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // Merge in file order
+    LogStats stats;
+    stats.bytes = file.size();
+    stats.bucket = options.bucket;
+    Series series;
+    series.width = options.bucket;
+    std::vector<ModelPart> models;
+    for (const ChunkResult& c : chunks) {
+        stats.lines += c.lines;
+        stats.states += c.states;
+        stats.outputs += c.outputs;
+        stats.skipped += c.skipped;
+        stats.end_time = std::max(stats.end_time, c.end_time);
+        if (c.models.size() > models.size()) {
+            models.resize(c.models.size());
+        }
+        for (std::size_t i = 0; i < c.models.size(); ++i) {
+            merge_model(models[i], c.models[i], series);
+        }
+        series.merge(c.series);
+        stats.service.served += c.service.served;
+        merge_floor(stats.service.overall, c.service.overall);
+        for (std::size_t i = 0; i < c.service.floors.size(); ++i) {
+            merge_floor(stats.service.floor(c.service.first_floor + static_cast<Floor>(i)), c.service.floors[i]);
+        }
+    }
+
+    // Every model holds its last state to the end of the log
+    for (std::size_t i = 0; i < models.size(); ++i) {
+        ModelPart& m = models[i];
+        if (m.seen) {
+            account(m, m.last_time, stats.end_time, m.last, series);
+        }
+        if (m.kind == Kind::vehicle) {
+            stats.vehicles.push_back(VehicleStats{static_cast<long>(i), m.name, m.out, m.busy});
+        } else if (m.kind == Kind::controller || m.timem > 0) {
+            stats.controllers.push_back(
+                ControllerStats{static_cast<long>(i), m.name, m.timem, m.floor, m.served, m.peak_calls});
+        } else if (m.kind == Kind::call) {
+            stats.service.calls += m.calls;
+        }
+    }
+    stats.service.last_time = stats.end_time;
+
+    const auto points = static_cast<std::size_t>(std::ceil(stats.end_time / options.bucket));
+    series.grow(points > 0 ? points - 1 : 0);
+    for (std::size_t i = 0; i < points; ++i) {
+        QueuePoint q;
+        q.start = static_cast<double>(i) * options.bucket;
+        const double width = std::min(options.bucket, stats.end_time - q.start);
+        q.stops = width > 0 ? series.stops[i] / width : 0.0;
+        q.calls = width > 0 ? series.calls[i] / width : 0.0;
+        q.peak = series.peak[i];
+        stats.queue.push_back(q);
+    }
+    return stats;
+}
+
+// -------------------- Reports --------------------
+
+void write_log_stats(std::ostream& os, const LogStats& stats) {
+    char line[256];
+    std::snprintf(line, sizeof(line), "log: %.1f MB, %llu lines (%llu states, %llu outputs, %llu skipped), "
+                  "end at %g min\n", static_cast<double>(stats.bytes) / 1e6,
+                  static_cast<unsigned long long>(stats.lines), static_cast<unsigned long long>(stats.states),
+                  static_cast<unsigned long long>(stats.outputs), static_cast<unsigned long long>(stats.skipped),
+                  stats.end_time);
+    os << line;
+
+    std::snprintf(line, sizeof(line), "%-16s %6s %8s %8s %8s %6s\n", "controller", "id", "trips", "stops", "served",
+                  "peak");
+    os << line;
+    for (const ControllerStats& c : stats.controllers) {
+        std::snprintf(line, sizeof(line), "%-16s %6ld %8llu %8llu %8llu %6llu\n", c.name.c_str(), c.model_id,
+                      static_cast<unsigned long long>(c.trips), static_cast<unsigned long long>(c.stops),
+                      static_cast<unsigned long long>(c.served), static_cast<unsigned long long>(c.peak_calls));
+        os << line;
+    }
+
+    std::snprintf(line, sizeof(line), "%-16s %6s %8s %10s %6s\n", "vehicle", "id", "trips", "busy_min", "util");
+    os << line;
+    for (const VehicleStats& v : stats.vehicles) {
+        const double util = stats.end_time > 0 ? v.busy / stats.end_time : 0.0;
+        std::snprintf(line, sizeof(line), "%-16s %6ld %8llu %10.2f %5.1f%%\n", v.name.c_str(), v.model_id,
+                      static_cast<unsigned long long>(v.trips), v.busy, 100.0 * util);
+        os << line;
+    }
+
+    write_summary(os, stats.service);
+}
+
+void write_queue_series(std::ostream& os, const LogStats& stats) {
+    os << "start;mean_stops;mean_calls;peak_calls\n";
+    char line[128];
+    for (const QueuePoint& q : stats.queue) {
+        std::snprintf(line, sizeof(line), "%g;%.4f;%.4f;%llu\n", q.start, q.stops, q.calls,
+                      static_cast<unsigned long long>(q.peak));
+        os << line;
+    }
+}
+
+}
@@ -0,0 +1,102 @@
+#ifndef FE_LOG_STATS_HPP
+#define FE_LOG_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "kpi.hpp"
+
+namespace fe {
+    /**
+     * Read-only memory mapping of a whole file (empty files map to nothing).
+     * Throws std::runtime_error if the file cannot be opened or mapped.
+     */
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        [[nodiscard]] const char* data() const { return bytes; }
+        [[nodiscard]] std::size_t size() const { return length; }
+
+    private:
+        void* base = nullptr;
+        const char* bytes = nullptr;
+        std::size_t length = 0;
+    };
+
+    struct LogStatsOptions {
+        double bucket = 60.0;   // minutes per queue time series point
+        unsigned threads = 0;   // chunks parsed in parallel; 0: one per core
+    };
+
+    // One car's vehicle (EVehicle states and 'out' outputs).
+    struct VehicleStats {
+        long model_id = 0;
+        std::string name;
+        std::uint64_t trips = 0;   // trips completed ('out' outputs)
+        double busy = 0.0;         // minutes spent moving
+    };
+
+    // One controller (EControl states, 'timem', 'floor' and 'served' outputs).
+    struct ControllerStats {
+        long model_id = 0;
+        std::string name;
+        std::uint64_t trips = 0;   // trips commanded ('timem' outputs)
+        std::uint64_t stops = 0;   // floors reached ('floor' outputs)
+        std::uint64_t served = 0;
+        std::uint64_t peak_calls = 0;  // most calls held at once
+    };
+
+    // Time-weighted queue of one time series bucket, summed over controllers.
+    struct QueuePoint {
+        double start = 0.0;
+        double stops = 0.0;        // mean pending stops (EControl 'q')
+        double calls = 0.0;        // mean calls held (EControl 'held')
+        std::uint64_t peak = 0;    // most calls one controller held in the bucket
+    };
+
+    /**
+     * KPIs rebuilt from a Cadmium CSV log (';'-separated, CSVLogger format)
+     * of any experiment with ECall, EControl and EVehicle atomics; models are
+     * recognised by the text of their states (see the atomics' operator<<),
+     * so any ids and any number of cars work. EFused states are not
+     * decoded; its 'served' outputs still count.
+     */
+    struct LogStats {
+        std::uint64_t bytes = 0;
+        std::uint64_t lines = 0;       // data lines (header excluded)
+        std::uint64_t states = 0;
+        std::uint64_t outputs = 0;
+        std::uint64_t skipped = 0;     // lines that are not a state or an output
+        double end_time = 0.0;         // last time in the log
+        std::vector<VehicleStats> vehicles;       // by model id
+        std::vector<ControllerStats> controllers; // by model id
+        std::vector<QueuePoint> queue;            // one point per bucket
+        double bucket = 60.0;
+        RunKpi service;  // calls (ECall ids), served, wait and trip per floor
+    };
+
+    /**
+     * Maps 'path' and parses it in options.threads chunks split at line
+     * boundaries, each scanned for separators 16 bytes at a time; the
+     * chunks' partial results are merged in order, so the result does not
+     * depend on the thread count. Throws std::runtime_error on I/O errors.
+     */
+    LogStats analyze_log(const std::string& path, const LogStatsOptions& options = LogStatsOptions());
+
+    // Text report: totals, trips and utilization per car, then the
+    // per-floor service table of write_summary.
+    void write_log_stats(std::ostream& os, const LogStats& stats);
+
+    // Queue time series as CSV: start;mean_stops;mean_calls;peak_calls
+    void write_queue_series(std::ostream& os, const LogStats& stats);
+}
+
+#endif
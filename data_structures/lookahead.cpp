@@ -0,0 +1,96 @@
+#include "lookahead.hpp"
+#include "vehicle_profile.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+
+namespace fe {
+
+ElevatorFork::ElevatorFork(const PendingRequests& requests, Floor current, Direction direction,
+                           const ControlConfig& config, Floor target, double remaining)
+    : requests(requests), config(&config), current(current), target(target), direction(direction) {
+    if (remaining >= 0.0) {
+        this->requests.clear_done();
+        moving = true;
+        arrival = remaining;
+    } else {
+        this->requests.arrive_and_serve([](const Call&) {});
+        this->target = current;
+    }
+}
+
+double ElevatorFork::travel_time(Floor from, Floor to) const {
+    return config->travel ? config->travel->trip(from, to) : static_cast<double>(std::abs(to - from));
+}
+
+void ElevatorFork::depart(Floor stop) {
+    if (stop > current) {
+        direction = Direction::up;
+    } else if (stop < current) {
+        direction = Direction::down;
+    }
+    target = stop;
+    moving = true;
+    arrival = now + travel_time(current, stop);
+}
+
+void ElevatorFork::commit(Floor stop) {
+    requests.take(stop);
+    depart(stop);
+}
+
+void ElevatorFork::run(double until) {
+    while (now < until) {
+        if (!moving) {
+            if (requests.empty()) {
+                break;
+            }
+            Direction way = direction;
+            const Floor stop = requests.pop_next(current, way, *config, SchedulePolicy::look);
+            depart(stop);
+        }
+        if (arrival > until) {
+            break;
+        }
+        now = arrival;
+        requests.arrive_and_serve([&](const Call&) {
+            served_wait += now;
+            ++served_calls;
+        });
+        current = target;
+        moving = false;
+    }
+    now = std::max(now, until);
+}
+
+Floor ElevatorFork::best_stop(const PendingRequests& requests, Floor current, Direction direction,
+                              const ControlConfig& config) {
+    std::array<Floor, FE_REQUEST_CAPACITY> stops{};
+    std::size_t count = 0;
+    requests.for_each_pending([&](const Call& call) {
+        if (std::find(stops.begin(), stops.begin() + count, call.floor) == stops.begin() + count) {
+            stops[count++] = call.floor;
+        }
+    });
+    if (count == 1) {
+        return stops[0];
+    }
+
+    const ElevatorFork base(requests, current, direction, config);
+    Floor best = stops[0];
+    double least = std::numeric_limits<double>::infinity();
+    for (std::size_t k = 0; k < count; ++k) {
+        ElevatorFork fork = base;
+        fork.commit(stops[k]);
+        fork.run(config.lookahead);
+        if (fork.waited() < least) {
+            least = fork.waited();
+            best = stops[k];
+        }
+    }
+    return best;
+}
+
+}
@@ -0,0 +1,76 @@
+#ifndef FE_LOOKAHEAD_HPP
+#define FE_LOOKAHEAD_HPP
+
+#include <cstdint>
+#include <type_traits>
+
+#include "messages.hpp"
+#include "scheduling.hpp"
+
+namespace fe {
+    /**
+     * Speculative copy of one car and its controller: the clock (minutes
+     * since the fork), the car's floor and trip in progress, and the
+     * pending requests. Inline and trivially copyable (the requests are an
+     * fe::PendingRequests, the configuration is referenced), so a fork is a
+     * stack copy with no heap allocation; it runs without messages or logs
+     * and is simply dropped.
+     * - run() lets the car serve the held requests by LOOK, with no new
+     *   calls, until a given time.
+     * - waited() is the cost of the future it simulated: minutes from the
+     *   fork until each call was served, or until the fork's clock for the
+     *   calls still open.
+     * SchedulePolicy::lookahead picks its next stop with best_stop().
+     */
+    class ElevatorFork {
+    public:
+        // A car at 'current' holding 'requests'. With 'remaining' >= 0 it is
+        // on its way to 'target' and arrives after 'remaining' minutes (its
+        // riding calls complete there); otherwise it is idle, and riding
+        // calls belong to trips already decided and are left out.
+        ElevatorFork(const PendingRequests& requests, Floor current, Direction direction,
+                     const ControlConfig& config, Floor target = 0, double remaining = -1.0);
+
+        // The idle car's next trip goes to 'stop' (a pending floor)
+        void commit(Floor stop);
+        // Serves the requests by LOOK until 'until' minutes after the fork
+        void run(double until);
+
+        [[nodiscard]] double clock() const { return now; }
+        [[nodiscard]] double waited() const {
+            return served_wait + static_cast<double>(requests.calls()) * now;
+        }
+        [[nodiscard]] std::uint64_t served() const { return served_calls; }
+        [[nodiscard]] Floor floor() const { return current; }
+        [[nodiscard]] bool idle() const { return !moving; }
+
+        /**
+         * The pending floor to travel to next from 'current': every distinct
+         * stop is tried on its own fork (the oldest call's first, which wins
+         * ties), followed by LOOK for config.lookahead minutes, and the one
+         * leaving the least waited() is chosen. Must not be called when
+         * requests.empty().
+         */
+        static Floor best_stop(const PendingRequests& requests, Floor current, Direction direction,
+                               const ControlConfig& config);
+
+    private:
+        [[nodiscard]] double travel_time(Floor from, Floor to) const;
+        void depart(Floor stop);
+
+        PendingRequests requests;
+        const ControlConfig* config;
+        double now = 0.0;
+        Floor current;
+        Floor target;
+        Direction direction;
+        bool moving = false;
+        double arrival = 0.0;       // fork time the car reaches target
+        double served_wait = 0.0;   // sum of the served calls' times
+        std::uint64_t served_calls = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<ElevatorFork>, "a fork is copied bytewise, with no heap");
+}
+
+#endif
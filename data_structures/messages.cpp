@@ -1,5 +1,88 @@
 #include "messages.hpp"
 
-// This translation unit is intentionally minimal.
-// It exists to mirror the ABP repository structure where custom message
-// types are compiled into a separate object file.
+#include <cstdlib>
+#include <string>
+
+namespace fe {
+
+const char* to_string(Direction direction) {
+    switch (direction) {
+        case Direction::idle: return "idle";
+        case Direction::up: return "up";
+        case Direction::down: return "down";
+    }
+    return "?";
+}
+
+const char* to_string(CallSource source) {
+    return source == CallSource::inside ? "in" : "out";
+}
+
+std::ostream& operator<<(std::ostream& os, const Call& call) {
+    os << call.floor << ' ' << to_string(call.source);
+    if (call.direction != Direction::idle) {
+        os << ' ' << to_string(call.direction);
+    }
+    if (call.priority != 0) {
+        os << " p" << static_cast<unsigned>(call.priority);
+    }
+    if (call.id != 0) {
+        os << " #" << call.id << " @" << call.issued;
+    }
+    return os;
+}
+
+std::istream& operator>>(std::istream& is, Call& call) {
+    Call c;
+    if (!(is >> c.floor)) {
+        return is;
+    }
+
+    // Optional fields, up to the end of the line (peek() at end of input
+    // would set failbit, so stop as soon as eof is reached)
+    std::string token;
+    while (!is.eof() && (is.peek() == ' ' || is.peek() == '\t')) {
+        is.get();
+        const int next = is.peek();
+        if (next == ' ' || next == '\t' || next == '\n' || next == '\r' || next == std::char_traits<char>::eof()) {
+            continue;
+        }
+        is >> token;
+        char* end = nullptr;
+        if (token == "in") {
+            c.source = CallSource::inside;
+        } else if (token == "out") {
+            c.source = CallSource::outside;
+        } else if (token == "up") {
+            c.direction = Direction::up;
+        } else if (token == "down") {
+            c.direction = Direction::down;
+        } else if (token.size() > 1 && token[0] == 'p') {
+            const unsigned long p = std::strtoul(token.c_str() + 1, &end, 10);
+            if (*end != '\0' || p > 255) {
+                is.setstate(std::ios::failbit);
+                return is;
+            }
+            c.priority = static_cast<std::uint8_t>(p);
+        } else if (token.size() > 1 && token[0] == '#') {
+            c.id = std::strtoull(token.c_str() + 1, &end, 10);
+            if (*end != '\0') {
+                is.setstate(std::ios::failbit);
+                return is;
+            }
+        } else if (token.size() > 1 && token[0] == '@') {
+            c.issued = std::strtod(token.c_str() + 1, &end);
+            if (*end != '\0') {
+                is.setstate(std::ios::failbit);
+                return is;
+            }
+        } else {
+            is.setstate(std::ios::failbit);
+            return is;
+        }
+    }
+    call = c;
+    return is;
+}
+
+}
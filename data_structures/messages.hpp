@@ -1,13 +1,71 @@
 #ifndef FE_MESSAGES_HPP
 #define FE_MESSAGES_HPP
 
-// For the simplest implementation we just use primitive types (int) as messages.
-// This file exists to keep the 'data_structures' folder non-empty and to allow
-// future extension (e.g., adding direction, priority, timestamps, etc.).
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+
+// Floors are plain ints and travel times plain doubles. Requests travel as
+// fe::Call, so every served output can be traced back to the request that
+// caused it.
 
 namespace fe {
-    using Floor = int;        // requested/served floor number
-    using TravelTime = int;   // travel time in minutes (1 minute per floor)
+    using Floor = int;          // requested/served floor number
+    using TravelTime = double;  // travel time in minutes (see fe::TravelTable)
+
+    enum class Direction : std::uint8_t { idle, up, down };
+
+    // Which ECall input a call enters through.
+    enum class CallSource : std::uint8_t { inside = 0, outside = 1 };
+
+    const char* to_string(Direction direction);
+    const char* to_string(CallSource source);
+
+    /**
+     * One floor request, from the call sources through ECall, the dispatcher
+     * and the controllers to the served output.
+     * - floor: the floor the car must reach (the hall floor of an outside
+     *   call, the destination of an inside call).
+     * - id / issued: stamped by ECall (or EFused) when the call enters the
+     *   system, so served time - issued is the exact service latency. The
+     *   sources leave id at 0 ("not stamped yet").
+     * - direction: requested direction of a hall call (idle if unknown).
+     * - priority: 0 is normal; carried end to end for policies and reports.
+     * Trivially copyable and 24 bytes: message bags hold calls by value and
+     * never allocate per call.
+     */
+    struct Call {
+        std::uint64_t id = 0;
+        double issued = 0.0;      // minutes
+        Floor floor = 1;
+        CallSource source = CallSource::outside;
+        Direction direction = Direction::idle;
+        std::uint8_t priority = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Call>, "Call is copied by value through message bags");
+    static_assert(sizeof(Call) == 24, "Call should stay compact");
+
+    // Gives an unstamped call (id 0) the next id, its issue time and the
+    // input it entered through; calls stamped upstream are left untouched.
+    inline void stamp(Call& call, CallSource source, double now, std::uint64_t& last_id) {
+        if (call.id == 0) {
+            call.id = ++last_id;
+            call.issued = now;
+            call.source = source;
+        }
+    }
+
+    /**
+     * Text form, shared by the logs and the input files:
+     *   <floor> [in|out] [up|down] [p<priority>] [#<id>] [@<issued>]
+     * operator<< writes the floor followed by the fields that are set;
+     * operator>> reads the floor and then any of the optional fields up to
+     * the end of the line, so the plain 'time floor' files keep working.
+     */
+    std::ostream& operator<<(std::ostream& os, const Call& call);
+    std::istream& operator>>(std::istream& is, Call& call);
 }
 
 #endif
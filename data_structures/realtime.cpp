@@ -0,0 +1,188 @@
+#include "realtime.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace fe {
+
+namespace {
+    constexpr int kPollMs = 100;  // how often the reader notices a stop request
+}
+
+LiveFeed::LiveFeed(const std::string& path) : path(path) {
+    struct stat st {};
+    const bool exists = ::stat(path.c_str(), &st) == 0;
+    fifo = exists && S_ISFIFO(st.st_mode);
+    if (!fifo) {
+        if (exists && !S_ISSOCK(st.st_mode)) {
+            throw std::runtime_error("live feed: not a FIFO or socket: " + path);
+        }
+        sockaddr_un addr {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("live feed: socket path too long: " + path);
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        ::unlink(path.c_str());  // stale socket of a previous run
+
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listen_fd < 0
+            || ::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0
+            || ::listen(listen_fd, 1) != 0) {
+            const std::string why = std::strerror(errno);
+            if (listen_fd >= 0) {
+                ::close(listen_fd);
+            }
+            throw std::runtime_error("live feed: cannot listen on " + path + ": " + why);
+        }
+    }
+    reader = std::thread([this] { run(); });
+}
+
+LiveFeed::~LiveFeed() {
+    running.store(false, std::memory_order_release);
+    if (reader.joinable()) {
+        reader.join();
+    }
+    if (listen_fd >= 0) {
+        ::close(listen_fd);
+        ::unlink(path.c_str());
+    }
+}
+
+void LiveFeed::drain(std::vector<LiveCall>& out) {
+    out.clear();
+    std::lock_guard<std::mutex> guard(lock);
+    out.swap(received);
+}
+
+void LiveFeed::run() {
+    if (fifo) {
+        read_fifo();
+    } else {
+        read_socket();
+    }
+}
+
+void LiveFeed::read_fifo() {
+    while (running.load(std::memory_order_acquire)) {
+        // Non-blocking open succeeds before any writer shows up
+        const int fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+        if (fd < 0) {
+            ::usleep(kPollMs * 1000);
+            continue;
+        }
+        const bool more = read_from(fd);
+        ::close(fd);
+        if (!more) {
+            return;
+        }
+    }
+}
+
+void LiveFeed::read_socket() {
+    while (running.load(std::memory_order_acquire)) {
+        pollfd p {listen_fd, POLLIN, 0};
+        if (::poll(&p, 1, kPollMs) <= 0) {
+            continue;
+        }
+        const int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        const bool more = read_from(fd);
+        ::close(fd);
+        if (!more) {
+            return;
+        }
+    }
+}
+
+bool LiveFeed::read_from(int fd) {
+    std::string pending;
+    char buffer[4096];
+    WallClock::time_point now = WallClock::now();
+    while (running.load(std::memory_order_acquire)) {
+        pollfd p {fd, POLLIN, 0};
+        const int ready = ::poll(&p, 1, kPollMs);
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            continue;
+        }
+        if (ready < 0) {
+            break;
+        }
+        const ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+            continue;
+        }
+        if (n <= 0) {
+            break;  // the writer is gone
+        }
+        now = WallClock::now();
+        pending.append(buffer, static_cast<std::size_t>(n));
+        std::size_t begin = 0;
+        for (std::size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', begin)) {
+            parse(pending.substr(begin, end - begin), now);
+            begin = end + 1;
+        }
+        pending.erase(0, begin);
+    }
+    if (!running.load(std::memory_order_acquire)) {
+        return false;
+    }
+    if (!pending.empty()) {
+        parse(pending, now);  // last line without a newline
+    }
+    disconnects.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+void LiveFeed::parse(const std::string& line, WallClock::time_point arrived) {
+    const std::size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') {
+        return;
+    }
+    std::istringstream in(line.back() == '\r' ? line.substr(0, line.size() - 1) : line);
+    LiveCall live {Call(), arrived};
+    if (!(in >> live.call)) {
+        bad_lines.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    received.push_back(live);
+}
+
+namespace {
+    void write_latency(std::ostream& os, const char* name, const Histogram& h) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%-15s %8llu %9.3f %9.3f %9.3f %9.3f %9.3f\n", name,
+                      static_cast<unsigned long long>(h.count()), h.mean(), h.quantile(0.5),
+                      h.quantile(0.9), h.quantile(0.99), h.max());
+        os << line;
+    }
+}
+
+void write_summary(std::ostream& os, const RealTimeStats& stats) {
+    os << "calls " << stats.calls << ", events " << stats.events << ", late events " << stats.late_events
+       << " (> " << stats.tolerance_ms << " ms, worst " << stats.worst_lag_ms << " ms), late slices "
+       << stats.late_slices << " of " << stats.slices << "\n";
+    char header[160];
+    std::snprintf(header, sizeof(header), "%-15s %8s %9s %9s %9s %9s %9s\n",
+                  "latency (ms)", "count", "mean", "p50", "p90", "p99", "max");
+    os << header;
+    write_latency(os, "feed", stats.feed);
+    write_latency(os, "command/idle", stats.command_idle);
+    write_latency(os, "command/queued", stats.command_queued);
+}
+
+}
@@ -0,0 +1,153 @@
+#ifndef FE_REALTIME_HPP
+#define FE_REALTIME_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "messages.hpp"
+#include "kpi.hpp"
+
+namespace fe {
+    using WallClock = std::chrono::steady_clock;
+
+    // One call read from the live feed, with the wall time it arrived at.
+    struct LiveCall {
+        Call call;
+        WallClock::time_point arrived;
+    };
+
+    /**
+     * Live call feed: a reader thread that takes calls from a local Unix
+     * stream socket or a named pipe, one call per line in fe::Call's text
+     * form without the time ('<floor> [in|out] [up|down] [p<priority>]').
+     * - If 'path' is an existing FIFO it is read as a named pipe (reopened
+     *   for the next writer when one closes it); otherwise a Unix socket is
+     *   created at 'path' (replacing a stale one) and serves one client at a
+     *   time.
+     * - Calls are stamped with their arrival time on the reader thread and
+     *   handed over in batches by drain(), so the simulation thread never
+     *   blocks on I/O.
+     * - Blank lines and lines starting with '#' are skipped; lines that do
+     *   not parse are counted and dropped.
+     * Throws std::runtime_error if the socket cannot be created.
+     */
+    class LiveFeed {
+    public:
+        explicit LiveFeed(const std::string& path);
+        ~LiveFeed();
+
+        LiveFeed(const LiveFeed&) = delete;
+        LiveFeed& operator=(const LiveFeed&) = delete;
+
+        // Moves the calls received since the last call into 'out' (cleared first).
+        void drain(std::vector<LiveCall>& out);
+
+        // A writer has connected and disconnected since the feed was opened.
+        [[nodiscard]] bool closed() const { return disconnects.load(std::memory_order_acquire) > 0; }
+        [[nodiscard]] std::uint64_t malformed() const { return bad_lines.load(std::memory_order_relaxed); }
+
+    private:
+        void run();
+        void read_fifo();
+        void read_socket();
+        bool read_from(int fd);        // until the writer closes; false when stopping
+        void parse(const std::string& line, WallClock::time_point arrived);
+
+        std::string path;
+        bool fifo = false;
+        int listen_fd = -1;
+
+        std::mutex lock;
+        std::vector<LiveCall> received;  // guarded by 'lock'
+
+        std::atomic<bool> running{true};
+        std::atomic<std::uint64_t> disconnects{0};
+        std::atomic<std::uint64_t> bad_lines{0};
+        std::thread reader;
+    };
+
+    /**
+     * Maps simulated time onto the wall clock: simulated minute t is due at
+     * start + t * seconds_per_minute.
+     */
+    struct RealTimeClock {
+        WallClock::time_point start = WallClock::now();
+        double seconds_per_minute = 60.0;  // 60 / speed-up
+
+        [[nodiscard]] WallClock::time_point due(double minutes) const {
+            return start + std::chrono::duration_cast<WallClock::duration>(
+                std::chrono::duration<double>(minutes * seconds_per_minute));
+        }
+    };
+
+    inline double elapsed_ms(WallClock::time_point from, WallClock::time_point to) {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    /**
+     * Real-time measurements of one run, filled by ELiveFeed and
+     * ERealTimeProbe and owned by the caller.
+     * - feed: wall ms from a call's arrival on the feed to its injection into
+     *   the model.
+     * - command: wall ms from a call's arrival to the next EControl::timem
+     *   command; 'idle' when that command was issued at the simulated instant
+     *   the call was injected (the car was free: pure processing delay),
+     *   'queued' when the car first had to finish its trip in progress.
+     * - An event is late when the model processes it more than 'tolerance_ms'
+     *   after its simulated time is due on the wall clock; a slice is late
+     *   when the driver starts it after its due time plus the tolerance.
+     */
+    struct RealTimeStats {
+        RealTimeClock clock;
+        double tolerance_ms = 50.0;
+
+        Histogram feed{1e-3};           // ms
+        Histogram command_idle{1e-3};   // ms
+        Histogram command_queued{1e-3}; // ms
+        std::uint64_t calls = 0;
+        std::uint64_t events = 0;       // calls, travel commands and floors observed
+        std::uint64_t late_events = 0;
+        std::uint64_t slices = 0;
+        std::uint64_t late_slices = 0;
+        double worst_lag_ms = 0.0;      // largest processing time past due
+
+        // Arrival times of the calls injected by ELiveFeed, by call id, until
+        // ERealTimeProbe sees them enter the system
+        std::unordered_map<std::uint64_t, WallClock::time_point> arrivals;
+
+        // Calls in the system still waiting for a travel command
+        struct Waiting {
+            WallClock::time_point arrived;
+            double injected;            // simulated minutes
+        };
+        std::vector<Waiting> waiting;
+
+        // Counts one event of simulated time 'minutes' processed at 'now'.
+        void event(double minutes, WallClock::time_point now) {
+            ++events;
+            const double lag = elapsed_ms(clock.due(minutes), now);
+            if (lag > worst_lag_ms) {
+                worst_lag_ms = lag;
+            }
+            if (lag > tolerance_ms) {
+                ++late_events;
+            }
+        }
+    };
+
+    /**
+     * Summary: counts, late events and slices, then count, mean, p50, p90,
+     * p99 and max of each latency histogram (ms).
+     */
+    void write_summary(std::ostream& os, const RealTimeStats& stats);
+}
+
+#endif
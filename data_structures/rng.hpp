@@ -0,0 +1,43 @@
+#ifndef FE_RNG_HPP
+#define FE_RNG_HPP
+
+#include <cmath>
+#include <cstdint>
+
+namespace fe {
+    /**
+     * SplitMix64 generator: one 64-bit word of state, so it can live inside a
+     * DEVS state and be copied or logged freely. Its output sequence is fully
+     * specified, unlike the std:: distributions, so a seed gives the same run
+     * on every platform and standard library.
+     */
+    struct Rng {
+        std::uint64_t state;
+
+        explicit Rng(std::uint64_t seed = 0) : state(seed) {}
+
+        std::uint64_t next() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [0, 1)
+        double uniform() {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+
+        // Uniform integer in [0, n), n < 2^32 (multiply-shift, no division)
+        std::uint32_t below(std::uint32_t n) {
+            return static_cast<std::uint32_t>(((next() >> 32) * n) >> 32);
+        }
+
+        // Exponential with unit mean
+        double exponential() {
+            return -std::log1p(-uniform());
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,359 @@
+#include "scheduling.hpp"
+#include "lookahead.hpp"
+#include "snapshot.hpp"
+#include "vehicle_profile.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace fe {
+
+SchedulePolicy parse_policy(const std::string& name) {
+    if (name == "fifo") return SchedulePolicy::fifo;
+    if (name == "scan") return SchedulePolicy::scan;
+    if (name == "look") return SchedulePolicy::look;
+    if (name == "nearest") return SchedulePolicy::nearest;
+    if (name == "lookahead") return SchedulePolicy::lookahead;
+    throw std::invalid_argument("unknown scheduling policy: " + name);
+}
+
+const char* to_string(SchedulePolicy policy) {
+    switch (policy) {
+        case SchedulePolicy::fifo: return "fifo";
+        case SchedulePolicy::scan: return "scan";
+        case SchedulePolicy::look: return "look";
+        case SchedulePolicy::nearest: return "nearest";
+        case SchedulePolicy::lookahead: return "lookahead";
+    }
+    return "?";
+}
+
+std::ostream& operator<<(std::ostream& os, SchedulePolicy policy) {
+    return os << to_string(policy);
+}
+
+std::ostream& operator<<(std::ostream& os, OverflowPolicy overflow) {
+    return os << to_string(overflow);
+}
+
+std::ostream& operator<<(std::ostream& os, const Route& route) {
+    os << (route.append ? "+[" : "[");
+    const char* separator = "";
+    for (const RouteLeg& leg : route) {
+        os << separator << leg.floor << ':' << leg.motion;
+        separator = ",";
+    }
+    return os << ']';
+}
+
+OverflowPolicy parse_overflow(const std::string& name) {
+    if (name == "drop") return OverflowPolicy::drop;
+    if (name == "reject") return OverflowPolicy::reject;
+    if (name == "coalesce") return OverflowPolicy::coalesce;
+    throw std::invalid_argument("unknown overflow policy: " + name);
+}
+
+const char* to_string(OverflowPolicy overflow) {
+    switch (overflow) {
+        case OverflowPolicy::drop: return "drop";
+        case OverflowPolicy::reject: return "reject";
+        case OverflowPolicy::coalesce: return "coalesce";
+    }
+    return "?";
+}
+
+bool can_stop_en_route(const ControlConfig& config, Floor origin, Floor target, Floor floor, double moved) {
+    const bool between = (origin < floor && floor < target) || (target < floor && floor < origin);
+    if (!between) {
+        return false;
+    }
+    if (!config.travel) {
+        return moved < static_cast<double>(std::abs(floor - origin));
+    }
+    return moved < config.travel->motion(origin, floor) - config.travel->braking(origin, floor);
+}
+
+// -------------------- PendingRequests --------------------
+
+namespace {
+    constexpr long kWordBits = 64;
+    constexpr long kMaxFloors = FE_MAX_FLOORS;
+}
+
+PendingRequests::PendingRequests(SchedulePolicy policy, std::size_t capacity, OverflowPolicy overflow)
+    : policy(policy), on_full(overflow), limit(static_cast<std::uint16_t>(capacity)) {
+    if (capacity == 0 || capacity > FE_REQUEST_CAPACITY) {
+        throw std::invalid_argument("request capacity must be between 1 and FE_REQUEST_CAPACITY ("
+                                    + std::to_string(FE_REQUEST_CAPACITY) + ")");
+    }
+}
+
+void PendingRequests::set_stop(Floor floor) {
+    long i = static_cast<long>(floor) - base;
+    if (stop_count == 0) {
+        base = floor;  // anchor the window at the first stop
+        i = 0;
+    } else if (i < 0 || i >= kMaxFloors) {
+        // re-anchor the window at the lowest stop (rare: floors usually start at the lobby)
+        Floor lowest = floor;
+        Floor highest = floor;
+        for (std::size_t k = 0; k < count; ++k) {
+            if (stages[k] == Stage::pending) {
+                lowest = std::min(lowest, held[k].floor);
+                highest = std::max(highest, held[k].floor);
+            }
+        }
+        if (static_cast<long>(highest) - lowest >= kMaxFloors) {
+            throw std::out_of_range("pending stops span more than FE_MAX_FLOORS ("
+                                    + std::to_string(FE_MAX_FLOORS) + ") floors");
+        }
+        base = lowest;
+        bits.fill(0);
+        for (std::size_t k = 0; k < count; ++k) {
+            if (stages[k] == Stage::pending) {
+                const long j = static_cast<long>(held[k].floor) - base;
+                bits[static_cast<std::size_t>(j / kWordBits)] |= std::uint64_t{1} << (j % kWordBits);
+            }
+        }
+        i = static_cast<long>(floor) - base;
+    }
+    bits[static_cast<std::size_t>(i / kWordBits)] |= std::uint64_t{1} << (i % kWordBits);
+    ++stop_count;
+}
+
+Admission PendingRequests::admit(const Call& call, Stage stage, bool joins_stop) {
+    if (count == limit) {
+        return (on_full == OverflowPolicy::coalesce && joins_stop) ? Admission::coalesced : Admission::refused;
+    }
+    held[count] = call;
+    stages[count] = stage;
+    ++count;
+    return Admission::held;
+}
+
+Admission PendingRequests::push(const Call& call) {
+    const bool stop = pending(call.floor);
+    if (!stop && count < limit) {
+        set_stop(call.floor);
+    }
+    return admit(call, Stage::pending, stop);  // a duplicate joins the pending stop
+}
+
+Admission PendingRequests::ride(const Call& call) {
+    return admit(call, Stage::riding, true);
+}
+
+bool PendingRequests::pending(Floor floor) const {
+    if (stop_count == 0) {
+        return false;
+    }
+    const long i = static_cast<long>(floor) - base;
+    if (i < 0 || i >= kMaxFloors) {
+        return false;
+    }
+    return (bits[static_cast<std::size_t>(i / kWordBits)] >> (i % kWordBits)) & 1U;
+}
+
+void PendingRequests::take(Floor floor) {
+    if (!pending(floor)) {
+        return;  // SCAN turning point with no request
+    }
+    const long i = static_cast<long>(floor) - base;
+    bits[static_cast<std::size_t>(i / kWordBits)] &= ~(std::uint64_t{1} << (i % kWordBits));
+    --stop_count;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (stages[k] == Stage::pending && held[k].floor == floor) {
+            stages[k] = Stage::riding;
+        }
+    }
+}
+
+void PendingRequests::divert(Floor stop, Floor next) {
+    bool waiting = false;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (stages[k] == Stage::riding) {
+            stages[k] = Stage::pending;
+            waiting = true;
+        }
+    }
+    if (waiting && !pending(stop)) {
+        set_stop(stop);
+    }
+    take(next);
+}
+
+void PendingRequests::arrive() {
+    for (std::size_t k = 0; k < count; ++k) {
+        if (stages[k] == Stage::riding) {
+            stages[k] = Stage::done;
+        }
+    }
+}
+
+void PendingRequests::clear_done() {
+    std::size_t kept = 0;
+    for (std::size_t k = 0; k < count; ++k) {
+        if (stages[k] != Stage::done) {
+            held[kept] = held[k];
+            stages[kept] = stages[k];
+            ++kept;
+        }
+    }
+    count = static_cast<std::uint16_t>(kept);
+}
+
+long PendingRequests::next_set(long index) const {
+    index = std::max(index, 0L);
+    if (stop_count == 0 || index >= kMaxFloors) {
+        return -1;
+    }
+    auto w = static_cast<std::size_t>(index / kWordBits);
+    std::uint64_t word = bits[w] & (~std::uint64_t{0} << (index % kWordBits));
+    while (word == 0) {
+        if (++w == bits.size()) {
+            return -1;
+        }
+        word = bits[w];
+    }
+    return static_cast<long>(w) * kWordBits + __builtin_ctzll(word);
+}
+
+long PendingRequests::prev_set(long index) const {
+    if (index < 0 || stop_count == 0) {
+        return -1;
+    }
+    index = std::min(index, kMaxFloors - 1);
+    auto w = static_cast<std::size_t>(index / kWordBits);
+    const long bit = index % kWordBits;
+    std::uint64_t word = bits[w] & (bit == kWordBits - 1 ? ~std::uint64_t{0} : (std::uint64_t{1} << (bit + 1)) - 1);
+    while (word == 0) {
+        if (w == 0) {
+            return -1;
+        }
+        word = bits[--w];
+    }
+    return static_cast<long>(w) * kWordBits + (kWordBits - 1 - __builtin_clzll(word));
+}
+
+bool PendingRequests::has_above(Floor floor) const {
+    return next_set(static_cast<long>(floor) - base) >= 0;
+}
+
+bool PendingRequests::has_below(Floor floor) const {
+    return prev_set(static_cast<long>(floor) - base) >= 0;
+}
+
+Floor PendingRequests::first_above(Floor floor) const {
+    return base + static_cast<Floor>(next_set(static_cast<long>(floor) - base));
+}
+
+Floor PendingRequests::first_below(Floor floor) const {
+    return base + static_cast<Floor>(prev_set(static_cast<long>(floor) - base));
+}
+
+Floor PendingRequests::pop_next(Floor current, Direction& direction, const ControlConfig& config) {
+    return pop_next(current, direction, config, policy);
+}
+
+Floor PendingRequests::pop_next(Floor current, Direction& direction, const ControlConfig& config,
+                                SchedulePolicy by) {
+    Floor next = current;
+
+    if (by == SchedulePolicy::lookahead) {
+        next = ElevatorFork::best_stop(*this, current, direction, config);
+    } else if (by == SchedulePolicy::fifo) {
+        // the oldest pending call's floor became pending first
+        for (std::size_t k = 0; k < count; ++k) {
+            if (stages[k] == Stage::pending) {
+                next = held[k].floor;
+                break;
+            }
+        }
+    } else {
+        const bool above = has_above(current);
+        const bool below = has_below(current);
+
+        // Nearest pending floor; on a tie keep going the way we were going
+        auto nearest = [&]() {
+            if (above && below) {
+                const Floor up = first_above(current);
+                const Floor down = first_below(current);
+                if (up - current < current - down) return up;
+                if (current - down < up - current) return down;
+                return direction == Direction::down ? down : up;
+            }
+            return above ? first_above(current) : first_below(current);
+        };
+
+        if (by == SchedulePolicy::nearest || direction == Direction::idle) {
+            next = nearest();
+        } else if (direction == Direction::up) {
+            if (above) {
+                next = first_above(current);
+            } else if (by == SchedulePolicy::scan && current < config.top_floor) {
+                next = config.top_floor;  // finish the sweep before reversing
+            } else {
+                next = first_below(current);
+            }
+        } else {
+            if (below) {
+                next = first_below(current);
+            } else if (by == SchedulePolicy::scan && current > config.bottom_floor) {
+                next = config.bottom_floor;
+            } else {
+                next = first_above(current);
+            }
+        }
+    }
+    take(next);
+
+    if (next > current) {
+        direction = Direction::up;
+    } else if (next < current) {
+        direction = Direction::down;
+    }
+    return next;
+}
+
+void PendingRequests::save(SnapshotWriter& out) const {
+    out.put(static_cast<std::uint8_t>(policy));
+    // The calls in order with their stages; the stop bits are rebuilt on load
+    out.put(static_cast<std::uint64_t>(count));
+    for (std::size_t k = 0; k < count; ++k) {
+        out.put(stages[k]);
+        out.put(held[k]);
+    }
+}
+
+void PendingRequests::load(SnapshotReader& in) {
+    std::uint8_t saved_policy = 0;
+    in.get(saved_policy);
+    if (saved_policy != static_cast<std::uint8_t>(policy)) {
+        throw std::runtime_error(std::string("snapshot: pending requests were saved under another policy than ")
+                                 + to_string(policy));
+    }
+    std::uint64_t n = 0;
+    in.get(n);
+    if (n > limit) {
+        throw std::runtime_error("snapshot: " + std::to_string(n) + " requests exceed the capacity of "
+                                 + std::to_string(limit));
+    }
+    bits.fill(0);
+    stop_count = 0;
+    count = 0;
+    for (std::uint64_t k = 0; k < n; ++k) {
+        Stage stage = Stage::pending;
+        Call call;
+        in.get(stage);
+        in.get(call);
+        if (stage == Stage::pending && !pending(call.floor)) {
+            set_stop(call.floor);
+        }
+        held[count] = call;
+        stages[count] = stage;
+        ++count;
+    }
+}
+
+}
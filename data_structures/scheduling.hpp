@@ -0,0 +1,326 @@
+#ifndef FE_SCHEDULING_HPP
+#define FE_SCHEDULING_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "messages.hpp"
+
+// Sizes of the controller state, fixed at compile time ('make MAX_FLOORS=...
+// REQUEST_CAPACITY=...'; run 'make clean' when changing them):
+//  - FE_MAX_FLOORS: span of floors with pending stops (a multiple of 64)
+//  - FE_REQUEST_CAPACITY: calls a controller can hold (ControlConfig may lower it)
+//  - FE_REJECT_BURST: rejected calls of one instant held inline (more spill to the heap)
+//  - FE_ROUTE_LEGS: stops a route command carries (see fe::Route)
+#ifndef FE_MAX_FLOORS
+#define FE_MAX_FLOORS 1024
+#endif
+#ifndef FE_REQUEST_CAPACITY
+#define FE_REQUEST_CAPACITY 64
+#endif
+#ifndef FE_REJECT_BURST
+#define FE_REJECT_BURST 16
+#endif
+#ifndef FE_ROUTE_LEGS
+#define FE_ROUTE_LEGS 16
+#endif
+
+static_assert(FE_MAX_FLOORS > 0 && FE_MAX_FLOORS % 64 == 0, "FE_MAX_FLOORS must be a multiple of 64");
+static_assert(FE_REQUEST_CAPACITY > 0 && FE_REQUEST_CAPACITY <= 65535, "FE_REQUEST_CAPACITY must fit 16 bits");
+static_assert(FE_ROUTE_LEGS > 0 && FE_ROUTE_LEGS <= 255, "FE_ROUTE_LEGS must fit 8 bits");
+
+namespace fe {
+    class ElevatorFork;
+    class SnapshotReader;
+    class SnapshotWriter;
+    class TravelTable;
+
+    // How EControl picks the next stop among its pending requests.
+    //  - fifo:    floors in order of their first pending request
+    //  - scan:    sweep to the end of the shaft before reversing
+    //  - look:    sweep only as far as the last request before reversing
+    //  - nearest: closest pending floor first (ties keep the travel direction)
+    //  - lookahead: the pending floor whose trip, followed by LOOK for
+    //    ControlConfig::lookahead minutes, leaves the calls the least time
+    //    waiting (simulated on fe::ElevatorFork copies; see lookahead.hpp)
+    // Every policy serves all the requests for a floor with one stop.
+    enum class SchedulePolicy { fifo, scan, look, nearest, lookahead };
+
+    // What a controller does with a request once it holds 'request_capacity' calls.
+    //  - drop:     the call is discarded
+    //  - reject:   the call is discarded and output on the controller's
+    //              'rejected' port, at the instant it arrived
+    //  - coalesce: a call for a floor the car already has to stop at is
+    //              merged into that stop (the stop serves it, but it is not
+    //              reported on 'served'); any other call is rejected
+    enum class OverflowPolicy : std::uint8_t { drop, reject, coalesce };
+
+    // Outcome of offering a call to PendingRequests.
+    enum class Admission : std::uint8_t { held, coalesced, refused };
+
+    // Static controller configuration, shared by every car of a model.
+    struct ControlConfig {
+        SchedulePolicy policy = SchedulePolicy::fifo;
+        Floor bottom_floor = 1;  // SCAN sweeps down to here
+        Floor top_floor = 1;     // SCAN sweeps up to here (or the highest request)
+        // Trip times from a vehicle profile; nullptr: 1 minute per floor and
+        // no door dwell
+        std::shared_ptr<const TravelTable> travel;
+        // Calls a controller holds at most (<= FE_REQUEST_CAPACITY), and what
+        // happens to the next one
+        std::size_t request_capacity = FE_REQUEST_CAPACITY;
+        OverflowPolicy overflow = OverflowPolicy::reject;
+        // Stop a moving car for a request on its way (see can_stop_en_route);
+        // false: the car always finishes the trip it started
+        bool en_route = false;
+        // Send the vehicle the planned stops as one fe::Route instead of one
+        // travel time per stop (see uses_routes)
+        bool routes = false;
+        // Minutes SchedulePolicy::lookahead simulates ahead of each choice
+        double lookahead = 20.0;
+    };
+
+    // Whether EControl commands its vehicle by routes: en-route stops
+    // retarget single trips, so they take precedence.
+    inline bool uses_routes(const ControlConfig& config) { return config.routes && !config.en_route; }
+
+    // Parses "fifo", "scan", "look", "nearest" or "lookahead"; throws std::invalid_argument otherwise.
+    SchedulePolicy parse_policy(const std::string& name);
+    const char* to_string(SchedulePolicy policy);
+    // Parses "drop", "reject" or "coalesce"; throws std::invalid_argument otherwise.
+    OverflowPolicy parse_overflow(const std::string& name);
+    const char* to_string(OverflowPolicy overflow);
+
+    /**
+     * Whether a car that left 'origin' for 'target' 'moved' minutes ago can
+     * stop at 'floor' instead: the floor lies strictly between them, and the
+     * car has not reached the point where a trip from 'origin' to 'floor'
+     * starts braking (config.travel's braking(); no braking at 1 minute per
+     * floor). Until then the car runs the same speed curve as that trip, so
+     * stopping takes the rest of its motion time. Exact once the trips reach
+     * rated speed; for short hops the S-curves part a little earlier.
+     */
+    bool can_stop_en_route(const ControlConfig& config, Floor origin, Floor target, Floor floor, double moved);
+
+    /**
+     * Calls of one instant: the first N held inline, any more in a vector
+     * that is only allocated when a single bag brings more than N of them.
+     * Used for the calls a controller rejects, so none goes unreported.
+     */
+    template <std::size_t N>
+    class CallBurst {
+    public:
+        void push_back(const Call& call) {
+            if (count < N) {
+                calls[count++] = call;
+            } else {
+                spill.push_back(call);
+            }
+        }
+        void clear() {
+            count = 0;
+            spill.clear();
+        }
+        [[nodiscard]] bool empty() const { return count == 0; }
+        [[nodiscard]] std::size_t size() const { return count + spill.size(); }
+
+        // Calls in the order they were pushed
+        template <typename F>
+        void for_each(F&& f) const {
+            for (std::size_t i = 0; i < count; ++i) {
+                f(calls[i]);
+            }
+            for (const Call& call : spill) {
+                f(call);
+            }
+        }
+
+    private:
+        std::array<Call, N> calls{};
+        std::size_t count = 0;
+        std::vector<Call> spill;
+    };
+
+    // One stop of a route: the floor and the motion time to it from the stop before.
+    struct RouteLeg {
+        Floor floor = 1;
+        TravelTime motion = 0.0;
+    };
+
+    /**
+     * Stops a vehicle runs through in order, held inline (at most
+     * FE_ROUTE_LEGS; push_back() returns false beyond that).
+     * - As a command from EControl to EVehicle, 'append' tells whether the
+     *   legs follow the ones the vehicle holds, or replace every leg it has
+     *   not started (a leg that starts at the instant of the command counts
+     *   as not started).
+     * - Also the queue of legs a vehicle holds, and the controller's copy of it.
+     * Trivially copyable: it travels by value and is saved bytewise.
+     */
+    class Route {
+    public:
+        bool append = false;
+
+        bool push_back(Floor floor, TravelTime motion) {
+            if (last == FE_ROUTE_LEGS) {
+                if (first == 0) {
+                    return false;
+                }
+                for (std::size_t k = first; k < last; ++k) {
+                    legs[k - first] = legs[k];
+                }
+                last = static_cast<std::uint8_t>(last - first);
+                first = 0;
+            }
+            legs[last++] = RouteLeg{floor, motion};
+            return true;
+        }
+        void pop_front() { ++first; }
+        void clear() { first = last = 0; }
+        [[nodiscard]] bool empty() const { return first == last; }
+        [[nodiscard]] bool full() const { return first == 0 && last == FE_ROUTE_LEGS; }
+        [[nodiscard]] std::size_t size() const { return static_cast<std::size_t>(last - first); }
+        [[nodiscard]] const RouteLeg& front() const { return legs[first]; }
+        [[nodiscard]] const RouteLeg* begin() const { return legs.data() + first; }
+        [[nodiscard]] const RouteLeg* end() const { return legs.data() + last; }
+
+    private:
+        std::array<RouteLeg, FE_ROUTE_LEGS> legs{};
+        std::uint8_t first = 0;
+        std::uint8_t last = 0;
+    };
+
+    static_assert(std::is_trivially_copyable_v<Route>, "Route is copied by value and saved bytewise");
+
+    // Text form for the logs: '+' for an append, then floor:motion per leg
+    std::ostream& operator<<(std::ostream& os, const Route& route);
+
+    /**
+     * Requests of one controller, held inline in a fixed-capacity buffer
+     * (no heap, so a state's size is known at compile time):
+     * - pending calls wait for a stop at their floor, in arrival order;
+     * - riding calls are completed by the trip in progress;
+     * - done calls were completed by the last stop and await output.
+     * Stops are bits of a floor-indexed bitset over a window of
+     * FE_MAX_FLOORS floors: a request for a floor that is already pending
+     * merges into that stop, so repeated presses cost one trip. Membership
+     * is O(1); the next stop above or below the car is a scan of 64-floor
+     * words. fifo serves floors in the order of their oldest pending call.
+     * At most 'capacity' calls (<= FE_REQUEST_CAPACITY) are held; beyond
+     * that the OverflowPolicy decides.
+     */
+    class PendingRequests {
+    public:
+        explicit PendingRequests(SchedulePolicy policy = SchedulePolicy::fifo,
+                                 std::size_t capacity = FE_REQUEST_CAPACITY,
+                                 OverflowPolicy overflow = OverflowPolicy::reject);
+        explicit PendingRequests(const ControlConfig& config)
+            : PendingRequests(config.policy, config.request_capacity, config.overflow) {}
+
+        // A new request: queued at the stop for its floor. Throws
+        // std::out_of_range if the pending stops would span more than
+        // FE_MAX_FLOORS floors.
+        Admission push(const Call& call);
+        // A request for the floor the trip in progress stops at: it rides along.
+        Admission ride(const Call& call);
+
+        [[nodiscard]] bool empty() const { return stop_count == 0; }
+        [[nodiscard]] std::size_t size() const { return stop_count; }   // pending stops
+        [[nodiscard]] std::size_t calls() const { return count; }       // calls held, all stages
+        [[nodiscard]] std::size_t capacity() const { return limit; }
+        [[nodiscard]] OverflowPolicy overflow() const { return on_full; }
+        [[nodiscard]] bool pending(Floor floor) const;                  // a stop at 'floor'
+
+        /**
+         * Removes and returns the next floor to travel to from 'current'.
+         * Updates 'direction' to the direction of travel of the chosen trip;
+         * every call waiting at that floor rides along.
+         * For SCAN the result may be a shaft end with no request; it is not
+         * removed from the pending set. Must not be called when empty().
+         */
+        Floor pop_next(Floor current, Direction& direction, const ControlConfig& config);
+        // The same by 'by' instead of the held policy (forks roll out LOOK)
+        Floor pop_next(Floor current, Direction& direction, const ControlConfig& config, SchedulePolicy by);
+
+        // The trip in progress now ends at 'next', a floor on its way to
+        // 'stop': riding calls wait for 'stop' again, calls for 'next' ride.
+        void divert(Floor stop, Floor next);
+
+        void arrive();     // the trip in progress ended: riding calls are done
+        void clear_done(); // done calls were output
+
+        // arrive(), for_each_done(f) and clear_done() in one pass over the
+        // calls, for a model that outputs at the instant of the arrival
+        template <typename F>
+        void arrive_and_serve(F&& f) {
+            std::size_t kept = 0;
+            for (std::size_t k = 0; k < count; ++k) {
+                if (stages[k] == Stage::pending) {
+                    held[kept] = held[k];
+                    stages[kept] = Stage::pending;
+                    ++kept;
+                } else {
+                    f(held[k]);
+                }
+            }
+            count = static_cast<std::uint16_t>(kept);
+        }
+
+        template <typename F>
+        void for_each_pending(F&& f) const { for_each(Stage::pending, f); }
+        template <typename F>
+        void for_each_riding(F&& f) const { for_each(Stage::riding, f); }
+        template <typename F>
+        void for_each_done(F&& f) const { for_each(Stage::done, f); }
+
+        // Snapshot support (see snapshot.hpp); load() throws if the snapshot
+        // was taken under another policy or holds more calls than capacity().
+        void save(SnapshotWriter& out) const;
+        void load(SnapshotReader& in);
+
+    private:
+        friend class ElevatorFork;  // commits a chosen stop (take)
+
+        enum class Stage : std::uint8_t { pending, riding, done };
+        static constexpr std::size_t kWords = FE_MAX_FLOORS / 64;
+
+        SchedulePolicy policy;
+        OverflowPolicy on_full;
+        std::uint16_t limit;
+        std::uint16_t count = 0;                  // calls in [0, count), oldest first
+        std::uint16_t stop_count = 0;
+        Floor base = 0;                           // floor of bit 0
+        std::array<std::uint64_t, kWords> bits{}; // stop at floor base + i <=> bit i
+        std::array<Stage, FE_REQUEST_CAPACITY> stages{};
+        std::array<Call, FE_REQUEST_CAPACITY> held{};
+
+        template <typename F>
+        void for_each(Stage stage, F& f) const {
+            for (std::size_t i = 0; i < count; ++i) {
+                if (stages[i] == stage) {
+                    f(held[i]);
+                }
+            }
+        }
+        Admission admit(const Call& call, Stage stage, bool joins_stop);
+        void set_stop(Floor floor);
+        void take(Floor floor);
+        [[nodiscard]] bool has_above(Floor floor) const;  // a stop >= floor
+        [[nodiscard]] bool has_below(Floor floor) const;  // a stop <= floor
+        [[nodiscard]] Floor first_above(Floor floor) const;
+        [[nodiscard]] Floor first_below(Floor floor) const;
+        [[nodiscard]] long next_set(long index) const;   // first stop index >= index, or -1
+        [[nodiscard]] long prev_set(long index) const;   // last stop index <= index, or -1
+    };
+
+    std::ostream& operator<<(std::ostream& os, SchedulePolicy policy);
+    std::ostream& operator<<(std::ostream& os, OverflowPolicy overflow);
+}
+
+#endif
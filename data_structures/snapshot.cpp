@@ -0,0 +1,127 @@
+#include "snapshot.hpp"
+
+#include <fstream>
+
+namespace fe {
+
+namespace {
+    constexpr char kSnapshotMagic[8] = {'F', 'E', 'S', 'N', 'A', 'P', '\0', '\0'};
+
+    void put_name(std::vector<char>& bytes, const std::string& name) {
+        const auto n = static_cast<std::uint16_t>(name.size());
+        const auto* p = reinterpret_cast<const char*>(&n);
+        bytes.insert(bytes.end(), p, p + sizeof(n));
+        bytes.insert(bytes.end(), name.begin(), name.end());
+    }
+}
+
+void Snapshot::save(const std::string& path) const {
+    SnapshotHeader header {};
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.sections = sections;
+    header.time = time;
+    header.bytes = bytes.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!out) {
+        throw std::runtime_error("cannot write snapshot: " + path);
+    }
+}
+
+Snapshot Snapshot::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open snapshot: " + path);
+    }
+    SnapshotHeader header {};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0
+        || header.version != kSnapshotVersion) {
+        throw std::runtime_error("not a snapshot (or unsupported version): " + path);
+    }
+    Snapshot snapshot;
+    snapshot.time = header.time;
+    snapshot.sections = header.sections;
+    snapshot.bytes.resize(static_cast<std::size_t>(header.bytes));
+    if (!in.read(snapshot.bytes.data(), static_cast<std::streamsize>(snapshot.bytes.size()))) {
+        throw std::runtime_error("truncated snapshot: " + path);
+    }
+    return snapshot;
+}
+
+Checkpoint::Checkpoint(std::shared_ptr<const Snapshot> from, bool reseed)
+    : from(std::move(from)), reseed_sources(reseed) {}
+
+double Checkpoint::start_time() const {
+    if (!restoring()) {
+        return 0.0;
+    }
+    if (restored != from->sections) {
+        throw std::runtime_error("snapshot: the model restored " + std::to_string(restored) + " of "
+                                 + std::to_string(from->sections) + " saved atomics");
+    }
+    return from->time;
+}
+
+Snapshot Checkpoint::take(double now) const {
+    Snapshot snapshot;
+    snapshot.time = now;
+    snapshot.sections = static_cast<std::uint32_t>(entries.size());
+
+    SnapshotWriter payload;
+    for (const Entry& entry : entries) {
+        payload.bytes.clear();
+        entry.save(payload, now);
+
+        put_name(snapshot.bytes, entry.kind);
+        put_name(snapshot.bytes, entry.id);
+        const auto n = static_cast<std::uint32_t>(payload.bytes.size());
+        const auto* p = reinterpret_cast<const char*>(&n);
+        snapshot.bytes.insert(snapshot.bytes.end(), p, p + sizeof(n));
+        snapshot.bytes.insert(snapshot.bytes.end(), payload.bytes.begin(), payload.bytes.end());
+    }
+    return snapshot;
+}
+
+SnapshotReader Checkpoint::next_section(const char* kind, const std::string& id) {
+    const char* begin = from->bytes.data();
+    SnapshotReader in(begin + offset, begin + from->bytes.size());
+    if (restored == from->sections || in.done()) {
+        throw std::runtime_error("snapshot: no saved state for " + id);
+    }
+
+    auto get_name = [&in](std::string& name) {
+        std::uint16_t n = 0;
+        in.get(n);
+        std::vector<char> text(n);
+        for (char& c : text) {
+            in.get(c);
+        }
+        name.assign(text.begin(), text.end());
+    };
+    std::string saved_kind;
+    std::string saved_id;
+    std::uint32_t size = 0;
+    get_name(saved_kind);
+    get_name(saved_id);
+    in.get(size);
+    if (saved_kind != kind || saved_id != id) {
+        throw std::runtime_error("snapshot: expected " + std::string(kind) + " " + id + ", found "
+                                 + saved_kind + " " + saved_id);
+    }
+
+    // Header fields consumed: the payload starts here
+    const std::size_t header = sizeof(std::uint16_t) * 2 + saved_kind.size() + saved_id.size() + sizeof(size);
+    const char* payload = begin + offset + header;
+    if (size > from->bytes.size() - offset - header) {
+        throw std::runtime_error("snapshot: truncated section of " + id);
+    }
+    offset += header + size;
+    restored++;
+    return SnapshotReader(payload, payload + size);
+}
+
+}
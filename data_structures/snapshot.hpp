@@ -0,0 +1,231 @@
+#ifndef FE_SNAPSHOT_HPP
+#define FE_SNAPSHOT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fe {
+    /**
+     * Binary snapshot of a paused simulation (.fesnap), little-endian, native layout:
+     *   SnapshotHeader, then one section per checkpointed atomic, in model
+     *   construction order:
+     *     u16 kind length, kind, u16 id length, id, u32 payload size, payload
+     * The payload is whatever the atomic's save_state() wrote.
+     */
+    struct SnapshotHeader {
+        char magic[8];                 // "FESNAP\0\0"
+        std::uint32_t version;         // kSnapshotVersion
+        std::uint32_t sections;
+        double time;                   // simulation time the states were taken at
+        std::uint64_t bytes;           // size of the sections that follow
+    };
+
+    constexpr std::uint32_t kSnapshotVersion = 8;  // 8: monitor's open calls start at their lowest floor
+
+    // Appends plain values to a snapshot payload.
+    class SnapshotWriter {
+    public:
+        template <typename T>
+        void put(const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values are copied bytewise");
+            const auto* p = reinterpret_cast<const char*>(&value);
+            bytes.insert(bytes.end(), p, p + sizeof(T));
+        }
+
+        template <typename T>
+        void put(const std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values are copied bytewise");
+            put(static_cast<std::uint64_t>(values.size()));
+            const auto* p = reinterpret_cast<const char*>(values.data());
+            bytes.insert(bytes.end(), p, p + values.size() * sizeof(T));
+        }
+
+        void put(const std::string& text) {
+            put(static_cast<std::uint64_t>(text.size()));
+            bytes.insert(bytes.end(), text.begin(), text.end());
+        }
+
+        std::vector<char> bytes;
+    };
+
+    // Reads back what a SnapshotWriter wrote; throws std::runtime_error when
+    // the payload is shorter than expected.
+    class SnapshotReader {
+    public:
+        SnapshotReader(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+        template <typename T>
+        void get(T& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values are copied bytewise");
+            take(&value, sizeof(T));
+        }
+
+        template <typename T>
+        void get(std::vector<T>& values) {
+            static_assert(std::is_trivially_copyable_v<T>, "snapshot values are copied bytewise");
+            std::uint64_t n = 0;
+            get(n);
+            if (n > static_cast<std::uint64_t>(end - cursor) / sizeof(T)) {
+                throw std::runtime_error("snapshot: truncated section");
+            }
+            values.resize(static_cast<std::size_t>(n));
+            take(values.data(), values.size() * sizeof(T));
+        }
+
+        void get(std::string& text) {
+            std::uint64_t n = 0;
+            get(n);
+            if (n > static_cast<std::uint64_t>(end - cursor)) {
+                throw std::runtime_error("snapshot: truncated section");
+            }
+            text.assign(cursor, static_cast<std::size_t>(n));
+            cursor += n;
+        }
+
+        [[nodiscard]] bool done() const { return cursor == end; }
+
+    private:
+        void take(void* out, std::size_t n) {
+            if (n > static_cast<std::size_t>(end - cursor)) {
+                throw std::runtime_error("snapshot: truncated section");
+            }
+            if (n != 0) {
+                std::memcpy(out, cursor, n);
+            }
+            cursor += n;
+        }
+
+        const char* cursor;
+        const char* end;
+    };
+
+    // The states of one paused simulation, in memory or loaded from a .fesnap.
+    struct Snapshot {
+        double time = 0.0;           // simulation time the states were taken at
+        std::uint32_t sections = 0;
+        std::vector<char> bytes;     // sections, see SnapshotHeader
+
+        void save(const std::string& path) const;
+        static Snapshot load(const std::string& path);
+    };
+
+    /**
+     * Checkpoint (warm-up snapshots)
+     * - Passed to the constructors of a model's checkpointable atomics (ECall,
+     *   EControl, EVehicle, EFused, EDispatch, ETraffic, ETraceReader,
+     *   EMonitor), which register in construction order.
+     * - take(now), once RootCoordinator::simulate() has returned at 'now',
+     *   collects every registered state, with its time to the next internal
+     *   event re-based on 'now'. No event at 'now' has run yet, so no message
+     *   is in flight and the states alone describe the simulation.
+     * - A Checkpoint built from a snapshot hands each atomic its saved state
+     *   as its initial state instead; build the same model and start its
+     *   RootCoordinator at start_time(). Many runs can branch from one
+     *   snapshot, and 'reseed' gives each branch's ETraffic generators a
+     *   fresh RNG stream from their seed argument.
+     * - IEStream inputs cannot be saved: convert text inputs to a .fetrace
+     *   first (tools/trace_convert.cpp).
+     * The atomics' states must stay alive until take() returns.
+     */
+    class Checkpoint {
+    public:
+        Checkpoint() = default;
+        explicit Checkpoint(std::shared_ptr<const Snapshot> from, bool reseed = false);
+
+        [[nodiscard]] bool restoring() const { return from != nullptr; }
+        [[nodiscard]] bool reseed() const { return reseed_sources; }
+
+        // Start time for the restored run; throws if the model did not use
+        // every section of the snapshot (it is not the model it was taken from).
+        [[nodiscard]] double start_time() const;
+
+        [[nodiscard]] Snapshot take(double now) const;
+
+        // For the atomics' constructors (see restore_state / track_state)
+        template <typename S>
+        S restore(const char* kind, const std::string& id, S fresh);
+        template <typename S>
+        void track(const char* kind, const std::string& id, const S* const& live);
+
+    private:
+        struct Entry {
+            std::string kind;
+            std::string id;
+            std::function<void(SnapshotWriter&, double)> save;
+        };
+
+        SnapshotReader next_section(const char* kind, const std::string& id);
+
+        std::vector<Entry> entries;
+        std::shared_ptr<const Snapshot> from;
+        std::size_t offset = 0;        // read position in from->bytes
+        std::uint32_t restored = 0;    // sections handed out
+        bool reseed_sources = false;
+    };
+
+    // Time left until an internal event scheduled 'sigma' after 'clock', seen from 'now'.
+    inline double remaining(double sigma, double clock, double now) {
+        if (sigma == std::numeric_limits<double>::infinity()) {
+            return sigma;
+        }
+        const double left = sigma - (now - clock);
+        return left > 0.0 ? left : 0.0;
+    }
+
+    /**
+     * Initial state of an atomic: 'fresh', or the state saved for it when
+     * 'checkpoint' restores a snapshot. The atomic's state type provides
+     *   void load_state(fe::SnapshotReader&, S&);
+     */
+    template <typename S>
+    S restore_state(Checkpoint* checkpoint, const char* kind, const std::string& id, S fresh) {
+        return checkpoint != nullptr ? checkpoint->restore(kind, id, std::move(fresh)) : fresh;
+    }
+
+    /**
+     * Registers an atomic with 'checkpoint' (if any). 'live' is a member of
+     * the atomic that its timeAdvance() points at the current state; the
+     * state type provides
+     *   void save_state(fe::SnapshotWriter&, const S&, double now);
+     */
+    template <typename S>
+    void track_state(Checkpoint* checkpoint, const char* kind, const std::string& id, const S* const& live) {
+        if (checkpoint != nullptr) {
+            checkpoint->track(kind, id, live);
+        }
+    }
+
+    template <typename S>
+    S Checkpoint::restore(const char* kind, const std::string& id, S fresh) {
+        if (!restoring()) {
+            return fresh;
+        }
+        SnapshotReader in = next_section(kind, id);
+        load_state(in, fresh);
+        if (!in.done()) {
+            throw std::runtime_error("snapshot: section of " + id + " has trailing bytes");
+        }
+        return fresh;
+    }
+
+    template <typename S>
+    void Checkpoint::track(const char* kind, const std::string& id, const S* const& live) {
+        entries.push_back(Entry{kind, id, [&live, id](SnapshotWriter& out, double now) {
+            if (live == nullptr) {
+                throw std::runtime_error("snapshot: " + id + " has not been started");
+            }
+            save_state(out, *live, now);
+        }});
+    }
+}
+
+#endif
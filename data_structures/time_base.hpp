@@ -0,0 +1,76 @@
+#ifndef FE_TIME_BASE_HPP
+#define FE_TIME_BASE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ratio>
+
+namespace fe {
+    /**
+     * Time types the atomics can keep their clocks in (TimeBase<Time>).
+     * Cadmium's coordinators run on double minutes: an atomic templated on
+     * Time converts the elapsed time it is given to Time and its sigma back
+     * to minutes, and does all of its own arithmetic (sigma countdown,
+     * clocks, issue times) in Time.
+     * - double: minutes, as before (the default everywhere).
+     * - any std::chrono::duration with an integer count: elapsed times are
+     *   rounded to the nearest tick, so sigma and the clocks never drift.
+     *   The duration's max() stands for "never".
+     * Another time type (DESTimes' NDTime, for instance) plugs in with its
+     * own specialisation.
+     */
+    template <typename Time>
+    struct TimeBase;
+
+    template <>
+    struct TimeBase<double> {
+        static constexpr double zero() { return 0.0; }
+        static constexpr double infinity() { return std::numeric_limits<double>::infinity(); }
+        static constexpr double from_minutes(double minutes) { return minutes; }
+        static constexpr double to_minutes(double time) { return time; }
+    };
+
+    template <typename Rep, typename Period>
+    struct TimeBase<std::chrono::duration<Rep, Period>> {
+        using Time = std::chrono::duration<Rep, Period>;
+        using PerMinute = std::ratio_divide<std::ratio<60>, Period>;
+        static_assert(std::numeric_limits<Rep>::is_integer, "tick counts must be integers");
+        static_assert(PerMinute::den == 1, "a minute must be a whole number of ticks");
+
+        static constexpr Time zero() { return Time::zero(); }
+        static constexpr Time infinity() { return Time::max(); }
+        static Time from_minutes(double minutes) {
+            if (minutes == std::numeric_limits<double>::infinity()) {
+                return infinity();
+            }
+            // round half away from zero, as std::llround does, without its library call
+            const double ticks = minutes * static_cast<double>(PerMinute::num);
+            return Time(static_cast<Rep>(ticks < 0.0 ? ticks - 0.5 : ticks + 0.5));
+        }
+        static constexpr double to_minutes(Time time) {
+            return time == infinity() ? std::numeric_limits<double>::infinity()
+                                      : static_cast<double>(time.count()) / static_cast<double>(PerMinute::num);
+        }
+    };
+
+    /**
+     * Ticks of 1/65536 minute (~0.9 ms). A power-of-two fraction of a minute
+     * is exact in a double, and so is every sum of them below 2^53 ticks
+     * (over 200000 years): Cadmium's double clock then orders the events of
+     * tick-based atomics exactly, with no drift at any horizon.
+     */
+    using Ticks = std::chrono::duration<std::int64_t, std::ratio<60, 65536>::type>;  // 15/16384 s
+    using Millis = std::chrono::duration<std::int64_t, std::milli>;
+
+    // sigma less the elapsed time e, never below zero; "never" stays "never".
+    template <typename Time>
+    Time elapse(Time sigma, Time e) {
+        if (sigma == TimeBase<Time>::infinity()) {
+            return sigma;
+        }
+        return sigma > e ? Time(sigma - e) : TimeBase<Time>::zero();
+    }
+}
+
+#endif
@@ -0,0 +1,126 @@
+#include "traffic_profile.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace fe {
+
+namespace {
+    TrafficProfile single_phase(Floor top_floor, double rate, double up, double down, double inter) {
+        TrafficProfile p;
+        p.top_floor = top_floor;
+        p.phases.push_back(TrafficPhase{0.0, rate, up, down, inter});
+        return p;
+    }
+}
+
+TrafficProfile TrafficProfile::up_peak(Floor top_floor, double rate) {
+    return single_phase(top_floor, rate, 1.0, 0.0, 0.0);
+}
+
+TrafficProfile TrafficProfile::down_peak(Floor top_floor, double rate) {
+    return single_phase(top_floor, rate, 0.0, 1.0, 0.0);
+}
+
+TrafficProfile TrafficProfile::inter_floor(Floor top_floor, double rate) {
+    return single_phase(top_floor, rate, 0.0, 0.0, 1.0);
+}
+
+TrafficProfile TrafficProfile::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open traffic profile: " + path);
+    }
+
+    TrafficProfile p;
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key) || key[0] == '#') {
+            continue;
+        }
+        bool ok = false;
+        if (key == "floors") {
+            ok = static_cast<bool>(in >> p.lobby >> p.top_floor) && p.top_floor > p.lobby;
+        } else if (key == "phase") {
+            TrafficPhase ph;
+            ok = static_cast<bool>(in >> ph.start >> ph.rate >> ph.up >> ph.down >> ph.inter)
+                 && ph.rate >= 0.0 && ph.up >= 0.0 && ph.down >= 0.0 && ph.inter >= 0.0
+                 && ph.up + ph.down + ph.inter > 0.0;
+            if (ok) {
+                p.phases.push_back(ph);
+            }
+        }
+        if (!ok) {
+            throw std::runtime_error(path + ":" + std::to_string(line_no) + ": malformed line: " + line);
+        }
+    }
+    if (p.phases.empty()) {
+        throw std::runtime_error(path + ": no phases");
+    }
+    std::stable_sort(p.phases.begin(), p.phases.end(),
+                     [](const TrafficPhase& a, const TrafficPhase& b) { return a.start < b.start; });
+    return p;
+}
+
+std::size_t TrafficProfile::phase_at(double time) const {
+    std::size_t k = 0;
+    while (k + 1 < phases.size() && phases[k + 1].start <= time) {
+        ++k;
+    }
+    return k;
+}
+
+bool TrafficProfile::next_arrival(double& time, std::size_t& phase, Rng& rng) const {
+    // Unit-rate exponential mass still to be consumed by the intensity
+    double mass = rng.exponential();
+
+    while (phase < phases.size()) {
+        time = std::max(time, phases[phase].start);  // nothing arrives before the first phase
+        const double rate = phases[phase].rate;
+        const double end = phase + 1 < phases.size() ? phases[phase + 1].start
+                                                     : std::numeric_limits<double>::infinity();
+        if (rate > 0.0) {
+            const double t = time + mass / rate;
+            if (t < end) {
+                time = t;
+                return true;
+            }
+            mass -= rate * (end - time);
+        }
+        if (end == std::numeric_limits<double>::infinity()) {
+            break;
+        }
+        time = end;
+        ++phase;
+    }
+    return false;
+}
+
+Passenger TrafficProfile::draw(std::size_t phase, Rng& rng) const {
+    const TrafficPhase& ph = phases[phase];
+    const auto upper = static_cast<std::uint32_t>(top_floor - lobby);      // floors above the lobby
+    const auto all = static_cast<std::uint32_t>(top_floor - lobby + 1);
+
+    const double pick = rng.uniform() * (ph.up + ph.down + ph.inter);
+    if (pick < ph.up) {
+        return Passenger{lobby, lobby + 1 + static_cast<Floor>(rng.below(upper))};
+    }
+    if (pick < ph.up + ph.down) {
+        return Passenger{lobby + 1 + static_cast<Floor>(rng.below(upper)), lobby};
+    }
+    const Floor origin = lobby + static_cast<Floor>(rng.below(all));
+    Floor destination = lobby + static_cast<Floor>(rng.below(all - 1));
+    if (destination >= origin) {
+        ++destination;  // any floor but the origin
+    }
+    return Passenger{origin, destination};
+}
+
+}
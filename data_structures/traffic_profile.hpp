@@ -0,0 +1,74 @@
+#ifndef FE_TRAFFIC_PROFILE_HPP
+#define FE_TRAFFIC_PROFILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "messages.hpp"
+#include "rng.hpp"
+
+namespace fe {
+    /**
+     * One phase of a traffic profile, active from 'start' until the next
+     * phase starts (the last phase never ends). Passengers arrive as a
+     * Poisson process of 'rate' per minute; each one is drawn from the mix:
+     *  - up:    lobby -> uniform floor above the lobby
+     *  - down:  uniform floor above the lobby -> lobby
+     *  - inter: uniform floor -> another uniform floor
+     * The weights need not sum to 1; they are normalised.
+     */
+    struct TrafficPhase {
+        double start = 0.0;   // minutes
+        double rate = 0.0;    // passengers per minute
+        double up = 0.0;
+        double down = 0.0;
+        double inter = 1.0;
+    };
+
+    // One generated passenger: an outside call at 'origin' and an inside call for 'destination'.
+    struct Passenger {
+        Floor origin;
+        Floor destination;
+    };
+
+    /**
+     * Piecewise-constant arrival rate and floor mix over time, i.e. a
+     * non-homogeneous Poisson process with step intensity.
+     */
+    struct TrafficProfile {
+        Floor lobby = 1;
+        Floor top_floor = 10;
+        std::vector<TrafficPhase> phases;  // sorted by start
+
+        // Single-phase presets
+        static TrafficProfile up_peak(Floor top_floor, double rate);
+        static TrafficProfile down_peak(Floor top_floor, double rate);
+        static TrafficProfile inter_floor(Floor top_floor, double rate);
+
+        /**
+         * Reads a profile from a text file:
+         *   floors <lobby> <top_floor>
+         *   phase  <start_min> <rate_per_min> <up> <down> <inter>
+         * Blank lines and lines starting with '#' are ignored.
+         * Throws std::runtime_error on a malformed file.
+         */
+        static TrafficProfile load(const std::string& path);
+
+        /**
+         * Advances 'time' (currently in phase 'phase') to the next arrival.
+         * Inverts the cumulative intensity across phase boundaries, so rate
+         * changes are exact rather than approximated by thinning.
+         * Returns false if no further arrival can happen (all remaining rates are 0).
+         */
+        bool next_arrival(double& time, std::size_t& phase, Rng& rng) const;
+
+        // Draws origin and destination for a passenger arriving in 'phase'.
+        [[nodiscard]] Passenger draw(std::size_t phase, Rng& rng) const;
+
+        // Index of the phase active at 'time'
+        [[nodiscard]] std::size_t phase_at(double time) const;
+    };
+}
+
+#endif
@@ -0,0 +1,146 @@
+#include "vehicle_profile.hpp"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace fe {
+
+namespace {
+    // Time to reach 'peak' m/s from standstill (braking from it takes as long).
+    // The acceleration phase is symmetric, so it covers peak * time / 2 metres.
+    double ramp_seconds(const VehicleProfile& p, double peak) {
+        if (p.jerk <= 0.0) {
+            return peak / p.acceleration;
+        }
+        if (peak >= p.acceleration * p.acceleration / p.jerk) {
+            return peak / p.acceleration + p.acceleration / p.jerk;  // reaches full acceleration
+        }
+        return 2.0 * std::sqrt(peak / p.jerk);
+    }
+
+    std::size_t floor_count(const VehicleProfile& p) {
+        if (p.top <= p.lowest || p.storeys.size() != static_cast<std::size_t>(p.top - p.lowest)) {
+            throw std::invalid_argument("vehicle profile needs one storey height per floor below the top");
+        }
+        return static_cast<std::size_t>(p.top - p.lowest) + 1;
+    }
+}
+
+VehicleProfile VehicleProfile::uniform(Floor lowest, Floor top, double height) {
+    VehicleProfile p;
+    p.lowest = lowest;
+    p.top = top;
+    p.storeys.assign(static_cast<std::size_t>(top - lowest), height);
+    return p;
+}
+
+VehicleProfile VehicleProfile::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open vehicle profile: " + path);
+    }
+
+    VehicleProfile p;
+    double height = 4.0;
+    std::vector<std::pair<Floor, double>> overrides;
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key) || key[0] == '#') {
+            continue;
+        }
+        bool ok = false;
+        if (key == "floors") {
+            ok = static_cast<bool>(in >> p.lowest >> p.top) && p.top > p.lowest;
+        } else if (key == "speed") {
+            ok = static_cast<bool>(in >> p.speed) && p.speed > 0.0;
+        } else if (key == "acceleration") {
+            ok = static_cast<bool>(in >> p.acceleration) && p.acceleration > 0.0;
+        } else if (key == "jerk") {
+            ok = static_cast<bool>(in >> p.jerk) && p.jerk >= 0.0;
+        } else if (key == "door_dwell") {
+            ok = static_cast<bool>(in >> p.door_dwell) && p.door_dwell >= 0.0;
+        } else if (key == "storey") {
+            double first = 0.0;
+            double second = 0.0;
+            if (in >> first) {
+                if (in >> second) {
+                    ok = second > 0.0 && first == std::floor(first);
+                    overrides.emplace_back(static_cast<Floor>(first), second);
+                } else {
+                    ok = first > 0.0;
+                    height = first;
+                }
+            }
+        }
+        if (!ok) {
+            throw std::runtime_error(path + ":" + std::to_string(line_no) + ": malformed line: " + line);
+        }
+    }
+
+    p.storeys.assign(static_cast<std::size_t>(p.top - p.lowest), height);
+    for (const auto& [floor, metres] : overrides) {
+        if (floor < p.lowest || floor >= p.top) {
+            throw std::runtime_error(path + ": storey " + std::to_string(floor) + " is outside floors "
+                                     + std::to_string(p.lowest) + ".." + std::to_string(p.top));
+        }
+        p.storeys[static_cast<std::size_t>(floor - p.lowest)] = metres;
+    }
+    return p;
+}
+
+double VehicleProfile::motion_seconds(double distance) const {
+    if (distance <= 0.0) {
+        return 0.0;
+    }
+    // Accelerating to 'peak' and braking from it covers peak * ramp_seconds(peak)
+    const double ramp = ramp_seconds(*this, speed);
+    const double ramps_distance = speed * ramp;
+    if (distance >= ramps_distance) {
+        return 2.0 * ramp + (distance - ramps_distance) / speed;
+    }
+    // Short trip: the car never reaches rated speed; find the peak it does reach
+    double low = 0.0;
+    double high = speed;
+    for (int i = 0; i < 100; ++i) {
+        const double mid = 0.5 * (low + high);
+        if (mid * ramp_seconds(*this, mid) < distance) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return 2.0 * ramp_seconds(*this, 0.5 * (low + high));
+}
+
+TravelTable::TravelTable(const VehicleProfile& profile)
+    : lowest_floor(profile.lowest),
+      floors(floor_count(profile)),
+      minutes(floors * floors, 0.0),
+      dwell(profile.door_dwell / 60.0),
+      ramp(ramp_seconds(profile, profile.speed) / 60.0) {
+    std::vector<double> elevation(floors, 0.0);
+    for (std::size_t i = 1; i < floors; ++i) {
+        elevation[i] = elevation[i - 1] + profile.storeys[i - 1];
+    }
+    for (std::size_t i = 0; i < floors; ++i) {
+        for (std::size_t j = i + 1; j < floors; ++j) {
+            const double t = profile.motion_seconds(elevation[j] - elevation[i]) / 60.0;
+            minutes[i * floors + j] = t;
+            minutes[j * floors + i] = t;
+        }
+    }
+}
+
+void TravelTable::out_of_profile(Floor floor) const {
+    throw std::out_of_range("floor " + std::to_string(floor) + " is outside the vehicle profile ("
+                            + std::to_string(lowest()) + ".." + std::to_string(top()) + ")");
+}
+
+}
@@ -0,0 +1,99 @@
+#ifndef FE_VEHICLE_PROFILE_HPP
+#define FE_VEHICLE_PROFILE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "messages.hpp"
+
+namespace fe {
+    /**
+     * Kinematics of one car and the shaft it runs in (SI units).
+     * - A trip accelerates with a jerk-limited S-curve up to 'speed' (or the
+     *   highest speed the distance allows), cruises, and brakes symmetrically;
+     *   jerk 0 means no jerk limit (trapezoidal speed profile).
+     * - Every stop then holds the car for 'door_dwell' seconds (doors open,
+     *   load, doors close), zero-length trips included.
+     * - storeys[i] is the height from floor lowest + i to the floor above, so
+     *   floor heights need not be uniform.
+     */
+    struct VehicleProfile {
+        Floor lowest = 1;
+        Floor top = 10;
+        double speed = 1.0;         // m/s
+        double acceleration = 0.5;  // m/s^2
+        double jerk = 1.0;          // m/s^3 (0: unlimited)
+        double door_dwell = 20.0;   // s per stop
+        std::vector<double> storeys = std::vector<double>(9, 4.0);  // m
+
+        // Floors lowest..top, every storey 'height' metres
+        static VehicleProfile uniform(Floor lowest, Floor top, double height);
+
+        /**
+         * Reads a profile from a text file:
+         *   floors       <lowest> <top>
+         *   speed        <m/s>
+         *   acceleration <m/s^2>
+         *   jerk         <m/s^3>
+         *   door_dwell   <s>
+         *   storey       <m>           default floor-to-floor height
+         *   storey       <floor> <m>   height from <floor> to the floor above
+         * Unlisted keys keep the defaults above. Blank lines and lines
+         * starting with '#' are ignored. Throws std::runtime_error on a
+         * malformed file.
+         */
+        static VehicleProfile load(const std::string& path);
+
+        // Time to travel 'distance' metres from standstill to standstill (s).
+        [[nodiscard]] double motion_seconds(double distance) const;
+    };
+
+    /**
+     * Trip times between every pair of floors of a VehicleProfile, computed
+     * once so the controllers pay one array load per trip.
+     * - motion(): minutes from departure to standstill at the target floor.
+     * - door_dwell(): minutes the car then stays at the stop.
+     * - braking(): minutes of motion() spent braking to the target.
+     * Shared read-only by every car of a model (see fe::ControlConfig).
+     */
+    class TravelTable {
+    public:
+        // Throws std::invalid_argument if 'profile' does not give one storey height per floor below its top.
+        explicit TravelTable(const VehicleProfile& profile);
+
+        // Throws std::out_of_range if a floor is outside the profile.
+        [[nodiscard]] double motion(Floor from, Floor to) const {
+            const auto i = static_cast<std::size_t>(from - lowest_floor);
+            const auto j = static_cast<std::size_t>(to - lowest_floor);
+            if (i >= floors || j >= floors) {
+                out_of_profile(i >= floors ? from : to);
+            }
+            return minutes[i * floors + j];
+        }
+
+        [[nodiscard]] double door_dwell() const { return dwell; }
+
+        // A trip that reaches rated speed brakes from it; a shorter one
+        // brakes for the second half of its symmetric speed curve.
+        [[nodiscard]] double braking(Floor from, Floor to) const { return std::min(ramp, 0.5 * motion(from, to)); }
+
+        // motion() plus the door dwell at the target: departure to departure.
+        [[nodiscard]] double trip(Floor from, Floor to) const { return motion(from, to) + dwell; }
+
+        [[nodiscard]] Floor lowest() const { return lowest_floor; }
+        [[nodiscard]] Floor top() const { return lowest_floor + static_cast<Floor>(floors) - 1; }
+
+    private:
+        [[noreturn]] void out_of_profile(Floor floor) const;
+
+        Floor lowest_floor;
+        std::size_t floors;
+        std::vector<double> minutes;  // floors x floors, row = departure floor
+        double dwell;                 // minutes
+        double ramp;                  // minutes to brake from rated speed
+    };
+}
+
+#endif
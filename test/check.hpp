@@ -0,0 +1,26 @@
+#ifndef FE_TEST_CHECK_HPP
+#define FE_TEST_CHECK_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+// Checks shared by the test programs: a failure counter (each test exits
+// with status 1 if it is not 0), expect() and a relative comparison.
+
+inline int failures = 0;
+
+inline void expect(bool ok, const std::string& what) {
+  if (!ok) {
+    std::printf("FAIL %s\n", what.c_str());
+    ++failures;
+  }
+}
+
+// a and b equal to within 1e-9 relative to b (absolute below 1)
+inline bool near(double a, double b) {
+  return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+
+#endif
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "check.hpp"
+#include "../top_model/batch.hpp"
+#include "../top_model/site.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/rng.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// fe::ElevatorBatch against the Cadmium model: every instance of one batch
+// (traffic profiles x policies x seeds x vehicle profile, capacity and
+// en-route variants, plus call traces with calls and arrivals at the same
+// instants) must give the calls and served counts of its FreightTower under
+// a RootCoordinator, and its wait and trip means to rounding. A batch run
+// in three steps must match a single run exactly. Exit status 1 on any
+// difference.
+
+static fe::RunKpi reference(const fe::TowerSpec& spec, double horizon) {
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<FreightTower>(spec.name, spec, kpi);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  return *kpi;
+}
+
+static bool same(const fe::BatchKpi& batch, const fe::RunKpi& model, string& why) {
+  char line[200];
+  snprintf(line, sizeof(line), "calls %llu/%llu served %llu/%llu wait %.12g/%.12g trip %.12g/%.12g",
+           static_cast<unsigned long long>(batch.calls), static_cast<unsigned long long>(model.calls),
+           static_cast<unsigned long long>(batch.served), static_cast<unsigned long long>(model.served),
+           batch.wait.mean, model.wait.mean, batch.trip.mean, model.trip.mean);
+  why = line;
+  return batch.calls == model.calls && batch.served == model.served && batch.wait.n == model.wait.n &&
+         batch.trip.n == model.trip.n && near(batch.wait.mean, model.wait.mean) &&
+         near(batch.trip.mean, model.trip.mean) && near(batch.wait.stddev(), model.wait.stddev()) &&
+         near(batch.trip.stddev(), model.trip.stddev());
+}
+
+static bool identical(const fe::BatchKpi& a, const fe::BatchKpi& b) {
+  return a.calls == b.calls && a.served == b.served && a.wait.n == b.wait.n && a.wait.mean == b.wait.mean &&
+         a.wait.m2 == b.wait.m2 && a.trip.n == b.trip.n && a.trip.mean == b.trip.mean && a.trip.m2 == b.trip.m2;
+}
+
+// Calls at whole minutes on floors 1..10, several per instant at times
+// (written as text and converted, like tools/trace_convert)
+static shared_ptr<const fe::TraceFile> make_trace(const string& path, uint64_t seed, size_t count) {
+  fe::Rng rng(seed);
+  vector<pair<int, int>> inside;
+  vector<pair<int, int>> outside;
+  for (size_t k = 0; k < count; ++k) {
+    const int time = static_cast<int>(rng.below(400));
+    const int floor = 1 + static_cast<int>(rng.below(10));
+    (rng.below(2) ? inside : outside).emplace_back(time, floor);
+  }
+  sort(inside.begin(), inside.end());
+  sort(outside.begin(), outside.end());
+  const string inside_path = path + ".inside.txt";
+  const string outside_path = path + ".outside.txt";
+  ofstream in_file(inside_path);
+  for (const auto& c : inside) {
+    in_file << c.first << " " << c.second << "\n";
+  }
+  in_file.close();
+  ofstream out_file(outside_path);
+  for (const auto& c : outside) {
+    out_file << c.first << " " << c.second << "\n";
+  }
+  out_file.close();
+  fe::convert_text_trace(inside_path, outside_path, path);
+  return make_shared<const fe::TraceFile>(path);
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./batch_test [horizon_minutes]
+  const double horizon = (argc > 1) ? stod(argv[1]) : 600.0;
+
+  auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::load("../input_data/vehicle_freight.txt"));
+  const pair<const char*, fe::TrafficProfile> profiles[] = {
+    {"up", fe::TrafficProfile::up_peak(10, 0.15)},
+    {"down", fe::TrafficProfile::down_peak(10, 0.15)},
+    {"inter", fe::TrafficProfile::inter_floor(10, 0.2)},
+    {"day", fe::TrafficProfile::load("../input_data/traffic_day.txt")},
+  };
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  struct Variant {
+    const char* name;
+    bool profile;
+    size_t capacity;
+    fe::OverflowPolicy overflow;
+    bool en_route;
+  };
+  const Variant variants[] = {
+    {"linear", false, FE_REQUEST_CAPACITY, fe::OverflowPolicy::reject, false},
+    {"vehicle", true, FE_REQUEST_CAPACITY, fe::OverflowPolicy::reject, false},
+    {"cap4-reject", false, 4, fe::OverflowPolicy::reject, false},
+    {"cap4-coalesce", true, 4, fe::OverflowPolicy::coalesce, false},
+    {"cap4-drop", false, 4, fe::OverflowPolicy::drop, false},
+    {"en-route", false, FE_REQUEST_CAPACITY, fe::OverflowPolicy::reject, true},
+    {"en-route-vehicle", true, FE_REQUEST_CAPACITY, fe::OverflowPolicy::reject, true},
+  };
+
+  vector<fe::TowerSpec> towers;
+  auto add = [&](fe::TowerSpec spec, fe::SchedulePolicy policy, const Variant& v) {
+    spec.control.policy = policy;
+    spec.control.travel = v.profile ? travel : nullptr;
+    spec.control.request_capacity = v.capacity;
+    spec.control.overflow = v.overflow;
+    spec.control.en_route = v.en_route;
+    spec.name += string("/") + fe::to_string(policy) + "/" + v.name;
+    towers.push_back(std::move(spec));
+  };
+  for (const auto& profile : profiles) {
+    for (const auto policy : policies) {
+      for (const uint64_t seed : {1, 2}) {
+        for (const Variant& v : variants) {
+          fe::TowerSpec spec;
+          spec.name = string(profile.first) + "/" + to_string(seed);
+          spec.traffic = profile.second;
+          spec.seed = seed;
+          spec.control.bottom_floor = profile.second.lobby;
+          spec.control.top_floor = profile.second.top_floor;
+          add(std::move(spec), policy, v);
+        }
+      }
+    }
+  }
+  for (const uint64_t seed : {7, 8}) {
+    auto trace = make_trace("../simulation_results/batch_test_" + to_string(seed) + ".fetrace", seed, 300);
+    for (const auto policy : policies) {
+      for (const Variant& v : variants) {
+        fe::TowerSpec spec;
+        spec.name = "trace/" + to_string(seed);
+        spec.trace = trace;
+        spec.control.bottom_floor = 1;
+        spec.control.top_floor = 10;
+        add(std::move(spec), policy, v);
+      }
+    }
+  }
+
+  // 1) Every instance against its Cadmium model
+  fe::ElevatorBatch batch(towers);
+  batch.run(horizon);
+  uint64_t served = 0;
+  for (size_t i = 0; i < towers.size(); ++i) {
+    string why;
+    if (!same(batch.kpi(i), reference(towers[i], horizon), why)) {
+      printf("FAIL %s: %s\n", towers[i].name.c_str(), why.c_str());
+      ++failures;
+    }
+    served += batch.kpi(i).served;
+  }
+
+  // 2) The same batch in three steps
+  fe::ElevatorBatch steps(towers);
+  steps.run(horizon / 3.0);
+  steps.run(horizon / 2.0);
+  steps.run(horizon);
+  for (size_t i = 0; i < towers.size(); ++i) {
+    if (!identical(steps.kpi(i), batch.kpi(i))) {
+      printf("FAIL %s: a run in steps differs\n", towers[i].name.c_str());
+      ++failures;
+    }
+  }
+  if (steps.transitions() != batch.transitions()) {
+    printf("FAIL %llu transitions in steps vs %llu\n", static_cast<unsigned long long>(steps.transitions()),
+           static_cast<unsigned long long>(batch.transitions()));
+    ++failures;
+  }
+
+  printf("%s (%d failures); %zu instances, %llu calls served, %llu transitions\n",
+         failures ? "FAILED" : "passed", failures, towers.size(), static_cast<unsigned long long>(served),
+         static_cast<unsigned long long>(batch.transitions()));
+  return failures == 0 ? 0 : 1;
+}
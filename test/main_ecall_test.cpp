@@ -13,17 +13,17 @@ using namespace std;
 
 // Stand-alone experiment for the ECall atomic model.
 struct ECallExperiment : public Coupled {
-  Port<freight_elevator::Floor> out;
+  Port<fe::Call> out;
 
   ECallExperiment(const string& id,
                   const string& inside_calls_path,
                   const string& outside_calls_path)
       : Coupled(id) {
-    out = addOutPort<freight_elevator::Floor>("out");
+    out = addOutPort<fe::Call>("out");
 
-    auto inside_calls = addComponent<cadmium::lib::IEStream<freight_elevator::Floor>>(
+    auto inside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>(
         "inside_calls", inside_calls_path);
-    auto outside_calls = addComponent<cadmium::lib::IEStream<freight_elevator::Floor>>(
+    auto outside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>(
         "outside_calls", outside_calls_path);
 
     auto ecall = addComponent<ECall>("ecall");
@@ -49,13 +49,13 @@ int main(int argc, char* argv[]) {
   }
 
   auto model = make_shared<ECallExperiment>("ECallExperiment", inside_path, outside_path);
-  auto logger = make_shared<cadmium::core::logger::CSVLogger>(
-      "../simulation_results/ecall_test.csv", ";");
 
-  cadmium::core::simulation::RootCoordinator root(model, logger);
-  root.setTime(50);
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/ecall_test.csv", ";");
+  root.setLogger(logger);
+
   root.start();
-  root.simulate();
+  root.simulate(50.0);
   root.stop();
 
   return 0;
@@ -13,19 +13,21 @@ using namespace std;
 
 // Stand-alone experiment for the EControl atomic model.
 struct EControlExperiment : public Coupled {
-  Port<freight_elevator::TravelTime> timem_out;
-  Port<freight_elevator::Floor> floor_out;
+  Port<fe::TravelTime> timem_out;
+  Port<fe::Floor> floor_out;
+  Port<fe::Call> served_out;
 
   EControlExperiment(const string& id,
                      const string& calls_path,
                      const string& fback_path)
       : Coupled(id) {
-    timem_out = addOutPort<freight_elevator::TravelTime>("timem_out");
-    floor_out = addOutPort<freight_elevator::Floor>("floor_out");
+    timem_out = addOutPort<fe::TravelTime>("timem_out");
+    floor_out = addOutPort<fe::Floor>("floor_out");
+    served_out = addOutPort<fe::Call>("served_out");
 
-    auto calls = addComponent<cadmium::lib::IEStream<freight_elevator::Floor>>(
+    auto calls = addComponent<cadmium::lib::IEStream<fe::Call>>(
         "acall_stream", calls_path);
-    auto fback = addComponent<cadmium::lib::IEStream<int>>(
+    auto fback = addComponent<cadmium::lib::IEStream<fe::TravelTime>>(
         "fback_stream", fback_path);
 
     auto ctrl = addComponent<EControl>("econtrol");
@@ -37,6 +39,7 @@ struct EControlExperiment : public Coupled {
     // Outputs
     addCoupling(ctrl->timem, timem_out);
     addCoupling(ctrl->floor, floor_out);
+    addCoupling(ctrl->served, served_out);
   }
 };
 
@@ -52,13 +55,13 @@ int main(int argc, char* argv[]) {
   }
 
   auto model = make_shared<EControlExperiment>("EControlExperiment", calls_path, fback_path);
-  auto logger = make_shared<cadmium::core::logger::CSVLogger>(
-      "../simulation_results/econtrol_test.csv", ";");
 
-  cadmium::core::simulation::RootCoordinator root(model, logger);
-  root.setTime(50);
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/econtrol_test.csv", ";");
+  root.setLogger(logger);
+
   root.start();
-  root.simulate();
+  root.simulate(50.0);
   root.stop();
 
   return 0;
@@ -0,0 +1,189 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/logger/csv.hpp"
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "recorder.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Equivalence suite for the EFused atomic: every case runs the coupled model
+// and the fused one on the same input and compares the reached floors and the
+// served requests (value, call id and time, in output order). Exit status 1
+// on any difference. Times are compared to within near(): EFused re-derives
+// its time to arrival after every call, the coupled EVehicle keeps its own
+// timer.
+
+// Outputs of Experiment(args...) from 0 to 'horizon'; adds the wall time to 'wall'
+template <typename Experiment, typename... Args>
+static Records run(double horizon, double& wall, Args&&... args) {
+  auto t0 = chrono::steady_clock::now();
+  Records records = record<Experiment>("efused_test", horizon, std::forward<Args>(args)...);
+  wall += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  return records;
+}
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string inside_path = "../input_data/efused_inside_test.txt";
+  string outside_path = "../input_data/efused_outside_test.txt";
+
+  // Optional CLI: ./efused_test <inside_calls> <outside_calls>
+  if (argc >= 3) {
+    inside_path = argv[1];
+    outside_path = argv[2];
+  }
+
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  int cases = 0;
+  double coupled_wall = 0.0;
+  double fused_wall = 0.0;
+  size_t outputs = 0;
+  size_t served = 0;
+
+  auto check = [&](const string& name, const Records& coupled, const Records& fused) {
+    string why;
+    const bool ok = same("floor", "coupled", coupled.floors, "fused", fused.floors, why) &&
+                    same("served", "coupled", coupled.served, "fused", fused.served, why);
+    ++cases;
+    failures += !ok;
+    outputs += coupled.floors.size();
+    served += coupled.served.size();
+    if (!ok) {
+      printf("FAIL %-36s %s\n", name.c_str(), why.c_str());
+    }
+  };
+
+  // 1) Input files: simultaneous, duplicate and current-floor calls
+  for (auto policy : policies) {
+    fe::ControlConfig config;
+    config.policy = policy;
+    config.top_floor = 8;
+    double wall = 0.0;
+    auto coupled = run<FreightElevatorExperiment>(100.0, wall, inside_path, outside_path, config,
+                                                  nullptr, false);
+    auto fused = run<FreightElevatorExperiment>(100.0, wall, inside_path, outside_path, config,
+                                                nullptr, true);
+    check(string("files/") + fe::to_string(policy), coupled, fused);
+  }
+
+  // 2) Seeded traffic, single car: every pattern, policy and a few seeds
+  struct Load {
+    const char* pattern;
+    fe::TrafficProfile profile;
+    double horizon;
+  };
+  const Load loads[] = {
+    {"up", fe::TrafficProfile::up_peak(10, 0.08), 5000.0},
+    {"down", fe::TrafficProfile::down_peak(10, 0.08), 5000.0},
+    {"inter", fe::TrafficProfile::inter_floor(10, 0.5), 1000.0},
+    {"tall", fe::TrafficProfile::inter_floor(200, 0.05), 2000.0},
+  };
+  for (const Load& load : loads) {
+    for (auto policy : policies) {
+      const auto config = make_config(policy, load.profile);
+      for (uint64_t seed = 1; seed <= 5; ++seed) {
+        auto coupled = run<FreightElevatorTrafficExperiment>(load.horizon, coupled_wall, load.profile,
+                                                             seed, config, nullptr, false);
+        auto fused = run<FreightElevatorTrafficExperiment>(load.horizon, fused_wall, load.profile,
+                                                           seed, config, nullptr, true);
+        check(string("traffic/") + load.pattern + "/" + fe::to_string(policy) + "/" + to_string(seed),
+              coupled, fused);
+      }
+    }
+  }
+
+  // 3) Elevator bank: ElevatorCoupled cars vs EFused cars
+  const auto bank_profile = fe::TrafficProfile::up_peak(20, 0.3);
+  for (size_t cars = 1; cars <= 4; ++cars) {
+    for (auto policy : policies) {
+      const auto config = make_config(policy, bank_profile);
+      double wall = 0.0;
+      auto coupled = run<ElevatorBankTrafficExperiment>(2000.0, wall, cars, bank_profile, 7, config,
+                                                        nullptr, false);
+      auto fused = run<ElevatorBankTrafficExperiment>(2000.0, wall, cars, bank_profile, 7, config,
+                                                      nullptr, true);
+      check("bank/" + to_string(cars) + "/" + fe::to_string(policy), coupled, fused);
+    }
+  }
+
+  // 4) Vehicle profile: fractional trip times and door dwell (zero-length trips take time)
+  const auto vehicle_profile = fe::TrafficProfile::inter_floor(20, 0.4);
+  const auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, 20, 3.5));
+  for (auto policy : policies) {
+    auto config = make_config(policy, vehicle_profile);
+    config.travel = travel;
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+      auto coupled = run<FreightElevatorTrafficExperiment>(1000.0, coupled_wall, vehicle_profile, seed, config,
+                                                           nullptr, false);
+      auto fused = run<FreightElevatorTrafficExperiment>(1000.0, fused_wall, vehicle_profile, seed, config,
+                                                         nullptr, true);
+      check(string("vehicle/") + fe::to_string(policy) + "/" + to_string(seed), coupled, fused);
+    }
+    double wall = 0.0;
+    auto coupled = run<ElevatorBankTrafficExperiment>(1000.0, wall, 3, vehicle_profile, 7, config, nullptr, false);
+    auto fused = run<ElevatorBankTrafficExperiment>(1000.0, wall, 3, vehicle_profile, 7, config, nullptr, true);
+    check(string("vehicle/bank/") + fe::to_string(policy), coupled, fused);
+  }
+
+  // 5) En-route stops: trips cut short at the linear and the S-curve braking point
+  for (const Load& load : loads) {
+    for (auto policy : policies) {
+      auto config = make_config(policy, load.profile);
+      config.en_route = true;
+      for (uint64_t seed = 1; seed <= 3; ++seed) {
+        double wall = 0.0;
+        auto coupled = run<FreightElevatorTrafficExperiment>(load.horizon, wall, load.profile, seed, config,
+                                                             nullptr, false);
+        auto fused = run<FreightElevatorTrafficExperiment>(load.horizon, wall, load.profile, seed, config,
+                                                           nullptr, true);
+        check(string("en_route/") + load.pattern + "/" + fe::to_string(policy) + "/" + to_string(seed),
+              coupled, fused);
+      }
+    }
+  }
+  for (auto policy : policies) {
+    auto config = make_config(policy, vehicle_profile);
+    config.travel = travel;
+    config.en_route = true;
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+      double wall = 0.0;
+      auto coupled = run<FreightElevatorTrafficExperiment>(1000.0, wall, vehicle_profile, seed, config, nullptr,
+                                                           false);
+      auto fused = run<FreightElevatorTrafficExperiment>(1000.0, wall, vehicle_profile, seed, config, nullptr,
+                                                         true);
+      check(string("en_route/vehicle/") + fe::to_string(policy) + "/" + to_string(seed), coupled, fused);
+    }
+    double wall = 0.0;
+    auto coupled = run<ElevatorBankTrafficExperiment>(1000.0, wall, 3, vehicle_profile, 7, config, nullptr, false);
+    auto fused = run<ElevatorBankTrafficExperiment>(1000.0, wall, 3, vehicle_profile, 7, config, nullptr, true);
+    check(string("en_route/bank/") + fe::to_string(policy), coupled, fused);
+  }
+
+  // CSV log of the fused model on the input files, for inspection
+  auto model = make_shared<FreightElevatorExperiment>("EFusedExperiment", inside_path, outside_path,
+                                                      fe::ControlConfig(), nullptr, true);
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/efused_test.csv", ";");
+  root.setLogger(logger);
+  root.start();
+  root.simulate(100.0);
+  root.stop();
+
+  printf("%d/%d cases identical (%zu floor outputs, %zu served requests); "
+         "single-car traffic runs: coupled %.3f s, fused %.3f s (%.1fx)\n",
+         cases - failures, cases, outputs, served, coupled_wall, fused_wall, coupled_wall / fused_wall);
+  return failures == 0 ? 0 : 1;
+}
@@ -13,19 +13,22 @@ using namespace std;
 
 // Integration experiment for the ElevatorCoupled (EControl + EVehicle).
 struct ElevatorExperiment : public Coupled {
-  Port<freight_elevator::Floor> floor_out;
+  Port<fe::Floor> floor_out;
+  Port<fe::Call> served_out;
 
   ElevatorExperiment(const string& id, const string& calls_path) : Coupled(id) {
-    floor_out = addOutPort<freight_elevator::Floor>("floor_out");
+    floor_out = addOutPort<fe::Floor>("floor_out");
+    served_out = addOutPort<fe::Call>("served_out");
 
-    auto calls = addComponent<cadmium::lib::IEStream<freight_elevator::Floor>>(
+    auto calls = addComponent<cadmium::lib::IEStream<fe::Call>>(
         "calls_stream", calls_path);
 
     auto elevator = addComponent<ElevatorCoupled>("elevator");
 
     // Input and output couplings
-    addCoupling(calls->out, elevator->call_in);
-    addCoupling(elevator->floor_out, floor_out);
+    addCoupling(calls->out, elevator->acall);
+    addCoupling(elevator->floor, floor_out);
+    addCoupling(elevator->served, served_out);
   }
 };
 
@@ -39,13 +42,13 @@ int main(int argc, char* argv[]) {
   }
 
   auto model = make_shared<ElevatorExperiment>("ElevatorExperiment", calls_path);
-  auto logger = make_shared<cadmium::core::logger::CSVLogger>(
-      "../simulation_results/elevator_test.csv", ";");
 
-  cadmium::core::simulation::RootCoordinator root(model, logger);
-  root.setTime(50);
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/elevator_test.csv", ";");
+  root.setLogger(logger);
+
   root.start();
-  root.simulate();
+  root.simulate(50.0);
   root.stop();
 
   return 0;
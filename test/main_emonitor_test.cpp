@@ -0,0 +1,107 @@
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "cadmium/core/logger/csv.hpp"
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/lib/iestream.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "check.hpp"
+#include "../atomics/emonitor.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/messages.hpp"
+
+using namespace std;
+
+// Stand-alone experiment for the EMonitor atomic model: calls and served
+// requests come from three input files; the KPI summary is printed, then
+// checked against the latencies and queue depths of the default input.
+// Exit status 1 on any failure.
+struct EMonitorExperiment : public Coupled {
+  EMonitorExperiment(const string& id, const string& outside_file, const string& inside_file,
+                     const string& served_file, shared_ptr<fe::RunKpi> kpi)
+      : Coupled(id) {
+    auto outside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("outside_calls", outside_file);
+    auto inside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("inside_calls", inside_file);
+    auto served = addComponent<cadmium::lib::IEStream<fe::Call>>("served", served_file);
+    auto monitor = addComponent<EMonitor>("emonitor", std::move(kpi));
+
+    // Inputs
+    addCoupling(outside_calls->out, monitor->outside_call);
+    addCoupling(inside_calls->out, monitor->inside_call);
+    addCoupling(served->out, monitor->served);
+  }
+};
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string outside_path = "../input_data/emonitor_outside_test.txt";
+  string inside_path = "../input_data/emonitor_inside_test.txt";
+  string served_path = "../input_data/emonitor_served_test.txt";
+
+  // Optional CLI: ./emonitor_test <outside_calls> <inside_calls> <served>
+  if (argc >= 4) {
+    outside_path = argv[1];
+    inside_path = argv[2];
+    served_path = argv[3];
+  }
+
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<EMonitorExperiment>("EMonitorExperiment", outside_path, inside_path, served_path, kpi);
+
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/emonitor_test.csv", ";");
+  root.setLogger(logger);
+
+  root.start();
+  root.simulate(50.0);
+  root.stop();
+
+  fe::write_summary(cout, *kpi);
+  if (argc >= 4) {
+    return 0;  // the expected values below hold for the default input only
+  }
+
+  // Waits 2,1,5,5 (floors 3,3,5,2), trips 5,4,7 (floors 6,4,1)
+  expect(kpi->calls == 7 && kpi->served == 7 && kpi->rejected == 0, "7 calls, all served");
+  expect(near(kpi->last_time, 12.0), "last event at 12");
+  expect(kpi->wait.n == 4 && near(kpi->wait.mean, 3.25), "4 waits, mean 3.25");
+  expect(kpi->trip.n == 3 && near(kpi->trip.mean, 16.0 / 3.0), "3 trips, mean 16/3");
+  expect(kpi->overall.wait.count() == 4 && kpi->overall.wait.max() == 5.0, "all floors: longest wait 5");
+
+  // Per floor, from floor 1 (the lowest seen) up
+  expect(kpi->first_floor == 1 && kpi->floors.size() == 6, "floors 1 to 6");
+  const fe::FloorKpi& third = kpi->floor(3);
+  expect(third.wait.count() == 2 && third.trip.count() == 0, "floor 3: 2 waits");
+  // histogram percentiles are bucket middles, at most ~0.8% off
+  expect(fabs(third.wait.quantile(0.5) - 1.0) <= 0.01, "floor 3: p50 wait 1");
+  expect(fabs(third.wait.quantile(0.99) - 2.0) <= 0.02, "floor 3: p99 wait 2");
+  expect(kpi->floor(2).wait.count() == 1 && kpi->floor(2).wait.max() == 5.0, "floor 2: wait 5");
+  expect(kpi->floor(1).trip.max() == 7.0 && kpi->floor(4).trip.max() == 4.0 && kpi->floor(6).trip.max() == 5.0,
+         "trips 7, 4, 5 to floors 1, 4, 6");
+
+  // Queue depth: floor 3 saw 0 then 1 calls open; the building at most 4
+  // (the sixth call, at t=6, found #3, #4, #5 and #6 still open)
+  expect(third.queue.count() == 2 && third.queue.max() == 1.0, "floor 3: queue 0 then 1");
+  expect(kpi->overall.queue.count() == 7 && kpi->overall.queue.max() == 4.0, "building queue at most 4");
+
+  // Floors below 0 and far above 0 get their own rows, and only the
+  // floors seen are allocated
+  fe::RunKpi tower;
+  tower.floor(510).wait.add(1.0);
+  tower.floor(500).wait.add(2.0);
+  expect(tower.first_floor == 500 && tower.floors.size() == 11 && tower.floor(510).wait.max() == 1.0,
+         "floors 500-510: 11 rows");
+  fe::RunKpi basement;
+  basement.floor(1).trip.add(3.0);
+  basement.floor(-2).wait.add(4.0);
+  expect(basement.first_floor == -2 && basement.floors.size() == 4 && basement.floors[0].wait.max() == 4.0 &&
+         basement.floor(1).trip.max() == 3.0 && basement.floor(0).wait.count() == 0,
+         "floors -2 to 1: floor -2 not merged into 0");
+
+  printf("%s (%d failures)\n", failures ? "FAILED" : "passed", failures);
+  return failures == 0 ? 0 : 1;
+}
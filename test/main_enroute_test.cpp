@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/lib/iestream.hpp"
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "check.hpp"
+#include "../atomics/evehicle.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Checks for en-route stops (fe::ControlConfig::en_route): the braking
+// point of fe::TravelTable, fe::can_stop_en_route at its boundaries,
+// PendingRequests::divert, an interruptible EVehicle on its own, and the
+// coupled and fused models picking up a call on the way, at 1 minute per
+// floor and with an S-curve profile. Exit status 1 on any failure.
+
+// -------------------- Vehicle recorder --------------------
+
+struct Arrival {
+  double time;
+  fe::TravelTime travel;
+};
+
+struct ArrivalRecorderState {
+  double clock = 0.0;
+};
+
+inline ostream& operator<<(ostream& os, const ArrivalRecorderState& s) {
+  return os << "{clock:" << s.clock << "}";
+}
+
+class ArrivalRecorder : public cadmium::Atomic<ArrivalRecorderState> {
+ public:
+  cadmium::Port<fe::TravelTime> in;
+
+  ArrivalRecorder(const string& id, shared_ptr<vector<Arrival>> arrivals)
+      : cadmium::Atomic<ArrivalRecorderState>(id, ArrivalRecorderState()), arrivals(std::move(arrivals)) {
+    in = addInPort<fe::TravelTime>("in");
+  }
+
+  void internalTransition(ArrivalRecorderState& /*s*/) const override {}
+  void externalTransition(ArrivalRecorderState& s, double e) const override {
+    s.clock += e;
+    for (const auto& t : in->getBag()) {
+      arrivals->push_back(Arrival{s.clock, t});
+    }
+  }
+  void output(const ArrivalRecorderState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const ArrivalRecorderState& /*s*/) const override {
+    return numeric_limits<double>::infinity();
+  }
+
+ private:
+  shared_ptr<vector<Arrival>> arrivals;
+};
+
+struct VehicleExperiment : public Coupled {
+  VehicleExperiment(const string& id, const string& commands, bool interruptible,
+                    shared_ptr<vector<Arrival>> arrivals)
+      : Coupled(id) {
+    auto stream = addComponent<cadmium::lib::IEStream<fe::TravelTime>>("commands", commands);
+    auto vehicle = addComponent<EVehicle>("evehicle", nullptr, interruptible);
+    auto recorder = addComponent<ArrivalRecorder>("recorder", std::move(arrivals));
+    addCoupling(stream->out, vehicle->in);
+    addCoupling(vehicle->out, recorder->in);
+  }
+};
+
+static vector<Arrival> drive(const string& commands, bool interruptible) {
+  const string path = "../simulation_results/enroute_test_commands.txt";
+  ofstream(path) << commands;
+  auto arrivals = make_shared<vector<Arrival>>();
+  auto model = make_shared<VehicleExperiment>("enroute_vehicle", path, interruptible, arrivals);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(50.0);
+  root.stop();
+  return *arrivals;
+}
+
+// An inside call for 'destination' at t = 0 and an outside call at 'floor'
+// at t = 'issued', the car starting idle at floor 1
+static fe::RunKpi run(fe::Floor destination, fe::Floor floor, double issued, const fe::ControlConfig& config,
+                      bool fused) {
+  const string inside = "../simulation_results/enroute_test_inside.txt";
+  const string outside = "../simulation_results/enroute_test_outside.txt";
+  ofstream(inside) << "0 " << destination << "\n";
+  ofstream out(outside);
+  out.precision(17);
+  out << issued << " " << floor << "\n";
+  out.close();
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<FreightElevatorExperiment>("enroute_test", inside, outside, config, kpi, fused);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(100.0);
+  root.stop();
+  return *kpi;
+}
+
+int main() {
+  // 1) Braking point: a trip that reaches rated speed brakes for the ramp,
+  //    a short one for the second half of its motion
+  fe::VehicleProfile p = fe::VehicleProfile::uniform(1, 10, 4.0);
+  p.speed = 2.5;
+  p.acceleration = 0.6;
+  p.jerk = 0.9;
+  const fe::TravelTable table(p);
+  // rated speed after 2.5/0.6 + 0.6/0.9 s, about 12 m: more than a storey
+  const double ramp = (2.5 / 0.6 + 0.6 / 0.9) / 60.0;
+  expect(near(table.braking(1, 10), ramp), "long trip brakes from rated speed");
+  expect(near(table.braking(10, 1), ramp), "braking is symmetric");
+  const double hop = table.motion(1, 2);
+  expect(hop < 2.0 * ramp && near(table.braking(1, 2), 0.5 * hop), "short hop brakes for half its motion");
+  expect(table.braking(3, 3) == 0.0, "no trip, no braking");
+
+  // 2) Where a moving car can still stop
+  fe::ControlConfig linear;
+  linear.top_floor = 10;
+  expect(fe::can_stop_en_route(linear, 1, 10, 4, 0.0), "linear: at departure");
+  expect(fe::can_stop_en_route(linear, 1, 10, 4, 2.999), "linear: just before the floor");
+  expect(!fe::can_stop_en_route(linear, 1, 10, 4, 3.0), "linear: at the floor");
+  expect(!fe::can_stop_en_route(linear, 1, 10, 1, 0.0), "linear: origin is not on the way");
+  expect(!fe::can_stop_en_route(linear, 1, 10, 10, 0.0), "linear: target is not on the way");
+  expect(!fe::can_stop_en_route(linear, 1, 10, 11, 0.0), "linear: beyond the target");
+  expect(fe::can_stop_en_route(linear, 10, 1, 6, 3.5), "linear: going down");
+  expect(!fe::can_stop_en_route(linear, 10, 1, 6, 4.0), "linear: going down, passed");
+  fe::ControlConfig profiled = linear;
+  profiled.travel = make_shared<const fe::TravelTable>(p);
+  const double braking_point = table.motion(1, 4) - table.braking(1, 4);
+  expect(fe::can_stop_en_route(profiled, 1, 10, 4, 0.999 * braking_point), "profile: before the braking point");
+  expect(!fe::can_stop_en_route(profiled, 1, 10, 4, braking_point), "profile: at the braking point");
+
+  // 3) Diverting the trip in progress
+  {
+    fe::PendingRequests requests(fe::SchedulePolicy::fifo);
+    requests.push(fe::Call{1, 0.0, 10, fe::CallSource::inside});
+    fe::Direction direction = fe::Direction::idle;
+    expect(requests.pop_next(1, direction, linear) == 10, "divert: trip to 10");
+    requests.push(fe::Call{2, 1.0, 4, fe::CallSource::outside});
+    requests.divert(10, 4);
+    vector<uint64_t> riding;
+    requests.for_each_riding([&](const fe::Call& c) { riding.push_back(c.id); });
+    expect(riding == vector<uint64_t>{2}, "divert: the call on the way rides");
+    expect(requests.pending(10) && !requests.pending(4), "divert: the old stop waits again");
+    requests.arrive();
+    vector<uint64_t> done;
+    requests.for_each_done([&](const fe::Call& c) { done.push_back(c.id); });
+    expect(done == vector<uint64_t>{2}, "divert: arriving serves the call on the way only");
+    requests.clear_done();
+    expect(requests.pop_next(4, direction, linear) == 10, "divert: then on to 10");
+  }
+
+  // 4) EVehicle: a shorter command retargets a moving car, a longer one does not
+  {
+    auto a = drive("0 5\n1 2\n", true);
+    expect(a.size() == 1 && near(a[0].time, 2.0) && a[0].travel == 2, "interruptible: stops after 2 minutes");
+    a = drive("0 5\n1 7\n", true);
+    expect(a.size() == 1 && near(a[0].time, 5.0) && a[0].travel == 5, "interruptible: longer command ignored");
+    a = drive("0 5\n1 2\n", false);
+    expect(a.size() == 1 && near(a[0].time, 5.0) && a[0].travel == 5, "plain: every command ignored");
+  }
+
+  // 5) Through the models: on its way 1 -> 10 the car stops at 4 for a call
+  //    made before it gets there, and not for one made once it is there
+  for (const bool fused : {false, true}) {
+    const string model = fused ? "fused: " : "coupled: ";
+    fe::ControlConfig config = linear;
+    config.en_route = true;
+    fe::RunKpi kpi = run(10, 4, 1.0, config, fused);
+    expect(kpi.served == 2 && near(kpi.wait.mean, 2.0) && near(kpi.trip.mean, 9.0), model + "linear, stops at 4");
+    kpi = run(10, 4, 3.0, config, fused);
+    expect(kpi.served == 2 && near(kpi.wait.mean, 12.0) && near(kpi.trip.mean, 9.0), model + "linear, passed 4");
+    config.en_route = false;
+    kpi = run(10, 4, 1.0, config, fused);
+    expect(kpi.served == 2 && near(kpi.wait.mean, 14.0) && near(kpi.trip.mean, 9.0), model + "linear, off");
+
+    // with the profile the stop costs its door dwell and a second departure
+    config = profiled;
+    config.en_route = true;
+    const double early = 0.5 * braking_point;
+    kpi = run(10, 4, early, config, fused);
+    expect(kpi.served == 2 && near(kpi.wait.mean, table.trip(1, 4) - early) &&
+           near(kpi.trip.mean, table.trip(1, 4) + table.trip(4, 10)), model + "profile, stops at 4");
+    const double late = 1.001 * braking_point;
+    kpi = run(10, 4, late, config, fused);
+    expect(kpi.served == 2 && near(kpi.wait.mean, table.trip(1, 10) + table.trip(10, 4) - late) &&
+           near(kpi.trip.mean, table.trip(1, 10)), model + "profile, past the braking point");
+  }
+
+  printf("%s (%d failures); braking point 1 -> 4 at %.4f of %.4f min\n", failures ? "FAILED" : "passed",
+         failures, braking_point, table.motion(1, 4));
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/logger/csv.hpp"
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "check.hpp"
+#include "../atomics/etraffic.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Stand-alone experiment for the ETraffic atomic model, then checks of the
+// calls it output: one car call and one hall call per passenger at the same
+// time, floors and directions following the mix of each phase (the test
+// profile has up-peak, down-peak, then no traffic), calls left unstamped for
+// ECall, and the same sequence from the same seed. Exit status 1 on any failure.
+
+// -------------------- Call recorder --------------------
+
+struct TimedCall {
+  double time;  // output time
+  fe::Call call;
+};
+
+struct Calls {
+  vector<TimedCall> inside;
+  vector<TimedCall> outside;
+};
+
+struct CallRecorderState {
+  double clock = 0.0;
+};
+
+inline ostream& operator<<(ostream& os, const CallRecorderState& s) {
+  return os << "{clock:" << s.clock << "}";
+}
+
+class CallRecorder : public cadmium::Atomic<CallRecorderState> {
+ public:
+  cadmium::Port<fe::Call> inside;
+  cadmium::Port<fe::Call> outside;
+
+  CallRecorder(const string& id, shared_ptr<Calls> calls)
+      : cadmium::Atomic<CallRecorderState>(id, CallRecorderState()), calls(std::move(calls)) {
+    inside = addInPort<fe::Call>("inside");
+    outside = addInPort<fe::Call>("outside");
+  }
+
+  void internalTransition(CallRecorderState& /*s*/) const override {}
+  void externalTransition(CallRecorderState& s, double e) const override {
+    s.clock += e;
+    for (const auto& c : inside->getBag()) {
+      calls->inside.push_back(TimedCall{s.clock, c});
+    }
+    for (const auto& c : outside->getBag()) {
+      calls->outside.push_back(TimedCall{s.clock, c});
+    }
+  }
+  void output(const CallRecorderState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const CallRecorderState& /*s*/) const override {
+    return numeric_limits<double>::infinity();
+  }
+
+ private:
+  shared_ptr<Calls> calls;  // owned by the test
+};
+
+// -------------------- Experiment --------------------
+
+struct ETrafficExperiment : public Coupled {
+  Port<fe::Call> inside_out;
+  Port<fe::Call> outside_out;
+
+  ETrafficExperiment(const string& id, const fe::TrafficProfile& profile, uint64_t seed,
+                     shared_ptr<Calls> calls = make_shared<Calls>())
+      : Coupled(id) {
+    inside_out = addOutPort<fe::Call>("inside_out");
+    outside_out = addOutPort<fe::Call>("outside_out");
+
+    auto traffic = addComponent<ETraffic>("etraffic", profile, seed);
+    auto recorder = addComponent<CallRecorder>("recorder", std::move(calls));
+
+    // Outputs
+    addCoupling(traffic->inside_call, inside_out);
+    addCoupling(traffic->outside_call, outside_out);
+    addCoupling(traffic->inside_call, recorder->inside);
+    addCoupling(traffic->outside_call, recorder->outside);
+  }
+};
+
+static Calls run(const fe::TrafficProfile& profile, uint64_t seed, double horizon, bool log) {
+  auto calls = make_shared<Calls>();
+  auto model = make_shared<ETrafficExperiment>("ETrafficExperiment", profile, seed, calls);
+  auto root = cadmium::RootCoordinator(model);
+  if (log) {
+    root.setLogger(make_shared<cadmium::CSVLogger>("../simulation_results/etraffic_test.csv", ";"));
+  }
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  return *calls;
+}
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string profile_path = "../input_data/etraffic_test.txt";
+  uint64_t seed = 1;
+
+  // Optional CLI: ./etraffic_test <profile_path> [seed]
+  if (argc >= 2) {
+    profile_path = argv[1];
+  }
+  if (argc >= 3) {
+    seed = stoull(argv[2]);
+  }
+
+  const fe::TrafficProfile profile = fe::TrafficProfile::load(profile_path);
+  const double horizon = 50.0;
+  const Calls calls = run(profile, seed, horizon, true);
+
+  // One car call and one hall call per passenger, output together
+  expect(!calls.outside.empty(), "passengers generated");
+  expect(calls.inside.size() == calls.outside.size(), "one car call per hall call");
+  double last = -1.0;
+  vector<size_t> per_phase(profile.phases.size(), 0);
+  for (size_t i = 0; i < calls.inside.size() && i < calls.outside.size(); ++i) {
+    const TimedCall& car = calls.inside[i];
+    const TimedCall& hall = calls.outside[i];
+    const string at = "passenger " + to_string(i) + " at " + to_string(hall.time);
+    expect(car.time == hall.time && hall.time > last && hall.time < horizon, at + ": output times");
+    last = hall.time;
+
+    // the source of each port; no id or issue time (ECall stamps them on entry)
+    expect(car.call.source == fe::CallSource::inside && hall.call.source == fe::CallSource::outside,
+           at + ": call sources");
+    expect(car.call.id == 0 && hall.call.id == 0 && car.call.issued == 0.0 && hall.call.issued == 0.0,
+           at + ": calls left unstamped");
+
+    const fe::Floor origin = hall.call.floor;
+    const fe::Floor destination = car.call.floor;
+    expect(origin >= profile.lobby && origin <= profile.top_floor && destination >= profile.lobby &&
+           destination <= profile.top_floor && origin != destination, at + ": floors in the building");
+    expect(hall.call.direction == (destination > origin ? fe::Direction::up : fe::Direction::down),
+           at + ": hall call direction");
+
+    // the mix of the phase: pure up-peak starts at the lobby, pure
+    // down-peak ends there, and a phase of rate 0 has no passengers
+    const size_t phase = profile.phase_at(hall.time);
+    const fe::TrafficPhase& mix = profile.phases[phase];
+    expect(mix.rate > 0.0, at + ": arrival in a phase of rate 0");
+    if (mix.down == 0.0 && mix.inter == 0.0) {
+      expect(origin == profile.lobby, at + ": up-peak passengers start at the lobby");
+    } else if (mix.up == 0.0 && mix.inter == 0.0) {
+      expect(destination == profile.lobby, at + ": down-peak passengers leave at the lobby");
+    }
+    ++per_phase[phase];
+  }
+  for (size_t k = 0; k < per_phase.size(); ++k) {
+    const bool open = profile.phases[k].rate > 0.0 && profile.phases[k].start < horizon;
+    expect(!open || per_phase[k] > 0, "passengers in phase " + to_string(k));
+  }
+
+  // The same seed gives the same sequence
+  const Calls again = run(profile, seed, horizon, false);
+  bool same = again.outside.size() == calls.outside.size();
+  for (size_t i = 0; same && i < calls.outside.size(); ++i) {
+    same = again.outside[i].time == calls.outside[i].time &&
+           again.outside[i].call.floor == calls.outside[i].call.floor &&
+           again.inside[i].call.floor == calls.inside[i].call.floor;
+  }
+  expect(same, "same seed, same calls");
+
+  printf("%s (%d failures); %zu passengers in %zu phases\n", failures ? "FAILED" : "passed", failures,
+         calls.outside.size(), per_phase.size());
+  return failures == 0 ? 0 : 1;
+}
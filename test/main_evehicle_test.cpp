@@ -13,12 +13,12 @@ using namespace std;
 
 // Stand-alone experiment for the EVehicle atomic model.
 struct EVehicleExperiment : public Coupled {
-  Port<int> out;
+  Port<fe::TravelTime> out;
 
   EVehicleExperiment(const string& id, const string& in_path) : Coupled(id) {
-    out = addOutPort<int>("out");
+    out = addOutPort<fe::TravelTime>("out");
 
-    auto in_stream = addComponent<cadmium::lib::IEStream<int>>(
+    auto in_stream = addComponent<cadmium::lib::IEStream<fe::TravelTime>>(
         "in_stream", in_path);
 
     auto vehicle = addComponent<EVehicle>("evehicle");
@@ -39,13 +39,13 @@ int main(int argc, char* argv[]) {
   }
 
   auto model = make_shared<EVehicleExperiment>("EVehicleExperiment", in_path);
-  auto logger = make_shared<cadmium::core::logger::CSVLogger>(
-      "../simulation_results/evehicle_test.csv", ";");
 
-  cadmium::core::simulation::RootCoordinator root(model, logger);
-  root.setTime(50);
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/evehicle_test.csv", ";");
+  root.setLogger(logger);
+
   root.start();
-  root.simulate();
+  root.simulate(50.0);
   root.stop();
 
   return 0;
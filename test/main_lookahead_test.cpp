@@ -0,0 +1,199 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "check.hpp"
+#include "../top_model/batch.hpp"
+#include "../top_model/site.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/lookahead.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Checks for fe::ElevatorFork and SchedulePolicy::lookahead: the waited()
+// cost of hand-computed futures (idle and moving cars, the horizon cap),
+// stop choices where it departs from fifo and nearest, the source requests
+// left untouched, then whole runs under lookahead: coupled, fused and
+// fe::ElevatorBatch must agree, and routes must not change the KPIs.
+// Exit status 1 on any failure.
+
+static fe::Call call_at(fe::Floor floor, uint64_t id) {
+  fe::Call c;
+  c.floor = floor;
+  c.id = id;
+  return c;
+}
+
+static fe::PendingRequests holding(const vector<fe::Floor>& floors) {
+  fe::PendingRequests r;
+  uint64_t id = 0;
+  for (const fe::Floor f : floors) {
+    r.push(call_at(f, ++id));
+  }
+  return r;
+}
+
+static vector<uint64_t> pending_ids(const fe::PendingRequests& r) {
+  vector<uint64_t> ids;
+  r.for_each_pending([&](const fe::Call& c) { ids.push_back(c.id); });
+  return ids;
+}
+
+static fe::RunKpi simulate(const fe::TowerSpec& spec, double horizon, bool fused) {
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<FreightTower>(spec.name, spec, kpi, fused);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  return *kpi;
+}
+
+static bool same(const fe::RunKpi& a, const fe::RunKpi& b) {
+  return a.calls == b.calls && a.served == b.served && near(a.wait.mean, b.wait.mean) &&
+         near(a.trip.mean, b.trip.mean);
+}
+
+int main() {
+  fe::ControlConfig config;
+
+  // 1) Costs of futures computed by hand (1 minute per floor)
+  {
+    const fe::PendingRequests r = holding({3, 8});
+    fe::ElevatorFork first3(r, 1, fe::Direction::idle, config);
+    first3.commit(3);
+    first3.run(100.0);
+    expect(first3.served() == 2 && near(first3.waited(), 2.0 + 7.0), "3 then 8 waits 9 minutes");
+    expect(first3.idle() && first3.floor() == 8 && near(first3.clock(), 100.0), "fork ends idle at 8");
+
+    fe::ElevatorFork first8(r, 1, fe::Direction::idle, config);
+    first8.commit(8);
+    first8.run(100.0);
+    expect(first8.served() == 2 && near(first8.waited(), 7.0 + 12.0), "8 then 3 waits 19 minutes");
+
+    // cut at minute 4: the call at 3 served at 2, the one at 8 still open
+    fe::ElevatorFork cut(r, 1, fe::Direction::idle, config);
+    cut.commit(3);
+    cut.run(4.0);
+    expect(cut.served() == 1 && !cut.idle() && near(cut.waited(), 2.0 + 4.0), "open calls count to the horizon");
+    cut.run(100.0);
+    expect(cut.served() == 2 && near(cut.waited(), 9.0), "a fork resumes where it was cut");
+  }
+  {
+    // a car on its way to 6 (arriving in 5 minutes) with a call at 2 waiting
+    fe::PendingRequests r = holding({6});
+    fe::Direction direction = fe::Direction::idle;
+    expect(r.pop_next(1, direction, config) == 6, "trip to 6");
+    r.push(call_at(2, 2));
+    fe::ElevatorFork fork(r, 1, direction, config, 6, 5.0);
+    expect(!fork.idle(), "a fork of a moving car is moving");
+    fork.run(100.0);
+    expect(fork.served() == 2 && near(fork.waited(), 5.0 + 9.0), "riding call served on arrival, then 2");
+
+    // the same requests seen idle: the riding call is not the fork's
+    fe::ElevatorFork idle(r, 6, direction, config);
+    idle.run(100.0);
+    expect(idle.served() == 1 && near(idle.waited(), 4.0), "riding calls left out of an idle fork");
+  }
+
+  // 2) Stop choices
+  {
+    // car at 5: one call at 4 (oldest) and three at 7
+    const fe::PendingRequests r = holding({4, 7, 7, 7});
+    auto choose = [&](fe::SchedulePolicy policy, double lookahead) {
+      fe::PendingRequests copy = r;
+      fe::ControlConfig c;
+      c.policy = policy;
+      c.lookahead = lookahead;
+      fe::Direction direction = fe::Direction::idle;
+      return copy.pop_next(5, direction, c, policy);
+    };
+    expect(choose(fe::SchedulePolicy::fifo, 5.0) == 4, "fifo takes the oldest call");
+    expect(choose(fe::SchedulePolicy::nearest, 5.0) == 4, "nearest takes the closest floor");
+    // 4 first: 1 + 3 * 4 = 13; 7 first: 3 * 2 + 5 = 11
+    expect(choose(fe::SchedulePolicy::lookahead, 5.0) == 7, "lookahead serves the cluster first");
+    // one minute ahead both cost 4: the oldest call wins the tie
+    expect(choose(fe::SchedulePolicy::lookahead, 1.0) == 4, "ties go to the oldest call");
+
+    const vector<uint64_t> before = pending_ids(r);
+    expect(fe::ElevatorFork::best_stop(r, 5, fe::Direction::idle, config) == 7, "best_stop");
+    expect(pending_ids(r) == before && r.calls() == 4 && r.size() == 2, "forks leave the requests alone");
+
+    // the chosen stop is taken like any other policy's
+    fe::PendingRequests taken(fe::SchedulePolicy::lookahead);
+    for (const fe::Floor f : {4, 7, 7, 7}) {
+      taken.push(call_at(f, taken.calls() + 1));
+    }
+    fe::Direction direction = fe::Direction::idle;
+    expect(taken.pop_next(5, direction, config) == 7 && direction == fe::Direction::up, "lookahead pop_next");
+    expect(taken.size() == 1 && pending_ids(taken) == vector<uint64_t>{1}, "calls at 7 now riding");
+    expect(taken.pop_next(7, direction, config) == 4, "single stop left");
+  }
+  {
+    // the round trip with a vehicle profile: travel comes from the table
+    auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::load("../input_data/vehicle_freight.txt"));
+    fe::ControlConfig c;
+    c.travel = travel;
+    const fe::PendingRequests r = holding({3});
+    fe::ElevatorFork fork(r, 1, fe::Direction::idle, c);
+    fork.commit(3);
+    fork.run(1e6);
+    expect(near(fork.waited(), travel->trip(1, 3)), "vehicle trip time");
+  }
+
+  expect(fe::parse_policy("lookahead") == fe::SchedulePolicy::lookahead &&
+         string(fe::to_string(fe::SchedulePolicy::lookahead)) == "lookahead", "parse_policy / to_string");
+
+  // 3) Whole runs under lookahead
+  const double horizon = 600.0;
+  auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::load("../input_data/vehicle_freight.txt"));
+  const pair<const char*, fe::TrafficProfile> profiles[] = {
+    {"up", fe::TrafficProfile::up_peak(10, 0.15)},
+    {"inter", fe::TrafficProfile::inter_floor(10, 0.2)},
+    {"day", fe::TrafficProfile::load("../input_data/traffic_day.txt")},
+  };
+  vector<fe::TowerSpec> towers;
+  for (const auto& profile : profiles) {
+    for (const uint64_t seed : {1, 2}) {
+      for (const bool vehicle : {false, true}) {
+        fe::TowerSpec spec;
+        spec.name = string(profile.first) + "/" + to_string(seed) + (vehicle ? "/vehicle" : "/linear");
+        spec.traffic = profile.second;
+        spec.seed = seed;
+        spec.control.policy = fe::SchedulePolicy::lookahead;
+        spec.control.bottom_floor = profile.second.lobby;
+        spec.control.top_floor = profile.second.top_floor;
+        spec.control.travel = vehicle ? travel : nullptr;
+        towers.push_back(std::move(spec));
+      }
+    }
+  }
+  fe::ElevatorBatch batch(towers);
+  batch.run(horizon);
+  for (size_t i = 0; i < towers.size(); ++i) {
+    const fe::TowerSpec& spec = towers[i];
+    const fe::RunKpi coupled = simulate(spec, horizon, false);
+    expect(coupled.served > 0, spec.name + ": calls served");
+    expect(same(simulate(spec, horizon, true), coupled), spec.name + ": fused differs from coupled");
+    const fe::BatchKpi b = batch.kpi(i);
+    expect(b.calls == coupled.calls && b.served == coupled.served && near(b.wait.mean, coupled.wait.mean) &&
+           near(b.trip.mean, coupled.trip.mean), spec.name + ": batch differs from coupled");
+    fe::TowerSpec routed = spec;
+    routed.control.routes = true;
+    expect(same(simulate(routed, horizon, false), coupled), spec.name + ": routes change the KPIs");
+  }
+
+  printf("%s (%d failures)\n", failures ? "FAILED" : "passed", failures);
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "cadmium/core/logger/csv.hpp"
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "../top_model/realtime_experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/realtime.hpp"
+
+using namespace std;
+
+// Real-time mode experiment: a writer thread plays the building management
+// system and sends calls over a Unix socket while FreightElevatorRealTimeExperiment
+// runs against the wall clock (x600: one simulated minute per 100 ms).
+// Every valid call must be injected, get a travel command and be served;
+// the malformed line must be dropped. Exit status 1 otherwise.
+
+static void send_calls(const string& path, const vector<pair<double, string>>& lines, double seconds_per_minute) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+  int fd = -1;
+  for (int attempt = 0; attempt < 50 && fd < 0; ++attempt) {
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+      close(fd);
+      fd = -1;
+      this_thread::sleep_for(chrono::milliseconds(20));
+    }
+  }
+  if (fd < 0) {
+    return;
+  }
+  const auto start = chrono::steady_clock::now();
+  for (const auto& [minute, text] : lines) {
+    this_thread::sleep_until(start + chrono::duration_cast<chrono::steady_clock::duration>(
+                                         chrono::duration<double>(minute * seconds_per_minute)));
+    const string line = text + "\n";
+    if (write(fd, line.data(), line.size()) < 0) {
+      break;
+    }
+  }
+  close(fd);
+}
+
+int main() {
+  const string socket_path = "../simulation_results/realtime_test.sock";
+  const vector<pair<double, string>> lines = {
+    {0.5, "3"},        {1.0, "5 in"},   {1.0, "# comment"}, {2.0, "2 out down"},
+    {2.0, "7 out up"}, {6.0, "bogus"},  {6.5, "1 in p2"},   {9.0, "4"},
+  };
+  const size_t valid = 6;
+
+  auto stats = make_shared<fe::RealTimeStats>();
+  stats->clock.seconds_per_minute = 0.1;
+  const double slice = 0.05;  // 5 ms per slice
+  auto kpi = make_shared<fe::RunKpi>();
+  auto feed = make_shared<fe::LiveFeed>(socket_path);
+
+  fe::ControlConfig config;
+  config.policy = fe::SchedulePolicy::look;
+  config.top_floor = 8;
+  auto model = make_shared<FreightElevatorRealTimeExperiment>("RealTimeExperiment", feed, slice, stats, config, kpi);
+  auto root = cadmium::RootCoordinator(model);
+  auto logger = make_shared<cadmium::CSVLogger>("../simulation_results/realtime_test.csv", ";");
+  root.setLogger(logger);
+
+  thread writer(send_calls, socket_path, lines, stats->clock.seconds_per_minute);
+  root.start();
+  run_paced(root, *stats, slice, [](double now) { return now >= 25.0; });
+  root.stop();
+  writer.join();
+
+  fe::write_summary(cout, *kpi);
+  fe::write_summary(cout, *stats);
+
+  const uint64_t commanded = stats->command_idle.count() + stats->command_queued.count();
+  const bool ok = stats->calls == valid && kpi->served == valid && commanded == valid &&
+                  feed->malformed() == 1 && feed->closed();
+  if (!ok) {
+    printf("FAIL: %llu calls injected, %llu served, %llu commanded, %llu malformed (expected %zu, %zu, %zu, 1)\n",
+           static_cast<unsigned long long>(stats->calls), static_cast<unsigned long long>(kpi->served),
+           static_cast<unsigned long long>(commanded), static_cast<unsigned long long>(feed->malformed()),
+           valid, valid, valid);
+  }
+  if (stats->late_events != 0) {
+    printf("note: %llu late events (machine under load?)\n", static_cast<unsigned long long>(stats->late_events));
+  }
+  return ok ? 0 : 1;
+}
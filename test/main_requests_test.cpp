@@ -0,0 +1,253 @@
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "check.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+using namespace std;
+
+// Checks for the fixed-capacity fe::PendingRequests and the overflow
+// policies: stages and fifo order, the floor window, the capacity bound,
+// then a saturated car under drop / reject / coalesce, coupled and fused
+// (same served and rejected calls, and every call accounted for), and
+// rejected calls counted by the KPI monitor instead of left open.
+// Exit status 1 on any failure.
+
+static fe::Call call_at(fe::Floor floor, uint64_t id) {
+  fe::Call c;
+  c.floor = floor;
+  c.id = id;
+  return c;
+}
+
+// -------------------- Output recorder --------------------
+
+struct Records {
+  uint64_t calls = 0;
+  vector<uint64_t> served;    // call ids, in output order
+  vector<uint64_t> rejected;
+};
+
+struct RecorderState {};
+
+inline ostream& operator<<(ostream& os, const RecorderState& /*s*/) {
+  return os << "{}";
+}
+
+class Recorder : public cadmium::Atomic<RecorderState> {
+ public:
+  cadmium::Port<fe::Call> calls;
+  cadmium::Port<fe::Call> served;
+  cadmium::Port<fe::Call> rejected;
+
+  Recorder(const string& id, shared_ptr<Records> records)
+      : cadmium::Atomic<RecorderState>(id, RecorderState()), records(std::move(records)) {
+    calls = addInPort<fe::Call>("calls");
+    served = addInPort<fe::Call>("served");
+    rejected = addInPort<fe::Call>("rejected");
+  }
+
+  void internalTransition(RecorderState& /*s*/) const override {}
+  void externalTransition(RecorderState& /*s*/, double /*e*/) const override {
+    records->calls += calls->getBag().size();
+    for (const auto& c : served->getBag()) {
+      records->served.push_back(c.id);
+    }
+    for (const auto& c : rejected->getBag()) {
+      records->rejected.push_back(c.id);
+    }
+  }
+  void output(const RecorderState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const RecorderState& /*s*/) const override {
+    return numeric_limits<double>::infinity();
+  }
+
+ private:
+  shared_ptr<Records> records;  // owned by the test
+};
+
+struct SaturatedCar : public Coupled {
+  SaturatedCar(const string& id, shared_ptr<Records> records, const fe::TrafficProfile& profile, uint64_t seed,
+               const fe::ControlConfig& config, bool fused)
+      : Coupled(id) {
+    auto traffic = addComponent<ETraffic>("traffic", profile, seed);
+    auto system = add_single_car(*this, traffic->inside_call, traffic->outside_call, config, fused);
+    auto recorder = addComponent<Recorder>("recorder", std::move(records));
+    addCoupling(traffic->inside_call, recorder->calls);
+    addCoupling(traffic->outside_call, recorder->calls);
+    addCoupling(system.served, recorder->served);
+    addCoupling(system.rejected, recorder->rejected);
+  }
+};
+
+static Records run(const fe::TrafficProfile& profile, uint64_t seed, const fe::ControlConfig& config, bool fused) {
+  auto records = make_shared<Records>();
+  auto model = make_shared<SaturatedCar>("requests_test", records, profile, seed, config, fused);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(300.0);
+  root.stop();
+  return *records;
+}
+
+int main() {
+  // 1) Stages: pending -> riding -> done, duplicates merge into one stop
+  {
+    fe::PendingRequests requests(fe::SchedulePolicy::fifo, 8);
+    fe::ControlConfig config;
+    expect(requests.push(call_at(5, 1)) == fe::Admission::held, "push held");
+    requests.push(call_at(3, 2));
+    requests.push(call_at(5, 3));
+    expect(requests.size() == 2 && requests.calls() == 3, "duplicate joins the stop");
+    fe::Direction direction = fe::Direction::idle;
+    expect(requests.pop_next(1, direction, config) == 5, "fifo: oldest pending floor first");
+    expect(requests.ride(call_at(5, 4)) == fe::Admission::held, "ride held");
+    vector<uint64_t> riding;
+    requests.for_each_riding([&](const fe::Call& c) { riding.push_back(c.id); });
+    expect(riding == vector<uint64_t>({1, 3, 4}), "riding calls in arrival order");
+    requests.arrive();
+    vector<uint64_t> done;
+    requests.for_each_done([&](const fe::Call& c) { done.push_back(c.id); });
+    requests.clear_done();
+    expect(done == riding && requests.calls() == 1 && requests.pending(3), "done calls cleared");
+  }
+
+  // 2) Capacity and overflow policies
+  for (auto overflow : {fe::OverflowPolicy::drop, fe::OverflowPolicy::reject, fe::OverflowPolicy::coalesce}) {
+    const string name = fe::to_string(overflow);
+    fe::PendingRequests requests(fe::SchedulePolicy::look, 3, overflow);
+    for (uint64_t id = 1; id <= 3; ++id) {
+      requests.push(call_at(static_cast<fe::Floor>(id), id));
+    }
+    const auto duplicate = requests.push(call_at(2, 4));
+    const auto fresh = requests.push(call_at(9, 5));
+    expect(requests.calls() == 3 && requests.size() == 3 && !requests.pending(9), name + ": capacity bound");
+    expect(duplicate == (overflow == fe::OverflowPolicy::coalesce ? fe::Admission::coalesced
+                                                                  : fe::Admission::refused),
+           name + ": call for a pending stop");
+    expect(fresh == fe::Admission::refused, name + ": call for a new stop");
+  }
+  bool thrown = false;
+  try {
+    fe::PendingRequests(fe::SchedulePolicy::fifo, FE_REQUEST_CAPACITY + 1);
+  } catch (const invalid_argument&) {
+    thrown = true;
+  }
+  expect(thrown, "capacity above FE_REQUEST_CAPACITY rejected");
+
+  // 3) Floor window: basements re-anchor it, a span beyond FE_MAX_FLOORS throws
+  {
+    fe::PendingRequests requests(fe::SchedulePolicy::look);
+    fe::ControlConfig config;
+    requests.push(call_at(10, 1));
+    requests.push(call_at(-3, 2));
+    requests.push(call_at(10 + FE_MAX_FLOORS - 14, 3));
+    expect(requests.pending(-3) && requests.pending(10) && requests.size() == 3, "window re-anchored");
+    thrown = false;
+    try {
+      requests.push(call_at(-3 + FE_MAX_FLOORS, 4));
+    } catch (const out_of_range&) {
+      thrown = true;
+    }
+    expect(thrown && requests.calls() == 3, "span beyond FE_MAX_FLOORS throws");
+    fe::Direction direction = fe::Direction::up;
+    expect(requests.pop_next(0, direction, config) == 10, "look: next stop above");
+  }
+
+  // 4) A saturated car: far more calls than it can serve
+  const fe::TrafficProfile profile = fe::TrafficProfile::inter_floor(20, 1.5);
+  int cases = 0;
+  for (auto overflow : {fe::OverflowPolicy::drop, fe::OverflowPolicy::reject, fe::OverflowPolicy::coalesce}) {
+    for (auto policy : {fe::SchedulePolicy::fifo, fe::SchedulePolicy::look}) {
+      fe::ControlConfig config;
+      config.policy = policy;
+      config.top_floor = profile.top_floor;
+      config.request_capacity = 16;
+      config.overflow = overflow;
+      const string name = string(fe::to_string(overflow)) + "/" + fe::to_string(policy);
+      const Records coupled = run(profile, 7, config, false);
+      const Records fused = run(profile, 7, config, true);
+      ++cases;
+
+      expect(coupled.served == fused.served && coupled.rejected == fused.rejected,
+             name + ": coupled and fused agree");
+      const uint64_t accounted = coupled.served.size() + coupled.rejected.size();
+      expect(coupled.calls > coupled.served.size() + 16, name + ": the car is saturated");
+      if (overflow == fe::OverflowPolicy::drop) {
+        expect(coupled.rejected.empty(), name + ": nothing signalled");
+      } else if (overflow == fe::OverflowPolicy::reject) {
+        // every call is served, rejected or still held
+        expect(coupled.calls - accounted <= 16, name + ": every refusal signalled");
+      } else {
+        expect(!coupled.rejected.empty(), name + ": new stops refused");
+      }
+      printf("%-16s %6llu calls %6zu served %6zu rejected\n", name.c_str(),
+             static_cast<unsigned long long>(coupled.calls), coupled.served.size(), coupled.rejected.size());
+    }
+  }
+
+  // 5) Refused calls reach the KPI monitor: a one-call car, five calls at
+  // once and two later ones. Four are rejected and none stay open, so the
+  // later calls find an empty building (queue samples add up to at most
+  // 0+1+2+3+4 for the first five, 0 for the others). Then a burst of
+  // refusals larger than the inline FE_REJECT_BURST.
+  {
+    const string inside = "../simulation_results/requests_test_inside.txt";
+    const string outside = "../simulation_results/requests_test_outside.txt";
+    ofstream(inside) << "20 1\n";
+    ofstream(outside) << "0 2\n0 3\n0 4\n0 5\n0 6\n10 9\n";
+    for (const bool fused : {false, true}) {
+      fe::ControlConfig config;
+      config.request_capacity = 1;
+      auto kpi = make_shared<fe::RunKpi>();
+      auto model = make_shared<FreightElevatorExperiment>("requests_kpi", inside, outside, config, kpi, fused);
+      auto root = cadmium::RootCoordinator(model);
+      root.start();
+      root.simulate(numeric_limits<double>::infinity());
+      root.stop();
+      const string name = fused ? "kpi/fused" : "kpi/coupled";
+      expect(kpi->calls == 7 && kpi->served == 3 && kpi->rejected == 4, name + ": 3 served, 4 rejected");
+      expect(kpi->overall.queue.count() == 7 && kpi->overall.queue.mean() * 7 <= 10.0,
+             name + ": rejected calls are no longer open");
+    }
+
+    // a burst far beyond FE_REJECT_BURST: every refusal is still signalled
+    const string burst = "../simulation_results/requests_test_burst.txt";
+    {
+      ofstream out(burst);
+      for (int k = 0; k < 4 * FE_REJECT_BURST; ++k) {
+        out << "0 " << 2 + k % 9 << "\n";
+      }
+    }
+    for (const bool fused : {false, true}) {
+      fe::ControlConfig config;
+      config.request_capacity = 1;
+      auto kpi = make_shared<fe::RunKpi>();
+      auto model = make_shared<FreightElevatorExperiment>("requests_burst", inside, burst, config, kpi, fused);
+      auto root = cadmium::RootCoordinator(model);
+      root.start();
+      root.simulate(numeric_limits<double>::infinity());
+      root.stop();
+      expect(kpi->calls == 4 * FE_REJECT_BURST + 1 && kpi->served == 2 && kpi->rejected == 4 * FE_REJECT_BURST - 1,
+             string(fused ? "burst/fused" : "burst/coupled") + ": every refusal signalled");
+    }
+  }
+
+  printf("%s (%d failures, %d saturated runs, FE_REQUEST_CAPACITY %d, FE_MAX_FLOORS %d)\n",
+         failures ? "FAILED" : "passed", failures, cases, FE_REQUEST_CAPACITY, FE_MAX_FLOORS);
+  return failures == 0 ? 0 : 1;
+}
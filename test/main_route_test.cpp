@@ -0,0 +1,264 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "recorder.hpp"
+#include "../atomics/evehicle.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Checks for route commands (fe::ControlConfig::routes): fe::Route, an
+// EVehicle running, extending and replacing routes on its own, and every
+// model with routes against the same model with one travel time per stop
+// (reached floors and served requests, with call ids and times, in output
+// order). Exit status 1 on any failure.
+
+static fe::Route route(const vector<pair<fe::Floor, double>>& legs, bool append = false) {
+  fe::Route r;
+  r.append = append;
+  for (const auto& leg : legs) {
+    r.push_back(leg.first, leg.second);
+  }
+  return r;
+}
+
+// -------------------- Scripted vehicle --------------------
+
+struct Arrival {
+  double time;
+  fe::TravelTime travel;
+};
+
+struct RouteScriptState {
+  double clock = 0.0;
+  size_t next = 0;
+};
+
+inline ostream& operator<<(ostream& os, const RouteScriptState& s) {
+  return os << "{clock:" << s.clock << ",next:" << s.next << "}";
+}
+
+// Sends each route at its time
+class RouteScript : public cadmium::Atomic<RouteScriptState> {
+ public:
+  cadmium::Port<fe::Route> out;
+
+  RouteScript(const string& id, vector<pair<double, fe::Route>> script)
+      : cadmium::Atomic<RouteScriptState>(id, RouteScriptState()), script(std::move(script)) {
+    out = addOutPort<fe::Route>("out");
+  }
+
+  void internalTransition(RouteScriptState& s) const override {
+    s.clock = script[s.next].first;
+    ++s.next;
+  }
+  void externalTransition(RouteScriptState& /*s*/, double /*e*/) const override {}
+  void output(const RouteScriptState& s) const override { out->addMessage(script[s.next].second); }
+  [[nodiscard]] double timeAdvance(const RouteScriptState& s) const override {
+    return s.next < script.size() ? script[s.next].first - s.clock : numeric_limits<double>::infinity();
+  }
+
+ private:
+  vector<pair<double, fe::Route>> script;
+};
+
+struct ArrivalRecorderState {
+  double clock = 0.0;
+};
+
+inline ostream& operator<<(ostream& os, const ArrivalRecorderState& s) {
+  return os << "{clock:" << s.clock << "}";
+}
+
+class ArrivalRecorder : public cadmium::Atomic<ArrivalRecorderState> {
+ public:
+  cadmium::Port<fe::TravelTime> in;
+
+  ArrivalRecorder(const string& id, shared_ptr<vector<Arrival>> arrivals)
+      : cadmium::Atomic<ArrivalRecorderState>(id, ArrivalRecorderState()), arrivals(std::move(arrivals)) {
+    in = addInPort<fe::TravelTime>("in");
+  }
+
+  void internalTransition(ArrivalRecorderState& /*s*/) const override {}
+  void externalTransition(ArrivalRecorderState& s, double e) const override {
+    s.clock += e;
+    for (const auto& t : in->getBag()) {
+      arrivals->push_back(Arrival{s.clock, t});
+    }
+  }
+  void output(const ArrivalRecorderState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const ArrivalRecorderState& /*s*/) const override {
+    return numeric_limits<double>::infinity();
+  }
+
+ private:
+  shared_ptr<vector<Arrival>> arrivals;
+};
+
+struct VehicleExperiment : public Coupled {
+  VehicleExperiment(const string& id, vector<pair<double, fe::Route>> script, shared_ptr<vector<Arrival>> arrivals)
+      : Coupled(id) {
+    auto commands = addComponent<RouteScript>("commands", std::move(script));
+    auto vehicle = addComponent<EVehicle>("evehicle");
+    auto recorder = addComponent<ArrivalRecorder>("recorder", std::move(arrivals));
+    addCoupling(commands->out, vehicle->route);
+    addCoupling(vehicle->out, recorder->in);
+  }
+};
+
+static vector<Arrival> drive(vector<pair<double, fe::Route>> script) {
+  auto arrivals = make_shared<vector<Arrival>>();
+  auto model = make_shared<VehicleExperiment>("route_vehicle", std::move(script), arrivals);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(50.0);
+  root.stop();
+  return *arrivals;
+}
+
+static bool arrivals_are(const vector<Arrival>& got, const vector<Arrival>& want) {
+  if (got.size() != want.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < got.size(); ++i) {
+    if (!near(got[i].time, want[i].time) || got[i].travel != want[i].travel) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string inside_path = "../input_data/efused_inside_test.txt";
+  string outside_path = "../input_data/efused_outside_test.txt";
+
+  // Optional CLI: ./route_test <inside_calls> <outside_calls>
+  if (argc >= 3) {
+    inside_path = argv[1];
+    outside_path = argv[2];
+  }
+
+  // 1) fe::Route: a fixed-capacity queue
+  {
+    fe::Route r;
+    for (int k = 0; k < FE_ROUTE_LEGS; ++k) {
+      expect(r.push_back(k, 1.0), "route: push within capacity");
+    }
+    expect(r.full() && !r.push_back(99, 1.0), "route: full at FE_ROUTE_LEGS");
+    r.pop_front();
+    r.pop_front();
+    expect(r.push_back(99, 2.0) && r.size() == FE_ROUTE_LEGS - 1, "route: popped room is reused");
+    expect(r.front().floor == 2 && (r.end() - 1)->floor == 99, "route: order kept across compaction");
+    r.clear();
+    expect(r.empty() && r.size() == 0, "route: clear");
+  }
+
+  // 2) EVehicle on routes (no door dwell)
+  expect(arrivals_are(drive({{0.0, route({{3, 2.0}, {5, 2.0}, {9, 4.0}})}}), {{2.0, 2.0}, {4.0, 2.0}, {8.0, 4.0}}),
+         "vehicle: legs back to back, one output per stop");
+  expect(arrivals_are(drive({{0.0, route({{3, 2.0}})}, {1.0, route({{5, 2.0}}, true)}}), {{2.0, 2.0}, {4.0, 2.0}}),
+         "vehicle: appended leg follows");
+  expect(arrivals_are(drive({{0.0, route({{3, 2.0}, {5, 2.0}})}, {1.0, route({{7, 1.0}})}}),
+                      {{2.0, 2.0}, {3.0, 1.0}}),
+         "vehicle: replacement keeps the leg in progress");
+  expect(arrivals_are(drive({{0.0, route({{3, 2.0}, {5, 2.0}})}, {2.0, route({{7, 1.0}})}}),
+                      {{2.0, 2.0}, {3.0, 1.0}}),
+         "vehicle: replacement at the instant a leg starts replaces it");
+  expect(arrivals_are(drive({{0.0, route({{3, 2.0}, {5, 2.0}})}, {2.0, route({})}}), {{2.0, 2.0}}),
+         "vehicle: empty replacement at a stop ends the route");
+  expect(arrivals_are(drive({{0.0, route({{3, 2.0}, {5, 2.0}})}, {2.0, route({}, true)}}), {{2.0, 2.0}, {4.0, 2.0}}),
+         "vehicle: empty append changes nothing");
+
+  // 3) Every model: routes vs one travel time per stop
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  int cases = 0;
+  int differences = 0;
+  size_t outputs = 0;
+  auto check = [&](const string& name, const Records& trips, const Records& routes) {
+    string why;
+    const bool ok = same("floor", "trips", trips.floors, "routes", routes.floors, why) &&
+                    same("served", "trips", trips.served, "routes", routes.served, why);
+    ++cases;
+    differences += !ok;
+    outputs += trips.floors.size();
+    expect(ok, name + " " + why);
+  };
+
+  for (auto policy : policies) {
+    fe::ControlConfig config;
+    config.policy = policy;
+    config.top_floor = 8;
+    auto trips = record<FreightElevatorExperiment>("route_test", 100.0, inside_path, outside_path, config, nullptr, false);
+    config.routes = true;
+    auto routes = record<FreightElevatorExperiment>("route_test", 100.0, inside_path, outside_path, config, nullptr, false);
+    check(string("files/") + fe::to_string(policy), trips, routes);
+  }
+
+  struct Load {
+    const char* pattern;
+    fe::TrafficProfile profile;
+    double horizon;
+  };
+  const Load loads[] = {
+    {"up", fe::TrafficProfile::up_peak(10, 0.08), 5000.0},
+    {"down", fe::TrafficProfile::down_peak(10, 0.08), 5000.0},
+    {"inter", fe::TrafficProfile::inter_floor(10, 0.5), 1000.0},
+    {"tall", fe::TrafficProfile::inter_floor(200, 0.05), 2000.0},  // more stops than a route holds
+  };
+  const auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, 200, 3.5));
+  for (const Load& load : loads) {
+    for (auto policy : policies) {
+      auto config = make_config(policy, load.profile);
+      for (const bool profiled : {false, true}) {
+        config.travel = profiled ? travel : nullptr;
+        const double horizon = profiled ? load.horizon / 10.0 : load.horizon;
+        for (uint64_t seed = 1; seed <= 3; ++seed) {
+          config.routes = false;
+          auto trips = record<FreightElevatorTrafficExperiment>("route_test", horizon, load.profile, seed, config, nullptr, false);
+          config.routes = true;
+          auto routes = record<FreightElevatorTrafficExperiment>("route_test", horizon, load.profile, seed, config, nullptr, false);
+          check(string("traffic/") + load.pattern + (profiled ? "/vehicle/" : "/") + fe::to_string(policy) + "/"
+                + to_string(seed), trips, routes);
+        }
+      }
+    }
+  }
+
+  const auto bank_profile = fe::TrafficProfile::up_peak(20, 0.3);
+  for (size_t cars = 1; cars <= 4; ++cars) {
+    for (auto policy : policies) {
+      auto config = make_config(policy, bank_profile);
+      auto trips = record<ElevatorBankTrafficExperiment>("route_test", 2000.0, cars, bank_profile, 7, config, nullptr, false);
+      config.routes = true;
+      auto routes = record<ElevatorBankTrafficExperiment>("route_test", 2000.0, cars, bank_profile, 7, config, nullptr, false);
+      check("bank/" + to_string(cars) + "/" + fe::to_string(policy), trips, routes);
+    }
+  }
+
+  // en-route stops take precedence: routes are then not used
+  {
+    auto config = make_config(fe::SchedulePolicy::look, loads[2].profile);
+    config.en_route = true;
+    auto trips = record<FreightElevatorTrafficExperiment>("route_test", 1000.0, loads[2].profile, 1, config, nullptr, false);
+    config.routes = true;
+    expect(!fe::uses_routes(config), "en_route: no routes");
+    auto routes = record<FreightElevatorTrafficExperiment>("route_test", 1000.0, loads[2].profile, 1, config, nullptr, false);
+    check("en_route/look", trips, routes);
+  }
+
+  printf("%s (%d failures); %d/%d models identical with routes (%zu floor outputs)\n",
+         failures ? "FAILED" : "passed", failures, cases - differences, cases, outputs);
+  return failures == 0 ? 0 : 1;
+}
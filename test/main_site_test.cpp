@@ -0,0 +1,165 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../top_model/site.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Site runs: the towers of a site simulated on 1..8 threads, with and
+// without shared-clock barriers, must give the same KPIs as the sequential
+// FreightSite under one RootCoordinator (exact: counts, Welford sums and
+// histograms), and the same progress at every barrier. A tower that throws
+// must stop the run with its exception. Exit status 1 on any failure.
+
+struct SiteRun {
+  vector<shared_ptr<fe::RunKpi>> kpis;
+  vector<uint64_t> served_at_sync;  // site-wide served calls at each barrier
+};
+
+static SiteRun run(const vector<fe::TowerSpec>& towers, const fe::SiteOptions& options) {
+  SiteRun r;
+  for (size_t i = 0; i < towers.size(); ++i) {
+    r.kpis.push_back(make_shared<fe::RunKpi>());
+  }
+  fe::run_site(towers, options, r.kpis, [&](double /*now*/) {
+    uint64_t served = 0;
+    for (const auto& k : r.kpis) {
+      served += k->served;
+    }
+    r.served_at_sync.push_back(served);
+  });
+  return r;
+}
+
+static string summary(const fe::RunKpi& k) {
+  ostringstream os;
+  fe::write_summary(os, k);
+  os << k.wait.n << ' ' << k.wait.mean << ' ' << k.wait.m2 << ' ' << k.trip.n << ' ' << k.trip.mean << ' '
+     << k.trip.m2 << ' ' << k.last_time;
+  return os.str();
+}
+
+static bool same_kpis(const SiteRun& a, const SiteRun& b, const vector<fe::TowerSpec>& towers, string& why) {
+  for (size_t i = 0; i < towers.size(); ++i) {
+    const fe::RunKpi& x = *a.kpis[i];
+    const fe::RunKpi& y = *b.kpis[i];
+    if (x.calls != y.calls || x.served != y.served || x.wait.mean != y.wait.mean || x.wait.m2 != y.wait.m2
+        || x.trip.mean != y.trip.mean || x.trip.m2 != y.trip.m2 || summary(x) != summary(y)) {
+      why = "tower " + towers[i].name + ": " + to_string(x.served) + " vs " + to_string(y.served) + " served";
+      return false;
+    }
+  }
+  if (a.served_at_sync != b.served_at_sync) {
+    why = "progress differs at the barriers";
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string inside_path = "../input_data/efused_inside_test.txt";
+  string outside_path = "../input_data/efused_outside_test.txt";
+
+  // Optional CLI: ./site_test <inside_calls> <outside_calls>
+  if (argc >= 3) {
+    inside_path = argv[1];
+    outside_path = argv[2];
+  }
+  const string trace_path = "../simulation_results/site_test.fetrace";
+  fe::convert_text_trace(inside_path, outside_path, trace_path);
+  auto trace = make_shared<const fe::TraceFile>(trace_path);
+
+  // Eleven towers of uneven load: seeded traffic under every policy, two trace towers
+  vector<fe::TowerSpec> towers;
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  for (int i = 0; i < 9; ++i) {
+    fe::TowerSpec tower;
+    tower.name = "traffic_" + to_string(i);
+    tower.traffic = (i % 3 == 0) ? fe::TrafficProfile::up_peak(10 + i, 0.1 * (i + 1))
+                  : (i % 3 == 1) ? fe::TrafficProfile::down_peak(12, 0.3)
+                                 : fe::TrafficProfile::inter_floor(20, 0.05 * (i + 1));
+    tower.seed = 100 + static_cast<uint64_t>(i);
+    tower.control.policy = policies[i % 4];
+    tower.control.bottom_floor = tower.traffic.lobby;
+    tower.control.top_floor = tower.traffic.top_floor;
+    if (i == 4) {
+      tower.control.travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, 12, 4.0));
+    }
+    towers.push_back(tower);
+  }
+  for (int i = 0; i < 2; ++i) {
+    fe::TowerSpec tower;
+    tower.name = "trace_" + to_string(i);
+    tower.trace = trace;
+    tower.control.policy = policies[i + 2];
+    tower.control.top_floor = 8;
+    towers.push_back(tower);
+  }
+
+  int cases = 0;
+  int failures = 0;
+  for (const bool fused : {false, true}) {
+    for (const double sync : {0.0, 37.5}) {
+      fe::SiteOptions options;
+      options.horizon = 600.0;
+      options.sync = sync;
+      options.fused = fused;
+      options.sequential = true;
+      const SiteRun reference = run(towers, options);
+
+      options.sequential = false;
+      for (const size_t threads : {1, 2, 3, 8, 16}) {
+        options.threads = threads;
+        const SiteRun parallel = run(towers, options);
+        string why;
+        ++cases;
+        if (!same_kpis(reference, parallel, towers, why)) {
+          ++failures;
+          printf("FAIL %s/sync %g/%zu threads: %s\n", fused ? "fused" : "coupled", sync, threads, why.c_str());
+        }
+      }
+    }
+  }
+
+  // A tower whose floors are outside its vehicle profile throws from its thread
+  {
+    vector<fe::TowerSpec> broken = towers;
+    broken[2].control.travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, 5, 4.0));
+    fe::SiteOptions options;
+    options.horizon = 600.0;
+    options.sync = 50.0;
+    options.threads = 4;
+    bool thrown = false;
+    try {
+      run(broken, options);
+    } catch (const out_of_range&) {
+      thrown = true;
+    }
+    ++cases;
+    if (!thrown) {
+      ++failures;
+      printf("FAIL broken tower: no exception\n");
+    }
+  }
+
+  uint64_t served = 0;
+  fe::SiteOptions options;
+  options.horizon = 600.0;
+  for (const auto& k : run(towers, options).kpis) {
+    served += k->served;
+  }
+  printf("%d/%d cases passed (%zu towers, %llu calls served per run)\n", cases - failures, cases, towers.size(),
+         static_cast<unsigned long long>(served));
+  return failures == 0 ? 0 : 1;
+}
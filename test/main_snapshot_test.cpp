@@ -0,0 +1,250 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "recorder.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Checkpoint/restore suite: every case runs an experiment straight to the
+// horizon H, then runs it again to a pause time T, saves a snapshot to disk,
+// loads it into a freshly built model and runs that from T to H. The outputs
+// from T on (reached floors and served requests, with call ids and times)
+// must be identical. Exit status 1 on any difference.
+
+// Recorded<Experiment> takes the checkpoint as the experiment's last
+// constructor argument.
+
+// Straight run from 0 to 'horizon', keeping the outputs from 'from' on
+template <typename Experiment, typename... Args>
+static Records run_straight(double from, double horizon, Args&&... args) {
+  auto records = make_shared<Records>();
+  auto model = make_shared<Recorded<Experiment>>("snapshot_test", records, 0.0, std::forward<Args>(args)...,
+                                                 nullptr);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+
+  Records kept;
+  for (const auto& r : records->floors) {
+    if (r.time >= from) {
+      kept.floors.push_back(r);
+    }
+  }
+  for (const auto& r : records->served) {
+    if (r.time >= from) {
+      kept.served.push_back(r);
+    }
+  }
+  return kept;
+}
+
+// Run to 'pause', snapshot through 'path'
+template <typename Experiment, typename... Args>
+static void run_to_pause(double pause, const string& path, Args&&... args) {
+  auto checkpoint = make_shared<fe::Checkpoint>();
+  auto model = make_shared<Recorded<Experiment>>("snapshot_test", make_shared<Records>(), 0.0,
+                                                 std::forward<Args>(args)..., checkpoint);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(pause);
+  root.stop();
+  checkpoint->take(pause).save(path);
+}
+
+// Restore 'path' into a new model and run it to 'horizon'; adds the time
+// spent loading and restoring to 'restore_ms'
+template <typename Experiment, typename... Args>
+static Records run_restored(double horizon, const string& path, bool reseed, double& restore_ms,
+                            Args&&... args) {
+  const auto t0 = chrono::steady_clock::now();
+  auto snapshot = make_shared<const fe::Snapshot>(fe::Snapshot::load(path));
+  auto checkpoint = make_shared<fe::Checkpoint>(snapshot, reseed);
+  auto records = make_shared<Records>();
+  auto model = make_shared<Recorded<Experiment>>("snapshot_test", records, snapshot->time,
+                                                 std::forward<Args>(args)..., checkpoint);
+  const double start = checkpoint->start_time();
+  restore_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+  auto root = cadmium::RootCoordinator(model, start);
+  root.start();
+  root.simulate(horizon - start);
+  root.stop();
+  return *records;
+}
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string inside_path = "../input_data/efused_inside_test.txt";
+  string outside_path = "../input_data/efused_outside_test.txt";
+
+  // Optional CLI: ./snapshot_test <inside_calls> <outside_calls>
+  if (argc >= 3) {
+    inside_path = argv[1];
+    outside_path = argv[2];
+  }
+  const string trace_path = "../simulation_results/snapshot_test.fetrace";
+  const string snapshot_path = "../simulation_results/snapshot_test.fesnap";
+  fe::convert_text_trace(inside_path, outside_path, trace_path);
+
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  int cases = 0;
+  int restores = 0;
+  double restore_ms = 0.0;
+  size_t outputs = 0;
+
+  auto check = [&](const string& name, const Records& straight, const Records& restored) {
+    string why;
+    const bool ok = same("floor", "straight", straight.floors, "restored", restored.floors, why) &&
+                    same("served", "straight", straight.served, "restored", restored.served, why);
+    ++cases;
+    failures += !ok;
+    outputs += straight.floors.size();
+    if (!ok) {
+      printf("FAIL %-36s %s\n", name.c_str(), why.c_str());
+    }
+  };
+
+  for (const bool fused : {false, true}) {
+    const string model = fused ? "fused/" : "coupled/";
+
+    // 1) Trace input, paused at several times (mid-trip, idle, before the first call)
+    for (auto policy : policies) {
+      fe::ControlConfig config;
+      config.policy = policy;
+      config.top_floor = 8;
+      for (const double pause : {0.5, 3.0, 7.25, 20.0}) {
+        auto straight = run_straight<FreightElevatorTraceExperiment>(pause, 100.0, trace_path, config,
+                                                                     nullptr, fused);
+        run_to_pause<FreightElevatorTraceExperiment>(pause, snapshot_path, trace_path, config, nullptr, fused);
+        auto restored = run_restored<FreightElevatorTraceExperiment>(100.0, snapshot_path, false, restore_ms,
+                                                                     trace_path, config, nullptr, fused);
+        ++restores;
+        check(model + "trace/" + fe::to_string(policy) + "/" + to_string(pause), straight, restored);
+      }
+    }
+
+    // 2) Seeded traffic, single car, paused after a warm-up
+    const auto profile = fe::TrafficProfile::inter_floor(10, 0.5);
+    for (auto policy : policies) {
+      const auto config = make_config(policy, profile);
+      for (uint64_t seed = 1; seed <= 3; ++seed) {
+        auto straight = run_straight<FreightElevatorTrafficExperiment>(300.0, 1000.0, profile, seed, config,
+                                                                       nullptr, fused);
+        run_to_pause<FreightElevatorTrafficExperiment>(300.0, snapshot_path, profile, seed, config, nullptr,
+                                                       fused);
+        auto restored = run_restored<FreightElevatorTrafficExperiment>(1000.0, snapshot_path, false,
+                                                                       restore_ms, profile, seed, config,
+                                                                       nullptr, fused);
+        ++restores;
+        check(model + "traffic/" + fe::to_string(policy) + "/" + to_string(seed), straight, restored);
+      }
+    }
+
+    // 2b) Same with a vehicle profile: fractional times to arrival, door dwell
+    const auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, 10, 4.0));
+    for (auto policy : policies) {
+      auto config = make_config(policy, profile);
+      config.travel = travel;
+      auto straight = run_straight<FreightElevatorTrafficExperiment>(300.0, 1000.0, profile, 1, config,
+                                                                     nullptr, fused);
+      run_to_pause<FreightElevatorTrafficExperiment>(300.0, snapshot_path, profile, 1, config, nullptr, fused);
+      auto restored = run_restored<FreightElevatorTrafficExperiment>(1000.0, snapshot_path, false, restore_ms,
+                                                                     profile, 1, config, nullptr, fused);
+      ++restores;
+      check(model + "vehicle/" + fe::to_string(policy), straight, restored);
+    }
+
+    // 2c) En-route stops: a trip paused part-way must keep its time into the trip
+    for (auto policy : policies) {
+      auto config = make_config(policy, profile);
+      config.en_route = true;
+      for (const auto& table : {shared_ptr<const fe::TravelTable>(), travel}) {
+        config.travel = table;
+        const string name = model + "en_route/" + (table ? "vehicle/" : "linear/") + fe::to_string(policy);
+        for (const double pause : {299.5, 300.0, 301.25}) {
+          auto straight = run_straight<FreightElevatorTrafficExperiment>(pause, 1000.0, profile, 2, config,
+                                                                         nullptr, fused);
+          run_to_pause<FreightElevatorTrafficExperiment>(pause, snapshot_path, profile, 2, config, nullptr,
+                                                         fused);
+          auto restored = run_restored<FreightElevatorTrafficExperiment>(1000.0, snapshot_path, false,
+                                                                         restore_ms, profile, 2, config,
+                                                                         nullptr, fused);
+          ++restores;
+          check(name + "/" + to_string(pause), straight, restored);
+        }
+      }
+    }
+
+    // 2d) Routes: the vehicle holds legs the controller planned before the pause
+    for (auto policy : policies) {
+      auto config = make_config(policy, profile);
+      config.routes = true;
+      for (const double pause : {299.5, 300.0, 301.25}) {
+        auto straight = run_straight<FreightElevatorTrafficExperiment>(pause, 1000.0, profile, 3, config,
+                                                                       nullptr, fused);
+        run_to_pause<FreightElevatorTrafficExperiment>(pause, snapshot_path, profile, 3, config, nullptr,
+                                                       fused);
+        auto restored = run_restored<FreightElevatorTrafficExperiment>(1000.0, snapshot_path, false, restore_ms,
+                                                                       profile, 3, config, nullptr, fused);
+        ++restores;
+        check(model + "routes/" + fe::to_string(policy) + "/" + to_string(pause), straight, restored);
+      }
+    }
+
+    // 3) Elevator bank, dispatcher included
+    const auto bank_profile = fe::TrafficProfile::up_peak(20, 0.3);
+    for (size_t cars = 1; cars <= 4; ++cars) {
+      for (auto policy : policies) {
+        const auto config = make_config(policy, bank_profile);
+        auto straight = run_straight<ElevatorBankTrafficExperiment>(500.0, 2000.0, cars, bank_profile, 7,
+                                                                    config, nullptr, fused);
+        run_to_pause<ElevatorBankTrafficExperiment>(500.0, snapshot_path, cars, bank_profile, 7, config,
+                                                    nullptr, fused);
+        auto restored = run_restored<ElevatorBankTrafficExperiment>(2000.0, snapshot_path, false, restore_ms,
+                                                                    cars, bank_profile, 7, config, nullptr,
+                                                                    fused);
+        ++restores;
+        check(model + "bank/" + to_string(cars) + "/" + fe::to_string(policy), straight, restored);
+      }
+    }
+  }
+
+  // 4) A reseeded branch draws new traffic from the same warmed-up building
+  {
+    const auto profile = fe::TrafficProfile::up_peak(20, 0.3);
+    const auto config = make_config(fe::SchedulePolicy::look, profile);
+    run_to_pause<ElevatorBankTrafficExperiment>(500.0, snapshot_path, size_t{3}, profile, 7, config, nullptr,
+                                                false);
+    auto same_seed = run_restored<ElevatorBankTrafficExperiment>(2000.0, snapshot_path, true, restore_ms,
+                                                                 size_t{3}, profile, 7, config, nullptr, false);
+    auto new_seed = run_restored<ElevatorBankTrafficExperiment>(2000.0, snapshot_path, true, restore_ms,
+                                                                size_t{3}, profile, 8, config, nullptr, false);
+    restores += 2;
+    string why;
+    ++cases;
+    if (same("served", "same seed", same_seed.served, "new seed", new_seed.served, why)) {
+      ++failures;
+      printf("FAIL %-36s reseeded branches are identical\n", "reseed/bank/3/look");
+    }
+  }
+
+  printf("%d/%d cases passed (%zu floor outputs after the pause); %d restores, %.3f ms each on average\n",
+         cases - failures, cases, outputs, restores, restore_ms / restores);
+  return failures == 0 ? 0 : 1;
+}
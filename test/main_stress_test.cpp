@@ -0,0 +1,644 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "../atomics/ecall.hpp"
+#include "../atomics/econtrol.hpp"
+#include "../atomics/evehicle.hpp"
+#include "../top_model/elevator_coupled.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+
+using namespace std;
+
+// Stress suite (make stress): ECall, EControl, EVehicle and ElevatorCoupled
+// each driven to quiescence by a million or more generated calls or commands,
+// checked by probe atomics on every message:
+//  - clock: no negative elapsed time, outputs never stamped in the future
+//  - ECall: every call forwarded once, at once, in order, with the next id
+//  - EVehicle: every command answered once, after exactly its travel time;
+//    commands sent while moving are ignored
+//  - EControl: one trip at a time, every trip ends with its floor output (no
+//    lost fback), every call served at its floor or rejected, exactly once
+// Each scenario runs in its own forked process; its wall time per million
+// events and its peak RSS growth must stay within test/stress_budget.txt.
+// Exit status 1 on any failure.
+
+// -------------------- Shared run report --------------------
+
+struct Report {
+  uint64_t events = 0;    // messages into and out of the models under test
+  uint64_t failures = 0;
+  string first_failure;
+
+  void expect(bool ok, double clock, const char* what) {
+    if (!ok && failures++ == 0) {
+      ostringstream text;
+      text << what << " at t=" << clock;
+      first_failure = text.str();
+    }
+  }
+};
+
+// Clocks are sums of millions of elapsed times, in different orders
+static bool same_time(double a, double b) {
+  return fabs(a - b) <= 1e-9 * max(1.0, fabs(a));
+}
+
+// 64-bit LCG (Knuth MMIX constants), as in bench/bench_models.hpp
+static uint64_t next_random(uint64_t& seed, uint64_t range) {
+  seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (seed >> 33) % range;
+}
+
+// -------------------- Call source --------------------
+
+struct StressCallsState {
+  double sigma = 0.0;
+  double clock = 0.0;
+  uint64_t seed = 1;
+  uint64_t sent = 0;
+  fe::Call next_call;
+};
+
+inline ostream& operator<<(ostream& os, const StressCallsState& s) {
+  return os << "{sent:" << s.sent << ",sigma:" << s.sigma << "}";
+}
+
+// 'total' calls to random floors, alternately on inside and outside, one per
+// instant, 0..2*interval minutes apart; then passive. Calls are stamped with
+// ids 1..total when 'stamp' (models without an ECall in front).
+class StressCalls : public cadmium::Atomic<StressCallsState> {
+ public:
+  cadmium::Port<fe::Call> inside;
+  cadmium::Port<fe::Call> outside;
+
+  StressCalls(const string& id, uint64_t total, double interval, fe::Floor floors, bool stamp)
+      : cadmium::Atomic<StressCallsState>(id, StressCallsState()),
+        total(total), interval(interval), floors(floors), stamp(stamp) {
+    inside = addOutPort<fe::Call>("inside");
+    outside = addOutPort<fe::Call>("outside");
+  }
+
+  void internalTransition(StressCallsState& s) const override {
+    s.clock += s.sigma;
+    if (++s.sent == total) {
+      s.sigma = numeric_limits<double>::infinity();
+      return;
+    }
+    s.sigma = interval * 2.0 * static_cast<double>(next_random(s.seed, 1024)) / 1024.0;
+    s.next_call = fe::Call();
+    s.next_call.floor = 1 + static_cast<fe::Floor>(next_random(s.seed, static_cast<uint64_t>(floors)));
+    if (stamp) {
+      s.next_call.id = s.sent + 1;
+      s.next_call.issued = s.clock + s.sigma;
+    }
+  }
+  void externalTransition(StressCallsState& s, double e) const override {
+    s.clock += e;
+    s.sigma -= e;
+  }
+  void output(const StressCallsState& s) const override {
+    fe::Call call = s.next_call;
+    if (stamp && s.sent == 0) {
+      call.id = 1;
+    }
+    (s.sent % 2 == 0 ? inside : outside)->addMessage(call);
+  }
+  [[nodiscard]] double timeAdvance(const StressCallsState& s) const override { return s.sigma; }
+
+ private:
+  uint64_t total;
+  double interval;
+  fe::Floor floors;
+  bool stamp;
+};
+
+// -------------------- ECall probe --------------------
+
+struct CallProbeState {
+  double clock = 0.0;
+  uint64_t last_id = 0;
+};
+
+inline ostream& operator<<(ostream& os, const CallProbeState& s) {
+  return os << "{clock:" << s.clock << ",last:" << s.last_id << "}";
+}
+
+// ECall's outputs: consecutive ids from 1, issued now, source as generated.
+class CallProbe : public cadmium::Atomic<CallProbeState> {
+ public:
+  cadmium::Port<fe::Call> in;
+
+  CallProbe(const string& id, shared_ptr<Report> report)
+      : cadmium::Atomic<CallProbeState>(id, CallProbeState()), report(std::move(report)) {
+    in = addInPort<fe::Call>("in");
+  }
+
+  void internalTransition(CallProbeState& /*s*/) const override {}
+  void externalTransition(CallProbeState& s, double e) const override {
+    report->expect(e >= 0.0, s.clock, "negative elapsed time");
+    s.clock += e;
+    for (const auto& call : in->getBag()) {
+      report->events += 2;  // into and out of ECall
+      report->expect(call.id == ++s.last_id, s.clock, "call lost, repeated or out of order");
+      report->expect(same_time(call.issued, s.clock), s.clock, "call delayed or stamped at the wrong time");
+      const fe::CallSource source = call.id % 2 == 1 ? fe::CallSource::inside : fe::CallSource::outside;
+      report->expect(call.source == source, s.clock, "call stamped with the wrong source");
+    }
+  }
+  void output(const CallProbeState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const CallProbeState& /*s*/) const override {
+    return numeric_limits<double>::infinity();
+  }
+
+ private:
+  shared_ptr<Report> report;  // owned by the scenario
+};
+
+// -------------------- EVehicle driver --------------------
+
+struct VehicleDriverState {
+  double sigma = 0.0;
+  double clock = 0.0;
+  uint64_t seed = 7;
+  uint64_t sent = 0;
+  fe::TravelTime command = 0;
+  bool moving = false;     // a command is being answered
+  bool stray = false;      // next output is a command sent while moving
+  double due = 0.0;        // absolute time the answer is due
+};
+
+inline ostream& operator<<(ostream& os, const VehicleDriverState& s) {
+  return os << "{sent:" << s.sent << ",moving:" << (s.moving ? "T" : "F") << ",sigma:" << s.sigma << "}";
+}
+
+// Commands 'total' trips of 0..floors minutes, one at a time; every fourth
+// trip of 2+ minutes also gets a stray command halfway, which must be ignored.
+class VehicleDriver : public cadmium::Atomic<VehicleDriverState> {
+ public:
+  cadmium::Port<fe::TravelTime> command;
+  cadmium::Port<fe::TravelTime> fback;
+
+  VehicleDriver(const string& id, uint64_t total, fe::Floor floors, shared_ptr<Report> report)
+      : cadmium::Atomic<VehicleDriverState>(id, VehicleDriverState()),
+        total(total), floors(floors), report(std::move(report)) {
+    command = addOutPort<fe::TravelTime>("command");
+    fback = addInPort<fe::TravelTime>("fback");
+  }
+
+  void internalTransition(VehicleDriverState& s) const override {
+    s.clock += s.sigma;
+    if (s.stray) {
+      s.stray = false;
+      s.sigma = numeric_limits<double>::infinity();  // the answer ends the wait
+      return;
+    }
+    ++s.sent;
+    s.moving = true;
+    s.due = s.clock + s.command;
+    s.stray = s.sent % 4 == 0 && s.command >= 2;
+    s.sigma = s.stray ? s.command / 2.0 : numeric_limits<double>::infinity();
+  }
+  void externalTransition(VehicleDriverState& s, double e) const override {
+    report->expect(e >= 0.0, s.clock, "negative elapsed time");
+    s.clock += e;
+    const auto& bag = fback->getBag();
+    report->events += bag.size();
+    report->expect(s.moving && bag.size() == 1, s.clock, "feedback without a command, or repeated");
+    report->expect(bag.empty() || bag.back() == s.command, s.clock, "feedback echoes the wrong command");
+    report->expect(same_time(s.clock, s.due), s.clock, "feedback after the wrong delay");
+    s.moving = false;
+    s.stray = false;
+    if (s.sent < total) {
+      s.command = static_cast<fe::TravelTime>(next_random(s.seed, static_cast<uint64_t>(floors)));
+      s.sigma = static_cast<double>(next_random(s.seed, 4));
+    } else {
+      s.sigma = numeric_limits<double>::infinity();
+    }
+  }
+  void output(const VehicleDriverState& s) const override {
+    report->events++;
+    command->addMessage(s.stray ? s.command + 1 : s.command);
+  }
+  [[nodiscard]] double timeAdvance(const VehicleDriverState& s) const override { return s.sigma; }
+
+ private:
+  uint64_t total;
+  fe::Floor floors;
+  shared_ptr<Report> report;  // owned by the scenario
+};
+
+// -------------------- Stand-in car for EControl --------------------
+
+struct FakeCarState {
+  double sigma = numeric_limits<double>::infinity();
+  double clock = 0.0;
+  fe::TravelTime travel = 0;
+  bool busy = false;
+};
+
+inline ostream& operator<<(ostream& os, const FakeCarState& s) {
+  return os << "{busy:" << (s.busy ? "T" : "F") << ",sigma:" << s.sigma << "}";
+}
+
+// Answers each timem after that many minutes; a command while busy fails.
+class FakeCar : public cadmium::Atomic<FakeCarState> {
+ public:
+  cadmium::Port<fe::TravelTime> in;
+  cadmium::Port<fe::TravelTime> out;
+
+  FakeCar(const string& id, shared_ptr<Report> report)
+      : cadmium::Atomic<FakeCarState>(id, FakeCarState()), report(std::move(report)) {
+    in = addInPort<fe::TravelTime>("in");
+    out = addOutPort<fe::TravelTime>("out");
+  }
+
+  void internalTransition(FakeCarState& s) const override {
+    s.clock += s.sigma;
+    s.busy = false;
+    s.sigma = numeric_limits<double>::infinity();
+  }
+  void externalTransition(FakeCarState& s, double e) const override {
+    s.clock += e;
+    s.sigma -= e;
+    const auto& bag = in->getBag();
+    report->expect(!s.busy && bag.size() == 1, s.clock, "trip commanded while the car is moving");
+    report->expect(bag.back() >= 0, s.clock, "negative travel time");
+    s.busy = true;
+    s.travel = bag.back();
+    s.sigma = static_cast<double>(s.travel);
+  }
+  void output(const FakeCarState& s) const override {
+    report->events++;
+    out->addMessage(s.travel);
+  }
+  [[nodiscard]] double timeAdvance(const FakeCarState& s) const override { return s.sigma; }
+
+ private:
+  shared_ptr<Report> report;  // owned by the scenario
+};
+
+// -------------------- Service probe --------------------
+
+struct ServiceProbeState {
+  double clock = 0.0;
+  uint64_t trips = 0;
+  uint64_t stops = 0;
+  uint64_t served = 0;
+  uint64_t rejected = 0;
+  vector<uint8_t> seen;  // per call id: 0 open, 1 served, 2 rejected
+
+  explicit ServiceProbeState(uint64_t calls = 0) : seen(calls + 1, 0) {}
+};
+
+inline ostream& operator<<(ostream& os, const ServiceProbeState& s) {
+  return os << "{trips:" << s.trips << ",stops:" << s.stops << ",served:" << s.served << "}";
+}
+
+// A controller's outputs: served calls come with their floor, each call ends
+// once; finish() checks that every call ended and every trip reached a floor.
+class ServiceProbe : public cadmium::Atomic<ServiceProbeState> {
+ public:
+  cadmium::Port<fe::TravelTime> timem;
+  cadmium::Port<fe::Floor> floor;
+  cadmium::Port<fe::Call> served;
+  cadmium::Port<fe::Call> rejected;
+
+  ServiceProbe(const string& id, uint64_t total, shared_ptr<Report> report)
+      : cadmium::Atomic<ServiceProbeState>(id, ServiceProbeState(total)), report(std::move(report)) {
+    timem = addInPort<fe::TravelTime>("timem");
+    floor = addInPort<fe::Floor>("floor");
+    served = addInPort<fe::Call>("served");
+    rejected = addInPort<fe::Call>("rejected");
+  }
+
+  void internalTransition(ServiceProbeState& /*s*/) const override {}
+  void externalTransition(ServiceProbeState& s, double e) const override {
+    report->expect(e >= 0.0, s.clock, "negative elapsed time");
+    s.clock += e;
+    s.trips += timem->size();
+    s.stops += floor->size();
+    report->events += timem->size() + floor->size();
+    for (const auto& call : served->getBag()) {
+      const bool reached = !floor->empty() && floor->getBag().back() == call.floor;
+      report->expect(reached, s.clock, "call served away from its floor");
+      report->expect(call.issued <= s.clock + 1e-9 * max(1.0, s.clock), s.clock, "call served before it was made");
+      end_call(s, call, 1);
+    }
+    for (const auto& call : rejected->getBag()) {
+      end_call(s, call, 2);
+    }
+  }
+  void output(const ServiceProbeState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const ServiceProbeState& s) const override {
+    live = &s;
+    return numeric_limits<double>::infinity();
+  }
+
+  // End of run: every call served or rejected, every trip ended at a floor.
+  void finish(bool rejects_allowed) const {
+    const ServiceProbeState& s = *live;
+    uint64_t open = 0;
+    for (size_t id = 1; id < s.seen.size(); ++id) {
+      open += s.seen[id] == 0;
+    }
+    report->expect(open == 0, s.clock, "calls never served nor rejected");
+    report->expect(s.trips == s.stops, s.clock, "trip without its floor (lost fback)");
+    report->expect(rejects_allowed || s.rejected == 0, s.clock, "calls rejected below capacity");
+    report->expect(s.served > 0, s.clock, "nothing served");
+  }
+
+ private:
+  void end_call(ServiceProbeState& s, const fe::Call& call, uint8_t how) const {
+    report->events++;
+    const bool known = call.id > 0 && call.id < s.seen.size();
+    report->expect(known && s.seen[call.id] == 0, s.clock, "call served or rejected twice");
+    if (known) {
+      s.seen[call.id] = how;
+    }
+    (how == 1 ? s.served : s.rejected)++;
+  }
+
+  shared_ptr<Report> report;                     // owned by the scenario
+  mutable const ServiceProbeState* live = nullptr;  // current state, for finish()
+};
+
+// -------------------- Scenarios --------------------
+
+enum class Subject { ecall, evehicle, econtrol, elevator };
+
+struct Scenario {
+  const char* name;
+  Subject subject;
+  uint64_t calls;           // calls (trips for evehicle) at scale 1
+  fe::Floor floors;
+  double interval;          // mean minutes between calls
+  fe::SchedulePolicy policy;
+  size_t capacity;          // EControl request capacity
+  bool rejects_allowed;
+};
+
+// Light enough for 'elevator' to hold every call; 'elevator_full' overflows
+// a small request buffer on purpose.
+static const Scenario kScenarios[] = {
+  {"ecall",         Subject::ecall,    2000000, 20, 1.0, fe::SchedulePolicy::fifo, FE_REQUEST_CAPACITY, false},
+  {"evehicle",      Subject::evehicle, 1000000, 20, 0.0, fe::SchedulePolicy::fifo, FE_REQUEST_CAPACITY, false},
+  {"econtrol",      Subject::econtrol, 1000000, 20, 2.0, fe::SchedulePolicy::look, FE_REQUEST_CAPACITY, false},
+  {"elevator",      Subject::elevator, 1000000, 20, 2.0, fe::SchedulePolicy::look, FE_REQUEST_CAPACITY, false},
+  {"elevator_full", Subject::elevator, 1000000, 20, 0.2, fe::SchedulePolicy::fifo, 16, true},
+};
+
+struct StressECall : public Coupled {
+  StressECall(const string& id, const Scenario& sc, uint64_t calls, const shared_ptr<Report>& report)
+      : Coupled(id) {
+    auto source = addComponent<StressCalls>("source", calls, sc.interval, sc.floors, false);
+    auto call = addComponent<ECall>("Ecall");
+    auto probe = addComponent<CallProbe>("probe", report);
+    addCoupling(source->inside, call->inside_call);
+    addCoupling(source->outside, call->outside_call);
+    addCoupling(call->call_gen, probe->in);
+  }
+};
+
+struct StressEVehicle : public Coupled {
+  StressEVehicle(const string& id, const Scenario& sc, uint64_t trips, const shared_ptr<Report>& report)
+      : Coupled(id) {
+    auto driver = addComponent<VehicleDriver>("driver", trips, sc.floors, report);
+    auto vehicle = addComponent<EVehicle>("Evehicle");
+    addCoupling(driver->command, vehicle->in);
+    addCoupling(vehicle->out, driver->fback);
+  }
+};
+
+// EControl alone (fake car) or ElevatorCoupled, fed directly with stamped calls
+struct StressController : public Coupled {
+  shared_ptr<ServiceProbe> probe;
+
+  StressController(const string& id, const Scenario& sc, uint64_t calls, const shared_ptr<Report>& report)
+      : Coupled(id) {
+    fe::ControlConfig config;
+    config.policy = sc.policy;
+    config.top_floor = sc.floors;
+    config.request_capacity = sc.capacity;
+    config.overflow = fe::OverflowPolicy::reject;
+
+    auto source = addComponent<StressCalls>("source", calls, sc.interval, sc.floors, true);
+    probe = addComponent<ServiceProbe>("probe", calls, report);
+    if (sc.subject == Subject::econtrol) {
+      auto control = addComponent<EControl>("Econtrol", config);
+      auto car = addComponent<FakeCar>("car", report);
+      addCoupling(source->inside, control->acall);
+      addCoupling(source->outside, control->acall);
+      addCoupling(control->timem, car->in);
+      addCoupling(car->out, control->fback);
+      addCoupling(control->timem, probe->timem);
+      addCoupling(control->floor, probe->floor);
+      addCoupling(control->served, probe->served);
+      addCoupling(control->rejected, probe->rejected);
+    } else {
+      auto elevator = addComponent<ElevatorCoupled>("elevator", config);
+      addCoupling(source->inside, elevator->acall);
+      addCoupling(source->outside, elevator->acall);
+      addCoupling(elevator->timem, probe->timem);
+      addCoupling(elevator->floor, probe->floor);
+      addCoupling(elevator->served, probe->served);
+      addCoupling(elevator->rejected, probe->rejected);
+    }
+  }
+};
+
+// -------------------- Measurement --------------------
+
+struct Result {
+  uint64_t events = 0;
+  uint64_t failures = 0;
+  double wall_s = 0.0;
+  long rss_growth_kb = 0;  // peak RSS during the run minus RSS before it
+  char first_failure[160] = {};
+};
+
+// A "Vm...:" field of /proc/self/status, in kB (0 if unavailable)
+static long status_kb(const char* field) {
+  ifstream status("/proc/self/status");
+  string line;
+  while (getline(status, line)) {
+    if (line.compare(0, strlen(field), field) == 0) {
+      return strtol(line.c_str() + strlen(field), nullptr, 10);
+    }
+  }
+  return 0;
+}
+
+template <typename Model>
+static void simulate(const shared_ptr<Model>& model) {
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(numeric_limits<double>::infinity());  // run to quiescence
+  root.stop();
+}
+
+static Result run_scenario(const Scenario& sc, double scale) {
+  const auto calls = static_cast<uint64_t>(static_cast<double>(sc.calls) * scale);
+  auto report = make_shared<Report>();
+
+  // Reset the RSS high-water mark to the current RSS (Linux)
+  ofstream("/proc/self/clear_refs") << "5";
+  const long rss0 = status_kb("VmRSS:");
+
+  const auto t0 = chrono::steady_clock::now();
+  switch (sc.subject) {
+    case Subject::ecall:
+      simulate(make_shared<StressECall>("stress", sc, calls, report));
+      report->expect(report->events == 2 * calls, 0.0, "calls missing at the end");
+      break;
+    case Subject::evehicle:
+      simulate(make_shared<StressEVehicle>("stress", sc, calls, report));
+      break;
+    case Subject::econtrol:
+    case Subject::elevator: {
+      auto model = make_shared<StressController>("stress", sc, calls, report);
+      simulate(model);
+      model->probe->finish(sc.rejects_allowed);
+      report->events += calls;  // the calls in
+      break;
+    }
+  }
+
+  Result r;
+  r.wall_s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  r.rss_growth_kb = max(0L, status_kb("VmHWM:") - rss0);
+  r.events = report->events;
+  r.failures = report->failures;
+  snprintf(r.first_failure, sizeof(r.first_failure), "%s", report->first_failure.c_str());
+  return r;
+}
+
+// Runs the scenario in a child process so its memory is its own.
+static bool run_isolated(const Scenario& sc, double scale, Result& r) {
+  int fds[2];
+  if (pipe(fds) != 0) {
+    return false;
+  }
+  fflush(stdout);
+  const pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    const Result child = run_scenario(sc, scale);
+    const bool ok = write(fds[1], &child, sizeof(child)) == static_cast<ssize_t>(sizeof(child));
+    _exit(ok ? 0 : 1);
+  }
+  close(fds[1]);
+  const bool ok = read(fds[0], &r, sizeof(r)) == static_cast<ssize_t>(sizeof(r));
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  return ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// -------------------- Budgets --------------------
+
+struct Budget {
+  string name;
+  double wall_s = 0.0;       // per million events
+  double rss_base_kb = 0.0;  // peak RSS growth at any scale ...
+  double rss_kb = 0.0;       // ... plus this per million events
+};
+
+// One scenario per line: <name> <wall_s_per_Mev> <rss_base_kb> <rss_kb_per_Mev>; '#' comments
+static vector<Budget> read_budgets(const string& path) {
+  vector<Budget> out;
+  ifstream file(path);
+  string line;
+  while (getline(file, line)) {
+    istringstream fields(line.substr(0, line.find('#')));
+    Budget b;
+    if (fields >> b.name >> b.wall_s >> b.rss_base_kb >> b.rss_kb) {
+      out.push_back(b);
+    }
+  }
+  return out;
+}
+
+int main(int argc, char* argv[]) {
+  // Optional CLI: ./stress_test [--scale f] [--only name] [--budget file|none]
+  string budget_path = "../test/stress_budget.txt";
+  string only;
+  double scale = 1.0;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const string arg = argv[i];
+    if (arg == "--scale") {
+      scale = stod(argv[i + 1]);
+    } else if (arg == "--only") {
+      only = argv[i + 1];
+    } else if (arg == "--budget") {
+      budget_path = argv[i + 1];
+    } else {
+      fprintf(stderr, "unknown option %s\n", arg.c_str());
+      return 2;
+    }
+  }
+  const vector<Budget> budgets = budget_path == "none" ? vector<Budget>() : read_budgets(budget_path);
+  if (budget_path != "none" && budgets.empty()) {
+    fprintf(stderr, "no budgets in %s (use --budget none to check invariants only)\n", budget_path.c_str());
+    return 2;
+  }
+
+  printf("%-14s %10s %9s %12s %10s %12s  %s\n", "scenario", "events", "wall_s", "s_per_Mev", "rss_kb",
+         "rss_kb_per_Mev", "result");
+  int failures = 0;
+  for (const Scenario& sc : kScenarios) {
+    if (!only.empty() && only != sc.name) {
+      continue;
+    }
+    Result r;
+    if (!run_isolated(sc, scale, r)) {
+      printf("%-14s crashed\n", sc.name);
+      ++failures;
+      continue;
+    }
+    const double mevents = max(1e-6, static_cast<double>(r.events) / 1e6);
+    const double wall_per = r.wall_s / mevents;
+    const double rss_per = static_cast<double>(r.rss_growth_kb) / mevents;
+
+    string verdict = "ok";
+    if (r.failures > 0) {
+      verdict = "FAIL " + to_string(r.failures) + " invariant violations, first: " + r.first_failure;
+    }
+    for (const Budget& b : budgets) {
+      if (b.name != sc.name) {
+        continue;
+      }
+      if (wall_per > b.wall_s) {
+        verdict = (verdict == "ok" ? "FAIL" : verdict) + " over wall budget (" + to_string(b.wall_s) + " s/Mev)";
+      }
+      const double rss_budget = b.rss_base_kb + b.rss_kb * mevents;
+      if (static_cast<double>(r.rss_growth_kb) > rss_budget) {
+        verdict = (verdict == "ok" ? "FAIL" : verdict) + " over memory budget (" + to_string(rss_budget) + " kB)";
+      }
+    }
+    failures += verdict != "ok";
+    printf("%-14s %10llu %9.3f %12.3f %10ld %12.0f  %s\n", sc.name, static_cast<unsigned long long>(r.events),
+           r.wall_s, wall_per, r.rss_growth_kb, rss_per, verdict.c_str());
+  }
+  return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/lib/iestream.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "recorder.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/time_base.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Time base suite: runs FreightElevatorTopT on double minutes, on fe::Ticks
+// and on fe::Millis with the same input (the call files, seeded traffic, a
+// vehicle profile, a long horizon) and compares the reached floors and the
+// served requests (floor, call id, output time and issue time, in output
+// order). Integer trip times must match exactly under every time type;
+// fractional ones within the rounding of one tick per trip. Exit status 1 on
+// any difference.
+
+// FreightElevatorTopT<Time> fed by the two call files or by ETraffic
+template <typename Time>
+struct TimedCar : public Coupled {
+  TimedCar(const string& id, shared_ptr<Records> records, const string& inside_path, const string& outside_path,
+           const fe::ControlConfig& config)
+      : Coupled(id) {
+    auto inside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("inside_calls", inside_path);
+    auto outside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("outside_calls", outside_path);
+    couple(inside_calls->out, outside_calls->out, std::move(records), config);
+  }
+
+  TimedCar(const string& id, shared_ptr<Records> records, const fe::TrafficProfile& profile, uint64_t seed,
+           const fe::ControlConfig& config)
+      : Coupled(id) {
+    auto traffic = addComponent<ETraffic>("traffic", profile, seed);
+    couple(traffic->inside_call, traffic->outside_call, std::move(records), config);
+  }
+
+ private:
+  void couple(const Port<fe::Call>& inside_call, const Port<fe::Call>& outside_call, shared_ptr<Records> records,
+              const fe::ControlConfig& config) {
+    auto system = addComponent<FreightElevatorTopT<Time>>("freight_elevator", config);
+    auto recorder = addComponent<FloorRecorder>("recorder", std::move(records));
+    addCoupling(inside_call, system->inside_call);
+    addCoupling(outside_call, system->outside_call);
+    addCoupling(system->floor, recorder->in);
+    addCoupling(system->served, recorder->served);
+  }
+};
+
+template <typename Time, typename... Args>
+static Records run(double horizon, double& wall, Args&&... args) {
+  auto records = make_shared<Records>();
+  auto model = make_shared<TimedCar<Time>>("timebase_test", records, std::forward<Args>(args)...);
+  auto root = cadmium::RootCoordinator(model);
+  auto t0 = chrono::steady_clock::now();
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  wall += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+  return *records;
+}
+
+// Output times within 'tolerance' minutes of the double run (0: identical);
+// issue times within 'issue_tolerance' (ECall rounds each elapsed time to a
+// tick). 'deviation' collects the largest output time difference seen.
+static bool same(const char* what, const vector<FloorRecord>& expected, const vector<FloorRecord>& actual,
+                 double tolerance, double issue_tolerance, double& deviation, string& why) {
+  for (size_t i = 0; i < expected.size() && i < actual.size(); ++i) {
+    const FloorRecord& a = expected[i];
+    const FloorRecord& b = actual[i];
+    const double off = fabs(a.time - b.time);
+    deviation = max(deviation, off);
+    if (a.floor != b.floor || a.call != b.call || off > tolerance || fabs(a.issued - b.issued) > issue_tolerance) {
+      char line[240];
+      snprintf(line, sizeof(line), "%s %zu: double floor %d #%llu at %.9g (issued %.9g), got floor %d #%llu at %.9g "
+               "(issued %.9g)", what, i, a.floor, static_cast<unsigned long long>(a.call), a.time, a.issued, b.floor,
+               static_cast<unsigned long long>(b.call), b.time, b.issued);
+      why = line;
+      return false;
+    }
+  }
+  if (expected.size() != actual.size()) {
+    why = to_string(expected.size()) + " double " + what + " outputs vs " + to_string(actual.size());
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  const fe::SchedulePolicy policies[] = {fe::SchedulePolicy::fifo, fe::SchedulePolicy::scan,
+                                         fe::SchedulePolicy::look, fe::SchedulePolicy::nearest};
+  const double tick = fe::TimeBase<fe::Ticks>::to_minutes(fe::Ticks(1));
+  const double milli = fe::TimeBase<fe::Millis>::to_minutes(fe::Millis(1));
+  int cases = 0;
+  size_t outputs = 0;
+  double vehicle_deviation = 0.0;
+  double double_wall = 0.0;
+  double ticks_wall = 0.0;
+  double millis_wall = 0.0;
+
+  auto check = [&](const string& name, const Records& expected, const Records& actual, double tolerance,
+                   double issue_tolerance, double& deviation) {
+    string why;
+    const bool ok = same("floor", expected.floors, actual.floors, tolerance, issue_tolerance, deviation, why) &&
+                    same("served", expected.served, actual.served, tolerance, issue_tolerance, deviation, why);
+    ++cases;
+    failures += !ok;
+    outputs += expected.floors.size() + expected.served.size();
+    if (!ok) {
+      printf("FAIL %-36s %s\n", name.c_str(), why.c_str());
+    }
+  };
+
+  // 1) Call files: every issue time is a whole number of ticks and milliseconds
+  const pair<const char*, const char*> files[] = {
+    {"../input_data/inside_calls.txt", "../input_data/outside_calls.txt"},
+    {"../input_data/efused_inside_test.txt", "../input_data/efused_outside_test.txt"},
+    {"../input_data/vehicle_inside_test.txt", "../input_data/vehicle_outside_test.txt"},
+  };
+  for (const auto& [inside_path, outside_path] : files) {
+    for (auto policy : policies) {
+      fe::ControlConfig config;
+      config.policy = policy;
+      config.top_floor = 8;
+      double wall = 0.0;
+      double deviation = 0.0;
+      const string name = string("files/") + inside_path + "/" + fe::to_string(policy);
+      const Records expected = run<double>(1000.0, wall, inside_path, outside_path, config);
+      check(name + "/ticks", expected, run<fe::Ticks>(1000.0, wall, inside_path, outside_path, config), 0.0, 0.0,
+            deviation);
+      check(name + "/millis", expected, run<fe::Millis>(1000.0, wall, inside_path, outside_path, config), 0.0, 0.0,
+            deviation);
+    }
+  }
+
+  // 2) Seeded traffic: exponential gaps are rounded to a tick in the issue
+  //    times only; trips of whole floors keep every output time identical
+  struct Load {
+    const char* pattern;
+    fe::TrafficProfile profile;
+    double horizon;
+  };
+  const Load loads[] = {
+    {"up", fe::TrafficProfile::up_peak(10, 0.08), 5000.0},
+    {"inter", fe::TrafficProfile::inter_floor(10, 0.5), 1000.0},
+    {"tall", fe::TrafficProfile::inter_floor(200, 0.05), 2000.0},
+  };
+  for (const Load& load : loads) {
+    for (auto policy : policies) {
+      const auto config = make_config(policy, load.profile);
+      for (uint64_t seed = 1; seed <= 3; ++seed) {
+        double deviation = 0.0;
+        const string name = string("traffic/") + load.pattern + "/" + fe::to_string(policy) + "/" + to_string(seed);
+        const Records expected = run<double>(load.horizon, double_wall, load.profile, seed, config);
+        check(name + "/ticks", expected, run<fe::Ticks>(load.horizon, ticks_wall, load.profile, seed, config), 0.0,
+              1e-3, deviation);
+        check(name + "/millis", expected, run<fe::Millis>(load.horizon, millis_wall, load.profile, seed, config),
+              0.0, 1e-3, deviation);
+      }
+    }
+  }
+
+  // 3) Vehicle profile: fractional trip times round to a tick per trip
+  const auto vehicle_profile = fe::TrafficProfile::inter_floor(20, 0.05);
+  const auto travel = make_shared<const fe::TravelTable>(fe::VehicleProfile::uniform(1, 20, 3.5));
+  for (auto policy : policies) {
+    auto config = make_config(policy, vehicle_profile);
+    config.travel = travel;
+    for (uint64_t seed = 1; seed <= 3; ++seed) {
+      double wall = 0.0;
+      const string name = string("vehicle/") + fe::to_string(policy) + "/" + to_string(seed);
+      const Records expected = run<double>(1000.0, wall, vehicle_profile, seed, config);
+      const double trips = static_cast<double>(expected.floors.size());
+      check(name + "/ticks", expected, run<fe::Ticks>(1000.0, wall, vehicle_profile, seed, config),
+            trips * tick, 1e-3, vehicle_deviation);
+      check(name + "/millis", expected, run<fe::Millis>(1000.0, wall, vehicle_profile, seed, config),
+            trips * milli, 1e-3, vehicle_deviation);
+    }
+  }
+
+  // 4) Long horizon: a year of up-peak traffic, output times still identical
+  {
+    const auto profile = fe::TrafficProfile::up_peak(10, 0.01);
+    const auto config = make_config(fe::SchedulePolicy::look, profile);
+    const double year = 525600.0;
+    double deviation = 0.0;
+    const Records expected = run<double>(year, double_wall, profile, 11, config);
+    check("long/ticks", expected, run<fe::Ticks>(year, ticks_wall, profile, 11, config), 0.0, 1e-2, deviation);
+  }
+
+  printf("%d/%d cases match (%zu outputs); vehicle profile within %.3g min (tick %.3g min); "
+         "traffic runs: double %.3f s, ticks %.3f s, millis %.3f s\n",
+         cases - failures, cases, outputs, vehicle_deviation, tick, double_wall, ticks_wall, millis_wall);
+  return failures == 0 ? 0 : 1;
+}
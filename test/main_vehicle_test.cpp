@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+
+#include "check.hpp"
+#include "../top_model/experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+using namespace std;
+
+// Checks for fe::VehicleProfile and fe::TravelTable: S-curve motion times
+// against closed forms, the table against the profile, the file format, and
+// the coupled and fused models timing a few trips with the table (EControl's
+// motion time plus EVehicle's door dwell). Exit status 1 on any failure.
+
+static fe::RunKpi run(const string& inside, const string& outside, const fe::ControlConfig& config, bool fused) {
+  auto kpi = make_shared<fe::RunKpi>();
+  auto model = make_shared<FreightElevatorExperiment>("VehicleExperiment", inside, outside, config, kpi, fused);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(50.0);
+  root.stop();
+  return *kpi;
+}
+
+int main(int argc, char* argv[]) {
+  // Default test input (assumes you run from ./bin)
+  string profile_path = "../input_data/vehicle_freight.txt";
+  string inside_path = "../input_data/vehicle_inside_test.txt";
+  string outside_path = "../input_data/vehicle_outside_test.txt";
+
+  // Optional CLI: ./vehicle_test <profile>
+  if (argc >= 2) {
+    profile_path = argv[1];
+  }
+
+  // 1) Motion times: 1 m/s, 0.6 m/s^2
+  fe::VehicleProfile p = fe::VehicleProfile::uniform(1, 10, 4.0);
+  p.speed = 1.0;
+  p.acceleration = 0.6;
+  p.jerk = 0.0;
+  // trapezoid: 1/0.6 s ramps covering 1/0.6 m, the rest at rated speed
+  expect(near(p.motion_seconds(4.0), 2.0 / 0.6 + (4.0 - 1.0 / 0.6)), "trapezoid, cruising");
+  // triangle: peak sqrt(a d), time 2 sqrt(d / a)
+  expect(near(p.motion_seconds(1.0), 2.0 * sqrt(1.0 / 0.6)), "trapezoid, short trip");
+  p.jerk = 0.9;
+  // jerk-limited ramps last v/a + a/j and cover v times that
+  const double ramp = 1.0 / 0.6 + 0.6 / 0.9;
+  expect(near(p.motion_seconds(10.0), 2.0 * ramp + (10.0 - ramp)), "S-curve, cruising");
+  // below v = a^2/j the ramps never reach full acceleration: time 4 (d / 2j)^(1/3)
+  expect(near(p.motion_seconds(0.2), 4.0 * cbrt(0.2 / 1.8)), "S-curve, short trip");
+  expect(p.motion_seconds(0.0) == 0.0, "zero distance");
+  double previous = 0.0;
+  bool increasing = true;
+  for (double d = 0.05; d < 30.0; d += 0.05) {
+    const double t = p.motion_seconds(d);
+    increasing = increasing && t > previous;
+    previous = t;
+  }
+  expect(increasing, "motion time increases with distance");
+
+  // 2) Table: the profile file, with a tall loading-dock storey
+  const fe::VehicleProfile freight = fe::VehicleProfile::load(profile_path);
+  const fe::TravelTable table(freight);
+  expect(table.lowest() == freight.lowest && table.top() == freight.top, "table floors");
+  expect(near(table.door_dwell(), freight.door_dwell / 60.0), "door dwell in minutes");
+  double elevation = 0.0;
+  bool matches = true;
+  for (fe::Floor to = freight.lowest; to <= freight.top; ++to) {
+    const double expected = freight.motion_seconds(elevation) / 60.0;
+    matches = matches && near(table.motion(freight.lowest, to), expected)
+              && table.motion(to, freight.lowest) == table.motion(freight.lowest, to)
+              && table.motion(to, to) == 0.0
+              && near(table.trip(freight.lowest, to), expected + table.door_dwell());
+    if (to < freight.top) {
+      elevation += freight.storeys[static_cast<size_t>(to - freight.lowest)];
+    }
+  }
+  expect(matches, "table matches the profile");
+  expect(table.motion(1, 2) > table.motion(2, 3), "taller storey takes longer");
+  bool thrown = false;
+  try {
+    (void)table.motion(freight.lowest - 1, freight.lowest);
+  } catch (const out_of_range&) {
+    thrown = true;
+  }
+  expect(thrown, "floor below the profile throws");
+
+  // 3) Malformed file
+  const string bad_path = "../simulation_results/vehicle_test_bad.txt";
+  ofstream(bad_path) << "floors 1 10\nspeed -1\n";
+  thrown = false;
+  try {
+    (void)fe::VehicleProfile::load(bad_path);
+  } catch (const runtime_error&) {
+    thrown = true;
+  }
+  expect(thrown, "negative speed rejected");
+
+  // 4) Trips through the models: 1 -> 5, a call at the car's floor (door
+  //    dwell only), 5 -> 1, then an outside call at floor 2
+  fe::ControlConfig config;
+  config.top_floor = freight.top;
+  config.travel = make_shared<const fe::TravelTable>(freight);
+  const double trip_mean = (table.trip(1, 5) + table.trip(5, 5) + table.trip(5, 1)) / 3.0;
+  for (bool fused : {false, true}) {
+    const fe::RunKpi kpi = run(inside_path, outside_path, config, fused);
+    const string model = fused ? "fused" : "coupled";
+    expect(kpi.served == 4, model + ": 4 calls served");
+    expect(near(kpi.trip.mean, trip_mean), model + ": inside calls take motion + dwell");
+    expect(near(kpi.wait.mean, table.trip(1, 2)), model + ": outside call waits motion + dwell");
+  }
+
+  printf("%s (%d failures); 1 -> %d in %.3f min, door dwell %.3f min\n", failures ? "FAILED" : "passed", failures,
+         freight.top, table.motion(freight.lowest, freight.top), table.door_dwell());
+  return failures == 0 ? 0 : 1;
+}
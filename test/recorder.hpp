@@ -0,0 +1,136 @@
+#ifndef FE_TEST_RECORDER_HPP
+#define FE_TEST_RECORDER_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cadmium/core/simulation/root_coordinator.hpp"
+#include "cadmium/modeling/devs/atomic.hpp"
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include "check.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+// Output recorder shared by the equivalence tests (efused, route, snapshot,
+// timebase): the reached floors and served requests of a model, with their
+// times, in output order.
+
+struct FloorRecord {
+  double time;
+  fe::Floor floor;
+  std::uint64_t call = 0;  // id of the served request (0 for a reached floor)
+  double issued = 0.0;     // issue time of the served request
+};
+
+struct Records {
+  std::vector<FloorRecord> floors;
+  std::vector<FloorRecord> served;
+};
+
+struct FloorRecorderState {
+  double clock = 0.0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const FloorRecorderState& s) {
+  return os << "{clock:" << s.clock << "}";
+}
+
+// Not checkpointed: a restored run starts it at the snapshot time ('start').
+class FloorRecorder : public cadmium::Atomic<FloorRecorderState> {
+ public:
+  cadmium::Port<fe::Floor> in;
+  cadmium::Port<fe::Call> served;
+
+  FloorRecorder(const std::string& id, std::shared_ptr<Records> records, double start = 0.0)
+      : cadmium::Atomic<FloorRecorderState>(id, FloorRecorderState{start}), records(std::move(records)) {
+    in = addInPort<fe::Floor>("in");
+    served = addInPort<fe::Call>("served");
+  }
+
+  void internalTransition(FloorRecorderState& /*s*/) const override {}
+  void externalTransition(FloorRecorderState& s, double e) const override {
+    s.clock += e;
+    for (const auto& f : in->getBag()) {
+      records->floors.push_back(FloorRecord{s.clock, f});
+    }
+    for (const auto& c : served->getBag()) {
+      records->served.push_back(FloorRecord{s.clock, c.floor, c.id, c.issued});
+    }
+  }
+  void output(const FloorRecorderState& /*s*/) const override {}
+  [[nodiscard]] double timeAdvance(const FloorRecorderState& /*s*/) const override {
+    return std::numeric_limits<double>::infinity();
+  }
+
+ private:
+  std::shared_ptr<Records> records;  // owned by the test
+};
+
+// Any experiment of top_model/experiment.hpp with its outputs recorded from
+// 'start' on
+template <typename Experiment>
+struct Recorded : public cadmium::Coupled {
+  template <typename... Args>
+  Recorded(const std::string& id, std::shared_ptr<Records> records, double start, Args&&... args)
+      : cadmium::Coupled(id) {
+    auto experiment = addComponent<Experiment>("experiment", std::forward<Args>(args)...);
+    auto recorder = addComponent<FloorRecorder>("recorder", std::move(records), start);
+    addCoupling(experiment->floor_out, recorder->in);
+    addCoupling(experiment->served_out, recorder->served);
+  }
+};
+
+// Outputs of Experiment(args...) run from 0 to 'horizon'
+template <typename Experiment, typename... Args>
+Records record(const std::string& id, double horizon, Args&&... args) {
+  auto records = std::make_shared<Records>();
+  auto model = std::make_shared<Recorded<Experiment>>(id, records, 0.0, std::forward<Args>(args)...);
+  auto root = cadmium::RootCoordinator(model);
+  root.start();
+  root.simulate(horizon);
+  root.stop();
+  return *records;
+}
+
+// Whether the runs 'a' and 'b' (named 'a_name' and 'b_name' in 'why') output
+// the same floors and call ids at near() times
+inline bool same(const char* what, const char* a_name, const std::vector<FloorRecord>& a_records,
+                 const char* b_name, const std::vector<FloorRecord>& b_records, std::string& why) {
+  for (std::size_t i = 0; i < a_records.size() && i < b_records.size(); ++i) {
+    const FloorRecord& a = a_records[i];
+    const FloorRecord& b = b_records[i];
+    if (a.floor != b.floor || a.call != b.call || !near(b.time, a.time)) {
+      char line[240];
+      std::snprintf(line, sizeof(line), "%s %zu: %s floor %d #%llu at %.9g, %s floor %d #%llu at %.9g", what, i,
+                    a_name, a.floor, static_cast<unsigned long long>(a.call), a.time, b_name, b.floor,
+                    static_cast<unsigned long long>(b.call), b.time);
+      why = line;
+      return false;
+    }
+  }
+  if (a_records.size() != b_records.size()) {
+    why = std::to_string(a_records.size()) + " " + a_name + " " + what + " outputs vs "
+          + std::to_string(b_records.size()) + " " + b_name;
+    return false;
+  }
+  return true;
+}
+
+// A single car spanning the profile's floors
+inline fe::ControlConfig make_config(fe::SchedulePolicy policy, const fe::TrafficProfile& profile) {
+  fe::ControlConfig config;
+  config.policy = policy;
+  config.bottom_floor = profile.lobby;
+  config.top_floor = profile.top_floor;
+  return config;
+}
+
+#endif
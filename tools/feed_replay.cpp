@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../data_structures/messages.hpp"
+
+// Replays 'time call' input files over the live feed of freight_elevator_realtime:
+// every call is written to the socket (or named pipe) at its time, scaled to the
+// wall clock by --speed, then the connection is closed.
+//
+//   ./feed_replay <socket|fifo> <inside_calls_file|-> <outside_calls_file|-> [--speed 1]
+
+namespace {
+    struct TimedCall {
+        double time;
+        fe::Call call;
+    };
+
+    void read_calls(const std::string& path, fe::CallSource source, std::vector<TimedCall>& out) {
+        if (path == "-") {
+            return;
+        }
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream ls(line);
+            TimedCall timed {};
+            if (ls >> timed.time >> timed.call) {
+                timed.call.source = source;
+                out.push_back(timed);
+            }
+        }
+    }
+
+    // Connects to the simulator's socket (retrying while it starts) or opens the FIFO.
+    int connect_feed(const std::string& path) {
+        struct stat st {};
+        if (::stat(path.c_str(), &st) == 0 && S_ISFIFO(st.st_mode)) {
+            const int fd = ::open(path.c_str(), O_WRONLY);
+            if (fd < 0) {
+                throw std::runtime_error("cannot open FIFO " + path + ": " + std::strerror(errno));
+            }
+            return fd;
+        }
+        sockaddr_un addr {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("socket path too long: " + path);
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        for (int attempt = 0; attempt < 50; ++attempt) {
+            const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0) {
+                break;
+            }
+            if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0) {
+                return fd;
+            }
+            ::close(fd);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        throw std::runtime_error("cannot connect to " + path);
+    }
+
+    void usage(const char* argv0) {
+        std::fprintf(stderr, "usage: %s <socket|fifo> <inside_calls_file|-> <outside_calls_file|-> [--speed 1]\n",
+                     argv0);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 4 && !(argc == 6 && std::string(argv[4]) == "--speed")) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    double speed = 1.0;
+    try {
+        if (argc == 6) {
+            speed = std::stod(argv[5]);
+        }
+    } catch (const std::exception&) {  // not a number, or out of range
+        speed = 0.0;
+    }
+    if (!(speed > 0.0)) {
+        std::fprintf(stderr, "feed_replay: --speed must be a number > 0, not %s\n", argv[5]);
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        // Merged by time; at equal times inside calls first, then file order
+        std::vector<TimedCall> calls;
+        read_calls(argv[2], fe::CallSource::inside, calls);
+        read_calls(argv[3], fe::CallSource::outside, calls);
+        std::stable_sort(calls.begin(), calls.end(),
+                         [](const TimedCall& a, const TimedCall& b) { return a.time < b.time; });
+
+        std::signal(SIGPIPE, SIG_IGN);  // a closed feed is reported by write()
+        const int fd = connect_feed(argv[1]);
+        const auto start = std::chrono::steady_clock::now();
+        for (const TimedCall& timed : calls) {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(timed.time * 60.0 / speed)));
+            std::ostringstream line;
+            line << timed.call << '\n';
+            const std::string text = line.str();
+            if (::write(fd, text.data(), text.size()) != static_cast<ssize_t>(text.size())) {
+                ::close(fd);
+                throw std::runtime_error("feed closed by the simulator");
+            }
+        }
+        ::close(fd);
+        std::printf("%zu calls replayed to %s\n", calls.size(), argv[1]);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "feed_replay: %s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "../data_structures/binary_log.hpp"
+
+// Rebuilds the CSVLogger output from a binary .felog written by
+// fe::AsyncBinaryLogger.
+//
+//   ./log_decode <input.felog> [output.csv]
+//
+// Writes to stdout when no output file is given.
+int main(int argc, char* argv[]) {
+    if (argc != 2 && argc != 3) {
+        std::fprintf(stderr, "usage: %s <input.felog> [output.csv]\n", argv[0]);
+        return 2;
+    }
+
+    try {
+        std::size_t n = 0;
+        if (argc == 3) {
+            std::ofstream out(argv[2]);
+            if (!out) {
+                std::fprintf(stderr, "log_decode: cannot write %s\n", argv[2]);
+                return 1;
+            }
+            n = fe::decode_binary_log(argv[1], out);
+            std::printf("%zu lines written to %s\n", n, argv[2]);
+        } else {
+            n = fe::decode_binary_log(argv[1], std::cout);
+        }
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "log_decode: %s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
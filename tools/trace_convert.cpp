@@ -0,0 +1,31 @@
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "../data_structures/call_trace.hpp"
+
+// Converts the 'time call' text inputs read by IEStream into one binary
+// .fetrace file for ETraceReader / FreightElevatorTraceExperiment.
+//
+//   ./trace_convert <inside_calls_file> <outside_calls_file> <output.fetrace>
+//
+// Pass "-" for an input that should be skipped.
+int main(int argc, char* argv[]) {
+    if (argc != 4) {
+        std::fprintf(stderr, "usage: %s <inside_calls_file|-> <outside_calls_file|-> <output.fetrace>\n", argv[0]);
+        return 2;
+    }
+    const std::string inside = argv[1];
+    const std::string outside = argv[2];
+
+    try {
+        const std::size_t n = fe::convert_text_trace(inside == "-" ? "" : inside,
+                                                     outside == "-" ? "" : outside,
+                                                     argv[3]);
+        std::printf("%zu calls written to %s\n", n, argv[3]);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "trace_convert: %s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
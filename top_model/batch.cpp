@@ -0,0 +1,220 @@
+#include "batch.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "../data_structures/rng.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+namespace fe {
+
+namespace {
+    constexpr double kNever = std::numeric_limits<double>::infinity();
+}
+
+ElevatorBatch::ElevatorBatch(std::vector<TowerSpec> specs) : towers(std::move(specs)) {
+    const std::size_t n = towers.size();
+    if (n > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("a batch holds at most 2^32 - 1 instances");
+    }
+    call_time.assign(n, kNever);
+    rng.assign(n, 0);
+    phase.assign(n, 0);
+    passenger.assign(n, Passenger{1, 1});
+    record.assign(n, 0);
+    current.assign(n, 1);
+    target.assign(n, 1);
+    moving.assign(n, 0);
+    direction.assign(n, Direction::idle);
+    arrival.assign(n, kNever);
+    departed.assign(n, 0.0);
+    last_id.assign(n, 0);
+    calls.assign(n, 0);
+    served.assign(n, 0);
+    wait.assign(n, RunningStats());
+    trip.assign(n, RunningStats());
+    active.resize(n);
+    arrivals.resize(n);
+    call_bags.resize(n);
+
+    requests.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const TowerSpec& spec = towers[i];
+        requests.emplace_back(spec.control);
+        // the first call, as ETraceReader / ETraffic schedule it at t = 0
+        if (spec.trace) {
+            if (spec.trace->size() != 0) {
+                call_time[i] = std::max(0.0, (*spec.trace)[0].time);
+            }
+        } else {
+            Rng generator(spec.seed);
+            double t = 0.0;
+            if (spec.traffic.next_arrival(t, phase[i], generator)) {
+                passenger[i] = spec.traffic.draw(phase[i], generator);
+                call_time[i] = t;
+            }
+            rng[i] = generator.state;
+        }
+    }
+}
+
+BatchKpi ElevatorBatch::kpi(std::size_t i) const {
+    BatchKpi k;
+    k.calls = calls[i];
+    k.served = served[i];
+    k.wait = wait[i];
+    k.trip = trip[i];
+    return k;
+}
+
+double ElevatorBatch::travel_time(std::size_t i, Floor from, Floor to) const {
+    const auto& travel = towers[i].control.travel;
+    return travel ? travel->trip(from, to) : static_cast<double>(std::abs(to - from));
+}
+
+double ElevatorBatch::motion_time(std::size_t i, Floor from, Floor to) const {
+    const auto& travel = towers[i].control.travel;
+    return travel ? travel->motion(from, to) : static_cast<double>(std::abs(to - from));
+}
+
+void ElevatorBatch::run(double horizon) {
+    const std::size_t n = towers.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        active[i] = static_cast<std::uint32_t>(i);
+    }
+    std::size_t live = n;
+    while (live != 0) {
+        // Next-event kernel: keep the instances with an event before the
+        // horizon and sort them into arrivals and call bags (stores are
+        // unconditional, the counters advance by the flags)
+        const double* arrive_at = arrival.data();
+        const double* call_at = call_time.data();
+        std::uint32_t* ids = active.data();
+        std::uint32_t* car = arrivals.data();
+        std::uint32_t* bag = call_bags.data();
+        std::size_t kept = 0;
+        std::size_t cars = 0;
+        std::size_t bags = 0;
+        for (std::size_t k = 0; k < live; ++k) {
+            const std::uint32_t i = ids[k];
+            const double a = arrive_at[i];
+            const double c = call_at[i];
+            const std::size_t due = std::min(a, c) < horizon;
+            const std::size_t first = a <= c;  // internal before external
+            ids[kept] = i;
+            car[cars] = i;
+            bag[bags] = i;
+            kept += due;
+            cars += due & first;
+            bags += due & (first ^ 1U);
+        }
+        live = kept;
+
+        // Transition kernels
+        for (std::size_t k = 0; k < cars; ++k) {
+            arrive(car[k]);
+        }
+        for (std::size_t k = 0; k < bags; ++k) {
+            take_calls(bag[k]);
+        }
+        transition_count += cars + bags;
+    }
+}
+
+void ElevatorBatch::arrive(std::size_t i) {
+    // EVehicle's fback, EControl's arrival and EMonitor's samples
+    const double now = arrival[i];
+    PendingRequests& r = requests[i];
+    r.arrive_and_serve([&](const Call& call) {
+        const double elapsed = now - call.issued;
+        (call.source == CallSource::outside ? wait[i] : trip[i]).add(elapsed);
+        ++served[i];
+    });
+    current[i] = target[i];
+    moving[i] = 0;
+    arrival[i] = kNever;
+    start_next_if_idle(i, now);
+}
+
+void ElevatorBatch::take_calls(std::size_t i) {
+    const double now = call_time[i];
+    const TowerSpec& spec = towers[i];
+    if (spec.trace) {
+        // every record of this instant; inside calls first, as EControl gets them
+        const TraceFile& trace = *spec.trace;
+        const double t = trace[record[i]].time;
+        std::size_t end = record[i];
+        while (end < trace.size() && trace[end].time == t) {
+            ++end;
+        }
+        for (const CallSource source : {CallSource::inside, CallSource::outside}) {
+            for (std::size_t k = record[i]; k < end; ++k) {
+                const TraceRecord& rec = trace[k];
+                if (rec.source == source) {
+                    Call call;
+                    call.floor = rec.floor;
+                    call.direction = rec.direction;
+                    call.priority = rec.priority;
+                    enqueue(i, call, source, now);
+                }
+            }
+        }
+        calls[i] += end - record[i];
+        record[i] = end;
+        call_time[i] = end < trace.size() ? std::max(now, trace[end].time) : kNever;
+    } else {
+        // one passenger: its car call, then its hall call (see ETraffic)
+        const Passenger p = passenger[i];
+        Call car;
+        car.floor = p.destination;
+        enqueue(i, car, CallSource::inside, now);
+        Call hall;
+        hall.floor = p.origin;
+        hall.direction = p.destination > p.origin ? Direction::up : Direction::down;
+        enqueue(i, hall, CallSource::outside, now);
+        calls[i] += 2;
+
+        Rng generator(rng[i]);  // the state is the seed
+        double t = now;
+        if (spec.traffic.next_arrival(t, phase[i], generator)) {
+            passenger[i] = spec.traffic.draw(phase[i], generator);
+            call_time[i] = t;
+        } else {
+            call_time[i] = kNever;
+        }
+        rng[i] = generator.state;
+    }
+    start_next_if_idle(i, now);
+}
+
+void ElevatorBatch::enqueue(std::size_t i, Call call, CallSource source, double now) {
+    const ControlConfig& config = towers[i].control;
+    PendingRequests& r = requests[i];
+    stamp(call, source, now, last_id[i]);
+    // a request for the floor the trip in progress stops at rides along
+    const bool on_trip = moving[i] && call.floor == target[i];
+    const Admission admission = on_trip ? r.ride(call) : r.push(call);
+    if (config.en_route && moving[i] && admission != Admission::refused
+        && can_stop_en_route(config, current[i], target[i], call.floor, now - departed[i])) {
+        // the same departure, less motion (door dwell unchanged)
+        const double shorter = motion_time(i, current[i], target[i]) - motion_time(i, current[i], call.floor);
+        arrival[i] = std::max(now, arrival[i] - shorter);
+        r.divert(target[i], call.floor);
+        target[i] = call.floor;
+    }
+}
+
+void ElevatorBatch::start_next_if_idle(std::size_t i, double now) {
+    PendingRequests& r = requests[i];
+    if (!moving[i] && !r.empty()) {
+        target[i] = r.pop_next(current[i], direction[i], towers[i].control);
+        moving[i] = 1;
+        departed[i] = now;
+        arrival[i] = now + travel_time(i, current[i], target[i]);
+    }
+}
+
+}
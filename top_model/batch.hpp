@@ -0,0 +1,101 @@
+#ifndef FE_BATCH_HPP
+#define FE_BATCH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "site.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+namespace fe {
+    // Totals of one batch instance: what EMonitor keeps in fe::RunKpi,
+    // without the histograms (they would cost 40 KB per instance).
+    struct BatchKpi {
+        std::uint64_t calls = 0;    // outside + inside calls seen
+        std::uint64_t served = 0;   // calls reported as served
+        RunningStats wait;          // outside call -> car reaches the origin floor
+        RunningStats trip;          // inside call -> car reaches the destination floor
+    };
+
+    /**
+     * Many independent single-car towers simulated in lockstep, without a
+     * coordinator: for fleet-wide what-if studies over thousands of
+     * configurations (one fe::TowerSpec per instance: its traffic profile
+     * and seed or its call trace, and its ControlConfig).
+     * - Each instance is the FreightTower of site.hpp with an EMonitor: its
+     *   call source, EControl/EVehicle (as EFused merges them) and KPIs.
+     * - The state is stored as structure-of-arrays: one column per field of
+     *   the source, controller and vehicle states (next call time, car
+     *   floor, target, arrival time...), indexed by instance. Only the
+     *   pending requests stay one fe::PendingRequests per instance.
+     * - A round gives every instance with an event before the horizon one
+     *   transition. The next-event kernel is a branch-free pass over the
+     *   time columns that also compacts the instances into arrivals and
+     *   call bags; each transition kernel then runs over its own list.
+     *   A car arrival at the instant of a call goes first, as in EFused's
+     *   confluent transition.
+     * - Instances see the events of the Cadmium model at the same times, so
+     *   calls and served counts are identical and wait and trip means agree
+     *   to rounding (the coordinator accumulates elapsed times, the batch
+     *   keeps absolute ones). Every ControlConfig option is honoured;
+     *   ControlConfig::routes changes no output and is ignored.
+     */
+    class ElevatorBatch {
+    public:
+        explicit ElevatorBatch(std::vector<TowerSpec> towers);
+
+        // Runs every instance through the events before 'horizon' (later
+        // calls continue from there, with a later horizon).
+        void run(double horizon);
+
+        [[nodiscard]] std::size_t size() const { return towers.size(); }
+        [[nodiscard]] const TowerSpec& tower(std::size_t i) const { return towers[i]; }
+        [[nodiscard]] BatchKpi kpi(std::size_t i) const;
+        [[nodiscard]] std::uint64_t transitions() const { return transition_count; }
+
+    private:
+        void arrive(std::size_t i);
+        void take_calls(std::size_t i);
+        void enqueue(std::size_t i, Call call, CallSource source, double now);
+        void start_next_if_idle(std::size_t i, double now);
+        [[nodiscard]] double travel_time(std::size_t i, Floor from, Floor to) const;
+        [[nodiscard]] double motion_time(std::size_t i, Floor from, Floor to) const;
+
+        std::vector<TowerSpec> towers;
+
+        // Call sources (ETraffic or ETraceReader)
+        std::vector<double> call_time;         // next call bag (infinity: none)
+        std::vector<std::uint64_t> rng;        // traffic: generator state
+        std::vector<std::size_t> phase;        // traffic: profile phase of the next passenger
+        std::vector<Passenger> passenger;      // traffic: the next passenger
+        std::vector<std::size_t> record;       // trace: next record
+
+        // Cars (EControl and EVehicle)
+        std::vector<Floor> current;
+        std::vector<Floor> target;
+        std::vector<std::uint8_t> moving;
+        std::vector<Direction> direction;
+        std::vector<double> arrival;           // car reaches target (infinity: idle)
+        std::vector<double> departed;          // trip start (en-route stops)
+        std::vector<std::uint64_t> last_id;    // call stamping
+        std::vector<PendingRequests> requests;
+
+        // KPIs (EMonitor)
+        std::vector<std::uint64_t> calls;
+        std::vector<std::uint64_t> served;
+        std::vector<RunningStats> wait;
+        std::vector<RunningStats> trip;
+
+        // Round scratch: instances still running, and this round's events
+        std::vector<std::uint32_t> active;
+        std::vector<std::uint32_t> arrivals;
+        std::vector<std::uint32_t> call_bags;
+        std::uint64_t transition_count = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef ELEVATOR_BANK_HPP
+#define ELEVATOR_BANK_HPP
+
+#include <memory>
+#include <string>
+
+#include "cadmium/modeling/devs/coupled.hpp"
+#include "../atomics/ecall.hpp"
+#include "../atomics/edispatch.hpp"
+#include "../atomics/efused.hpp"
+#include "elevator_coupled.hpp"
+#include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
+
+/**
+ * Elevator bank coupled model:
+ * ECall -> EDispatch -> ElevatorCoupled[0..N-1]
+ *                 ^------------ floor, served, rejected (per car)
+ *
+ * The number of cars is fixed at construction time; every car shares the
+ * same controller configuration. With 'fused' every car is a single EFused
+ * atomic instead of an ElevatorCoupled (same floor outputs, fewer events).
+ *
+ * in : inside_call, outside_call
+ * out: floor (reached floors of every car), served (their completed requests),
+ *      rejected (requests a full car refused)
+ */
+struct ElevatorBank : public Coupled {
+    Port<fe::Call> inside_call;
+    Port<fe::Call> outside_call;
+    Port<fe::Floor> floor;
+    Port<fe::Call> served;
+    Port<fe::Call> rejected;
+    std::shared_ptr<EDispatch> dispatch;  // the group dispatcher (inspected by tests)
+
+    ElevatorBank(const std::string& id, std::size_t cars,
+                 const fe::ControlConfig& config = fe::ControlConfig(),
+                 bool fused = false,
+                 const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr)
+        : Coupled(id) {
+        inside_call = addInPort<fe::Call>("inside_call");
+        outside_call = addInPort<fe::Call>("outside_call");
+        floor = addOutPort<fe::Floor>("floor");
+        served = addOutPort<fe::Call>("served");
+        rejected = addOutPort<fe::Call>("rejected");
+
+        auto call = addComponent<ECall>("Ecall", checkpoint);
+        dispatch = addComponent<EDispatch>("Edispatch", cars, config.travel, checkpoint);
+
+        // EIC
+        addCoupling(inside_call, call->inside_call);
+        addCoupling(outside_call, call->outside_call);
+
+        // IC
+        addCoupling(call->call_gen, dispatch->call_in);
+
+        for (std::size_t i = 0; i < cars; ++i) {
+            const std::string name = "Elevator_" + std::to_string(i);
+            if (fused) {
+                auto elevator = addComponent<EFused>(name, config, checkpoint);
+
+                // IC
+                addCoupling(dispatch->car_call[i], elevator->outside_call);
+                addCoupling(elevator->floor, dispatch->car_floor[i]);
+                addCoupling(elevator->served, dispatch->car_served[i]);
+                addCoupling(elevator->rejected, dispatch->car_rejected[i]);
+
+                // EOC
+                addCoupling(elevator->floor, floor);
+                addCoupling(elevator->served, served);
+                addCoupling(elevator->rejected, rejected);
+            } else {
+                auto elevator = addComponent<ElevatorCoupled>(name, config, checkpoint);
+
+                // IC
+                addCoupling(dispatch->car_call[i], elevator->acall);
+                addCoupling(elevator->floor, dispatch->car_floor[i]);
+                addCoupling(elevator->served, dispatch->car_served[i]);
+                addCoupling(elevator->rejected, dispatch->car_rejected[i]);
+
+                // EOC
+                addCoupling(elevator->floor, floor);
+                addCoupling(elevator->served, served);
+                addCoupling(elevator->rejected, rejected);
+            }
+        }
+    }
+};
+
+#endif
@@ -1,39 +1,68 @@
 #ifndef ELEVATOR_COUPLED_HPP
 #define ELEVATOR_COUPLED_HPP
 
+#include <memory>
+
 #include "cadmium/modeling/devs/coupled.hpp"
 #include "../atomics/econtrol.hpp"
 #include "../atomics/evehicle.hpp"
 #include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
 
 /**
  * Elevator coupled model:
  * EControl <-> EVehicle
  *
  * in : acall
- * out: floor
+ * out: floor, served, rejected (requests refused when full), timem (EControl's
+ *      travel commands, for monitoring)
+ *
+ * Under fe::ControlConfig::routes the controller commands the vehicle with
+ * fe::Route messages instead of one travel time per stop.
+ *
+ * Time is the atomics' time type (see fe::TimeBase); ElevatorCoupled keeps
+ * them in double minutes.
  */
-struct ElevatorCoupled : public Coupled {
-    Port<fe::Floor> acall;
+template <typename Time>
+struct ElevatorCoupledT : public Coupled {
+    Port<fe::Call> acall;
     Port<fe::Floor> floor;
+    Port<fe::Call> served;
+    Port<fe::Call> rejected;
+    Port<fe::TravelTime> timem;
 
-    explicit ElevatorCoupled(const std::string& id) : Coupled(id) {
-        acall = addInPort<fe::Floor>("acall");
+    explicit ElevatorCoupledT(const std::string& id, const fe::ControlConfig& config = fe::ControlConfig(),
+                              const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr)
+        : Coupled(id) {
+        acall = addInPort<fe::Call>("acall");
         floor = addOutPort<fe::Floor>("floor");
+        served = addOutPort<fe::Call>("served");
+        rejected = addOutPort<fe::Call>("rejected");
+        timem = addOutPort<fe::TravelTime>("timem");
 
-        auto control = addComponent<EControl>("Econtrol");
-        auto vehicle = addComponent<EVehicle>("Evehicle");
+        auto control = addComponent<EControlT<Time>>("Econtrol", config, checkpoint);
+        auto vehicle = addComponent<EVehicleT<Time>>("Evehicle", config.travel, config.en_route, checkpoint);
 
         // EIC
         addCoupling(acall, control->acall);
 
-        // IC
-        addCoupling(control->timem, vehicle->in);
+        // IC: travel times, or whole routes (timem is then only monitored)
+        if (fe::uses_routes(config)) {
+            addCoupling(control->route, vehicle->route);
+        } else {
+            addCoupling(control->timem, vehicle->in);
+        }
         addCoupling(vehicle->out, control->fback);
 
         // EOC
         addCoupling(control->floor, floor);
+        addCoupling(control->served, served);
+        addCoupling(control->rejected, rejected);
+        addCoupling(control->timem, timem);
     }
 };
 
+using ElevatorCoupled = ElevatorCoupledT<double>;
+
 #endif
@@ -4,30 +4,232 @@
 #include "cadmium/modeling/devs/coupled.hpp"
 #include "cadmium/lib/iestream.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "freight_elevator_top.hpp"
+#include "elevator_bank.hpp"
+#include "../atomics/efused.hpp"
+#include "../atomics/emonitor.hpp"
+#include "../atomics/eport_log.hpp"
+#include "../atomics/etrace_reader.hpp"
+#include "../atomics/etraffic.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+/**
+ * Attaches an EMonitor to 'experiment' observing the given call, served and
+ * rejected ports, if the caller asked for KPIs.
+ */
+inline void add_kpi_monitor(Coupled& experiment,
+                            const Port<fe::Call>& inside_call,
+                            const Port<fe::Call>& outside_call,
+                            const Port<fe::Call>& served,
+                            const Port<fe::Call>& rejected,
+                            std::shared_ptr<fe::RunKpi> kpi,
+                            const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr) {
+    if (!kpi) {
+        return;
+    }
+    auto monitor = experiment.addComponent<EMonitor>("monitor", std::move(kpi), checkpoint);
+    experiment.addCoupling(inside_call, monitor->inside_call);
+    experiment.addCoupling(outside_call, monitor->outside_call);
+    experiment.addCoupling(served, monitor->served);
+    experiment.addCoupling(rejected, monitor->rejected);
+}
+
+// Output ports of the system under test
+struct SystemPorts {
+    Port<fe::Floor> floor;
+    Port<fe::Call> served;
+    Port<fe::Call> rejected;
+};
+
+/**
+ * Adds the single-car system to 'experiment' and couples the two call ports
+ * to it: FreightElevatorTop, or one EFused atomic when 'fused' is set (same
+ * outputs without the coupled hierarchy). Returns its output ports.
+ */
+inline SystemPorts add_single_car(Coupled& experiment,
+                                  const Port<fe::Call>& inside_call,
+                                  const Port<fe::Call>& outside_call,
+                                  const fe::ControlConfig& config,
+                                  bool fused,
+                                  const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr) {
+    if (fused) {
+        auto system = experiment.addComponent<EFused>("freight_elevator", config, checkpoint);
+        experiment.addCoupling(inside_call, system->inside_call);
+        experiment.addCoupling(outside_call, system->outside_call);
+        return SystemPorts{system->floor, system->served, system->rejected};
+    }
+    auto system = experiment.addComponent<FreightElevatorTop>("freight_elevator", config, checkpoint);
+    experiment.addCoupling(inside_call, system->inside_call);
+    experiment.addCoupling(outside_call, system->outside_call);
+    return SystemPorts{system->floor, system->served, system->rejected};
+}
 
 /**
  * Experiment coupled model:
  * - Two IEStreams feed inside/outside call ports
- * - Exposes the system output port so main() can log it
+ * - Exposes the system output ports (reached floors, served requests) so
+ *   main() can log them
+ * - Optionally collects KPI histograms into 'kpi' (EMonitor)
+ * - Optionally runs the fused single-atomic model (see add_single_car)
  */
 struct FreightElevatorExperiment : public Coupled {
     Port<fe::Floor> floor_out;
+    Port<fe::Call> served_out;
 
     FreightElevatorExperiment(const std::string& id,
                               const std::string& inside_calls_file,
-                              const std::string& outside_calls_file)
+                              const std::string& outside_calls_file,
+                              const fe::ControlConfig& config = fe::ControlConfig(),
+                              std::shared_ptr<fe::RunKpi> kpi = nullptr,
+                              bool fused = false)
         : Coupled(id) {
 
         floor_out = addOutPort<fe::Floor>("floor_out");
+        served_out = addOutPort<fe::Call>("served_out");
 
-        auto inside_calls = addComponent<cadmium::lib::IEStream<fe::Floor>>("inside_calls", inside_calls_file);
-        auto outside_calls = addComponent<cadmium::lib::IEStream<fe::Floor>>("outside_calls", outside_calls_file);
-        auto system = addComponent<FreightElevatorTop>("freight_elevator");
+        auto inside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("inside_calls", inside_calls_file);
+        auto outside_calls = addComponent<cadmium::lib::IEStream<fe::Call>>("outside_calls", outside_calls_file);
+        auto system = add_single_car(*this, inside_calls->out, outside_calls->out, config, fused);
+        addCoupling(system.floor, floor_out);
+        addCoupling(system.served, served_out);
+
+        add_kpi_monitor(*this, inside_calls->out, outside_calls->out, system.served, system.rejected, std::move(kpi));
+    }
+};
 
-        addCoupling(inside_calls->out, system->inside_call);
-        addCoupling(outside_calls->out, system->outside_call);
-        addCoupling(system->floor, floor_out);
+/**
+ * Same experiment fed by a binary call trace (.fetrace) instead of the two
+ * text IEStreams; see tools/trace_convert.cpp to build one from the text files.
+ * Every atomic is checkpointable, so a run can be saved to / restored from a
+ * snapshot through 'checkpoint' (see data_structures/snapshot.hpp).
+ */
+struct FreightElevatorTraceExperiment : public Coupled {
+    Port<fe::Floor> floor_out;
+    Port<fe::Call> served_out;
+
+    FreightElevatorTraceExperiment(const std::string& id,
+                                   const std::string& trace_file,
+                                   const fe::ControlConfig& config = fe::ControlConfig(),
+                                   std::shared_ptr<fe::RunKpi> kpi = nullptr,
+                                   bool fused = false,
+                                   const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr)
+        : Coupled(id) {
+
+        floor_out = addOutPort<fe::Floor>("floor_out");
+        served_out = addOutPort<fe::Call>("served_out");
+
+        auto calls = addComponent<ETraceReader>("calls", std::make_shared<const fe::TraceFile>(trace_file),
+                                                checkpoint);
+        auto system = add_single_car(*this, calls->inside_call, calls->outside_call, config, fused, checkpoint);
+        addCoupling(system.floor, floor_out);
+        addCoupling(system.served, served_out);
+
+        add_kpi_monitor(*this, calls->inside_call, calls->outside_call, system.served, system.rejected, std::move(kpi), checkpoint);
+    }
+};
+
+/**
+ * Same experiment driven by the in-model ETraffic generator instead of input
+ * files; the run is fully determined by the profile and the seed (and, when
+ * restored, by the snapshot). Checkpointable like the trace experiment.
+ */
+struct FreightElevatorTrafficExperiment : public Coupled {
+    Port<fe::Floor> floor_out;
+    Port<fe::Call> served_out;
+
+    FreightElevatorTrafficExperiment(const std::string& id,
+                                     const fe::TrafficProfile& profile,
+                                     std::uint64_t seed,
+                                     const fe::ControlConfig& config = fe::ControlConfig(),
+                                     std::shared_ptr<fe::RunKpi> kpi = nullptr,
+                                     bool fused = false,
+                                     const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr)
+        : Coupled(id) {
+
+        floor_out = addOutPort<fe::Floor>("floor_out");
+        served_out = addOutPort<fe::Call>("served_out");
+
+        auto traffic = addComponent<ETraffic>("traffic", profile, seed, checkpoint);
+        auto system = add_single_car(*this, traffic->inside_call, traffic->outside_call, config, fused, checkpoint);
+        addCoupling(system.floor, floor_out);
+        addCoupling(system.served, served_out);
+
+        add_kpi_monitor(*this, traffic->inside_call, traffic->outside_call, system.served, system.rejected, std::move(kpi), checkpoint);
+    }
+};
+
+/**
+ * Elevator bank driven by ETraffic, with an EMonitor accumulating the run's
+ * KPIs into 'kpi'. Used by the parameter sweep (one instance per replication,
+ * each restored from the point's warm-up snapshot when --warmup is set).
+ */
+struct ElevatorBankTrafficExperiment : public Coupled {
+    Port<fe::Floor> floor_out;
+    Port<fe::Call> served_out;
+
+    ElevatorBankTrafficExperiment(const std::string& id,
+                                  std::size_t cars,
+                                  const fe::TrafficProfile& profile,
+                                  std::uint64_t seed,
+                                  const fe::ControlConfig& config,
+                                  std::shared_ptr<fe::RunKpi> kpi,
+                                  bool fused = false,
+                                  const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr)
+        : Coupled(id) {
+
+        floor_out = addOutPort<fe::Floor>("floor_out");
+        served_out = addOutPort<fe::Call>("served_out");
+
+        auto traffic = addComponent<ETraffic>("traffic", profile, seed, checkpoint);
+        auto bank = addComponent<ElevatorBank>("bank", cars, config, fused, checkpoint);
+
+        addCoupling(traffic->inside_call, bank->inside_call);
+        addCoupling(traffic->outside_call, bank->outside_call);
+        addCoupling(bank->floor, floor_out);
+        addCoupling(bank->served, served_out);
+
+        add_kpi_monitor(*this, traffic->inside_call, traffic->outside_call, bank->served, bank->rejected, std::move(kpi), checkpoint);
+    }
+};
+
+/**
+ * Any experiment above with some of its output ports (floor_out,
+ * served_out) logged through 'logger' by EPortLog sinks, for a run with no
+ * coordinator logger (--log ports=...). The experiment keeps the id 'id'
+ * and the records name it as their model. Throws std::invalid_argument for
+ * another port name.
+ */
+template <typename Experiment>
+struct PortLoggedExperiment : public Coupled {
+    template <typename... Args>
+    PortLoggedExperiment(const std::string& id,
+                         const std::shared_ptr<cadmium::Logger>& logger,
+                         const std::vector<std::string>& ports,
+                         double start_time,
+                         Args&&... args)
+        : Coupled(id + "_log") {
+        auto experiment = addComponent<Experiment>(id, std::forward<Args>(args)...);
+        for (const auto& port : ports) {
+            if (port == "floor_out") {
+                auto sink = addComponent<EPortLog<fe::Floor>>("floor_out_log", logger, id, port, start_time);
+                addCoupling(experiment->floor_out, sink->in);
+            } else if (port == "served_out") {
+                auto sink = addComponent<EPortLog<fe::Call>>("served_out_log", logger, id, port, start_time);
+                addCoupling(experiment->served_out, sink->in);
+            } else {
+                throw std::invalid_argument("no output port " + port + " to log (floor_out or served_out)");
+            }
+        }
     }
 };
 
@@ -1,30 +1,48 @@
 #ifndef FREIGHT_ELEVATOR_TOP_HPP
 #define FREIGHT_ELEVATOR_TOP_HPP
 
+#include <memory>
+
 #include "cadmium/modeling/devs/coupled.hpp"
 #include "../atomics/ecall.hpp"
 #include "elevator_coupled.hpp"
 #include "../data_structures/messages.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
 
 /**
  * Freight Elevator Top coupled model:
  * ECall -> ElevatorCoupled
  *
  * in : inside_call, outside_call
- * out: floor
+ * out: floor, served (requests completed at each floor reached),
+ *      rejected (requests refused when the controller is full),
+ *      timem (travel commands, for monitoring)
+ *
+ * Time is the atomics' time type (see fe::TimeBase): FreightElevatorTop runs
+ * on double minutes, FreightElevatorTopT<fe::Ticks> on integer ticks.
  */
-struct FreightElevatorTop : public Coupled {
-    Port<fe::Floor> inside_call;
-    Port<fe::Floor> outside_call;
+template <typename Time>
+struct FreightElevatorTopT : public Coupled {
+    Port<fe::Call> inside_call;
+    Port<fe::Call> outside_call;
     Port<fe::Floor> floor;
+    Port<fe::Call> served;
+    Port<fe::Call> rejected;
+    Port<fe::TravelTime> timem;
 
-    explicit FreightElevatorTop(const std::string& id) : Coupled(id) {
-        inside_call = addInPort<fe::Floor>("inside_call");
-        outside_call = addInPort<fe::Floor>("outside_call");
+    explicit FreightElevatorTopT(const std::string& id, const fe::ControlConfig& config = fe::ControlConfig(),
+                                 const std::shared_ptr<fe::Checkpoint>& checkpoint = nullptr)
+        : Coupled(id) {
+        inside_call = addInPort<fe::Call>("inside_call");
+        outside_call = addInPort<fe::Call>("outside_call");
         floor = addOutPort<fe::Floor>("floor");
+        served = addOutPort<fe::Call>("served");
+        rejected = addOutPort<fe::Call>("rejected");
+        timem = addOutPort<fe::TravelTime>("timem");
 
-        auto call = addComponent<ECall>("Ecall");
-        auto elevator = addComponent<ElevatorCoupled>("Elevator");
+        auto call = addComponent<ECallT<Time>>("Ecall", checkpoint);
+        auto elevator = addComponent<ElevatorCoupledT<Time>>("Elevator", config, checkpoint);
 
         // EIC
         addCoupling(inside_call, call->inside_call);
@@ -35,7 +53,12 @@ struct FreightElevatorTop : public Coupled {
 
         // EOC
         addCoupling(elevator->floor, floor);
+        addCoupling(elevator->served, served);
+        addCoupling(elevator->rejected, rejected);
+        addCoupling(elevator->timem, timem);
     }
 };
 
+using FreightElevatorTop = FreightElevatorTopT<double>;
+
 #endif
@@ -1,28 +1,285 @@
 #include <cadmium/core/logger/csv.hpp>
 #include <cadmium/core/simulation/root_coordinator.hpp>
+#include <chrono>
+#include <fstream>
+#include <iostream>
 #include <limits>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "experiment.hpp"
+#include "../data_structures/binary_log.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/instrument.hpp"
+#include "../data_structures/log_select.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/vehicle_profile.hpp"
 
-int main(int argc, char** argv) {
+namespace {
+    void usage(const char* argv0) {
+        std::cerr << "usage: " << argv0 << " [inside_calls.txt outside_calls.txt | calls.fetrace] [policy] [options]\n"
+                     "  policy: fifo (default), scan, look, nearest or lookahead\n"
+                     "  --fused  --binary-log  --en-route  --routes\n"
+                     "  --vehicle FILE  --capacity N  --overflow drop|reject|coalesce  --lookahead MIN\n"
+                     "  --floors LO HI  --until T|drained  --log all|none|ports=P,...|models=M,...  --out FILE\n"
+                     "  --save-snapshot T FILE  --restore FILE\n";
+    }
+}
+
+int main(int raw_argc, char** raw_argv) {
     // You can pass input file paths from the command line to avoid hard-coding:
-    //   ./bin/freight_elevator_top input_data/inside.txt input_data/outside.txt
-    std::string inside_path = (argc > 1) ? argv[1] : "../input_data/inside_calls.txt";
-    std::string outside_path = (argc > 2) ? argv[2] : "../input_data/outside_calls.txt";
+    //   ./bin/freight_elevator_top input_data/inside.txt input_data/outside.txt [policy]
+    // or a binary trace built by trace_convert:
+    //   ./bin/freight_elevator_top calls.fetrace [policy]
+    // Add --binary-log anywhere to log through the asynchronous binary logger
+    // (decode the .felog with log_decode), and --fused to run the single
+    // EFused atomic instead of the coupled model (same floor outputs).
+    // With a .fetrace input, '--save-snapshot T FILE' saves the model state
+    // at minute T and '--restore FILE' resumes a run from such a snapshot.
+    // '--vehicle FILE' times trips with a vehicle profile (see
+    // input_data/vehicle_freight.txt) instead of 1 minute per floor.
+    // '--capacity N' caps the calls the controller holds (at most
+    // FE_REQUEST_CAPACITY) and '--overflow drop|reject|coalesce' picks what
+    // happens to the next one (refused calls are logged on 'rejected').
+    // Without them the controller holds up to FE_REQUEST_CAPACITY (64)
+    // calls and rejects the rest; it used to hold any number of calls.
+    // '--en-route' lets a moving car stop for calls on its way, and
+    // '--routes' sends the car its planned stops as one route command.
+    // '--lookahead MIN' sets how far the lookahead policy simulates ahead.
+    // '--floors LO HI' sets the shaft ends SCAN sweeps to (default: the
+    // vehicle profile's floors, else the lowest and highest floor called).
+    // '--until T' ends the run at minute T (default 50) and '--until drained'
+    // once the input is exhausted and every model is passive (all calls
+    // served). '--log all|none|ports=P,...|models=M,...' picks what is
+    // logged (see fe::LogSelection) and '--out FILE' where. A malformed
+    // number, policy or selection, or an input file, vehicle profile or
+    // snapshot that cannot be read, prints the usage and exits with status 2.
+    double end_time = 50.0;  // minutes
+    bool binary_log = false;
+    bool fused = false;
+    bool en_route = false;
+    bool routes = false;
+    double snapshot_at = -1.0;
+    std::string snapshot_out;
+    std::string snapshot_in;
+    std::string vehicle_path;
+    std::string capacity;
+    std::string overflow;
+    std::string lookahead;
+    std::string floors_low;
+    std::string floors_high;
+    std::string log_path;
+    fe::LogSelection log;
+    fe::ControlConfig config;
+    std::string inside_path;
+    std::string outside_path;
+    bool use_trace = false;
+    auto restore_start = std::chrono::steady_clock::now();
+    std::shared_ptr<fe::Checkpoint> checkpoint;
+    double start_time = 0.0;
+    // Wait/trip/queue histograms, summarised at the end of the run
+    auto kpi = std::make_shared<fe::RunKpi>();
+    std::shared_ptr<cadmium::Logger> logger;
+    bool port_log = false;
+    std::shared_ptr<Coupled> model;
+    try {
+        std::vector<char*> args;
+        for (int i = 0; i < raw_argc; ++i) {
+            if (std::string(raw_argv[i]) == "--binary-log") {
+                binary_log = true;
+            } else if (std::string(raw_argv[i]) == "--fused") {
+                fused = true;
+            } else if (std::string(raw_argv[i]) == "--en-route") {
+                en_route = true;
+            } else if (std::string(raw_argv[i]) == "--routes") {
+                routes = true;
+            } else if (std::string(raw_argv[i]) == "--save-snapshot" && i + 2 < raw_argc) {
+                snapshot_at = std::stod(raw_argv[i + 1]);
+                snapshot_out = raw_argv[i + 2];
+                i += 2;
+            } else if (std::string(raw_argv[i]) == "--restore" && i + 1 < raw_argc) {
+                snapshot_in = raw_argv[++i];
+            } else if (std::string(raw_argv[i]) == "--vehicle" && i + 1 < raw_argc) {
+                vehicle_path = raw_argv[++i];
+            } else if (std::string(raw_argv[i]) == "--capacity" && i + 1 < raw_argc) {
+                capacity = raw_argv[++i];
+            } else if (std::string(raw_argv[i]) == "--overflow" && i + 1 < raw_argc) {
+                overflow = raw_argv[++i];
+            } else if (std::string(raw_argv[i]) == "--lookahead" && i + 1 < raw_argc) {
+                lookahead = raw_argv[++i];
+            } else if (std::string(raw_argv[i]) == "--floors" && i + 2 < raw_argc) {
+                floors_low = raw_argv[i + 1];
+                floors_high = raw_argv[i + 2];
+                i += 2;
+            } else if (std::string(raw_argv[i]) == "--until" && i + 1 < raw_argc) {
+                const std::string until = raw_argv[++i];
+                end_time = until == "drained" ? std::numeric_limits<double>::infinity() : std::stod(until);
+            } else if (std::string(raw_argv[i]) == "--log" && i + 1 < raw_argc) {
+                log = fe::parse_log_selection(raw_argv[++i]);
+            } else if (std::string(raw_argv[i]) == "--out" && i + 1 < raw_argc) {
+                log_path = raw_argv[++i];
+            } else {
+                args.push_back(raw_argv[i]);
+            }
+        }
+        const int argc = static_cast<int>(args.size());
+        char** argv = args.data();
+
+        inside_path = (argc > 1) ? argv[1] : "../input_data/inside_calls.txt";
+        const std::string trace_ext = ".fetrace";
+        use_trace = inside_path.size() > trace_ext.size()
+            && inside_path.compare(inside_path.size() - trace_ext.size(), trace_ext.size(), trace_ext) == 0;
+        const int policy_arg = use_trace ? 2 : 3;
+        outside_path = (!use_trace && argc > 2) ? argv[2] : "../input_data/outside_calls.txt";
+
+        // Optional scheduling policy: fifo (default), scan, look, nearest or lookahead
+        if (argc > policy_arg) {
+            config.policy = fe::parse_policy(argv[policy_arg]);
+        }
+        if (!vehicle_path.empty()) {
+            config.travel = std::make_shared<const fe::TravelTable>(fe::VehicleProfile::load(vehicle_path));
+        }
+        if (!capacity.empty()) {
+            config.request_capacity = std::stoul(capacity);
+        }
+        if (!overflow.empty()) {
+            config.overflow = fe::parse_overflow(overflow);
+        }
+        if (!lookahead.empty()) {
+            config.lookahead = std::stod(lookahead);
+        }
+        config.en_route = en_route;
+        config.routes = routes;
+        if (!floors_low.empty()) {
+            config.bottom_floor = std::stoi(floors_low);
+            config.top_floor = std::stoi(floors_high);
+        } else if (config.travel) {
+            config.bottom_floor = config.travel->lowest();
+            config.top_floor = config.travel->top();
+        } else if (config.policy == fe::SchedulePolicy::scan) {
+            // only SCAN goes past the calls; the inputs are read once more for it
+            if (use_trace) {
+                fe::floor_range(fe::TraceFile(inside_path), config.bottom_floor, config.top_floor);
+            } else {
+                fe::floor_range(inside_path, outside_path, config.bottom_floor, config.top_floor);
+            }
+        }
+        fe::PendingRequests{config};  // throws if --capacity is out of range
+
+        if (!use_trace && (!snapshot_out.empty() || !snapshot_in.empty())) {
+            throw std::invalid_argument("snapshots need a .fetrace input (text inputs cannot be restored)");
+        }
+        restore_start = std::chrono::steady_clock::now();
+        if (!snapshot_in.empty()) {
+            checkpoint = std::make_shared<fe::Checkpoint>(
+                std::make_shared<const fe::Snapshot>(fe::Snapshot::load(snapshot_in)));
+        } else if (!snapshot_out.empty()) {
+            checkpoint = std::make_shared<fe::Checkpoint>();
+        }
 
-    auto model = std::make_shared<FreightElevatorExperiment>("freight_elevator_experiment",
-                                                             inside_path,
-                                                             outside_path);
+        start_time = checkpoint ? checkpoint->start_time() : 0.0;
 
-    auto rootCoordinator = cadmium::RootCoordinator(model);
-    auto logger = std::make_shared<cadmium::CSVLogger>("../simulation_results/freight_elevator_top.csv", ";");
-    rootCoordinator.setLogger(logger);
+        if (log.mode != fe::LogSelection::Mode::none) {
+            if (log_path.empty()) {
+                log_path = binary_log ? "../simulation_results/freight_elevator_top.felog"
+                                      : "../simulation_results/freight_elevator_top.csv";
+            }
+            if (binary_log) {
+                logger = std::make_shared<fe::AsyncBinaryLogger>(log_path);
+            } else {
+                logger = std::make_shared<cadmium::CSVLogger>(log_path, ";");
+            }
+            if (log.mode == fe::LogSelection::Mode::models) {
+                logger = std::make_shared<fe::FilteredLogger>(logger, log.names);
+            }
+        }
 
+        // With --log ports=..., EPortLog sinks write the chosen ports and the
+        // coordinator gets no logger
+        port_log = log.mode == fe::LogSelection::Mode::ports;
+        if (use_trace && port_log) {
+            model = std::make_shared<PortLoggedExperiment<FreightElevatorTraceExperiment>>(
+                "freight_elevator_experiment", logger, log.names, start_time, inside_path, config, kpi, fused,
+                checkpoint);
+        } else if (use_trace) {
+            model = std::make_shared<FreightElevatorTraceExperiment>("freight_elevator_experiment",
+                                                                     inside_path,
+                                                                     config,
+                                                                     kpi,
+                                                                     fused,
+                                                                     checkpoint);
+        } else if (port_log) {
+            model = std::make_shared<PortLoggedExperiment<FreightElevatorExperiment>>(
+                "freight_elevator_experiment", logger, log.names, start_time, inside_path, outside_path, config, kpi,
+                fused);
+        } else {
+            model = std::make_shared<FreightElevatorExperiment>("freight_elevator_experiment",
+                                                                inside_path,
+                                                                outside_path,
+                                                                config,
+                                                                kpi,
+                                                                fused);
+        }
+    } catch (const std::invalid_argument& ex) {
+        std::cerr << "bad argument: " << ex.what() << std::endl;
+        usage(raw_argv[0]);
+        return 2;
+    } catch (const std::out_of_range& ex) {
+        std::cerr << "argument out of range: " << ex.what() << std::endl;
+        usage(raw_argv[0]);
+        return 2;
+    } catch (const std::runtime_error& ex) {
+        // unreadable or malformed vehicle profile, call file, trace or snapshot,
+        // or a snapshot of another model
+        std::cerr << "bad input: " << ex.what() << std::endl;
+        usage(raw_argv[0]);
+        return 2;
+    }
+
+    if (!snapshot_in.empty()) {
+        const std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - restore_start;
+        std::cout << "restored " << snapshot_in << " at t=" << start_time << " in " << ms.count() << " ms"
+                  << std::endl;
+    }
+
+    auto rootCoordinator = cadmium::RootCoordinator(model, start_time);
+    if (port_log) {
+        logger->start();
+    } else if (logger) {
+        rootCoordinator.setLogger(logger);
+    }
+
+    const auto run_start = std::chrono::steady_clock::now();
     rootCoordinator.start();
-    rootCoordinator.simulate(50.0);  // minutes
+    if (!snapshot_out.empty() && snapshot_at > start_time && snapshot_at < end_time) {
+        rootCoordinator.simulate(snapshot_at - start_time);
+        checkpoint->take(snapshot_at).save(snapshot_out);
+        rootCoordinator.simulate(end_time - snapshot_at);
+    } else {
+        rootCoordinator.simulate(end_time - start_time);
+    }
     rootCoordinator.stop();
+    if (port_log) {
+        logger->stop();
+    }
+    if (end_time == std::numeric_limits<double>::infinity()) {
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - run_start;
+        std::cout << "drained at t=" << kpi->last_time << " (" << kpi->served << " of " << kpi->calls
+                  << " calls served, " << kpi->rejected << " rejected) in " << wall.count() << " s" << std::endl;
+    }
+
+    fe::write_summary(std::cout, *kpi);
+    std::ofstream summary("../simulation_results/freight_elevator_kpi.txt");
+    fe::write_summary(summary, *kpi);
+
+#ifdef FE_INSTRUMENT
+    // Built with 'make INSTRUMENT=1': per-atomic costs and a Perfetto timeline
+    auto& profiler = fe::instrument::Profiler::current();
+    profiler.write_summary(std::cout);
+    profiler.write_chrome_trace("../simulation_results/freight_elevator_trace.json");
+#endif
 
     return 0;
 }
@@ -0,0 +1,139 @@
+#include <cadmium/core/logger/csv.hpp>
+#include <cadmium/core/simulation/root_coordinator.hpp>
+#include <csignal>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "realtime_experiment.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/realtime.hpp"
+#include "../data_structures/scheduling.hpp"
+
+// Shadow controller: runs FreightElevatorTop against the wall clock, fed by
+// calls arriving on a local Unix socket or named pipe (see tools/feed_replay.cpp
+// to push an input_data file through it).
+
+namespace {
+    volatile std::sig_atomic_t stop_requested = 0;
+
+    void request_stop(int /*signal*/) {
+        stop_requested = 1;
+    }
+
+    void usage(const char* argv0) {
+        std::fprintf(stderr,
+            "usage: %s <socket|fifo> [policy] [options]\n"
+            "  policy                   fifo (default), scan, look, nearest or lookahead\n"
+            "  --speed 1                simulated minutes per wall-clock minute\n"
+            "  --tick 10                wall ms per simulation slice (and feed poll)\n"
+            "  --tolerance 50           wall ms after which an event counts as late\n"
+            "  --minutes M              stop after M simulated minutes (default: never)\n"
+            "  --exit-on-close          stop once the first writer disconnects and\n"
+            "  --tail 30                this many simulated minutes have passed\n"
+            "A socket is created at the path unless it is an existing FIFO. Ctrl-C stops the run.\n",
+            argv0);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    fe::ControlConfig config;
+    double speed = 1.0;
+    double tick_ms = 10.0;
+    double minutes = std::numeric_limits<double>::infinity();
+    double tail = 30.0;
+    bool exit_on_close = false;
+    auto stats = std::make_shared<fe::RealTimeStats>();
+
+    try {
+        for (int i = 2; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--exit-on-close") {
+                exit_on_close = true;
+                continue;
+            }
+            if (arg.rfind("--", 0) != 0) {
+                config.policy = fe::parse_policy(arg);
+                continue;
+            }
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            const double value = std::stod(argv[++i]);
+            if (arg == "--speed") {
+                speed = value;
+            } else if (arg == "--tick") {
+                tick_ms = value;
+            } else if (arg == "--tolerance") {
+                stats->tolerance_ms = value;
+            } else if (arg == "--minutes") {
+                minutes = value;
+            } else if (arg == "--tail") {
+                tail = value;
+            } else {
+                throw std::invalid_argument("unknown option: " + arg);
+            }
+        }
+        if (speed <= 0.0 || tick_ms <= 0.0) {
+            throw std::invalid_argument("--speed and --tick must be positive");
+        }
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::shared_ptr<fe::LiveFeed> feed;
+    try {
+        feed = std::make_shared<fe::LiveFeed>(argv[1]);
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        return 1;
+    }
+    std::signal(SIGINT, request_stop);
+    std::signal(SIGTERM, request_stop);
+
+    // One slice of simulated time per tick; the feed is polled once per slice
+    stats->clock.seconds_per_minute = 60.0 / speed;
+    const double slice = tick_ms / 1000.0 / stats->clock.seconds_per_minute;
+
+    auto kpi = std::make_shared<fe::RunKpi>();
+    auto model = std::make_shared<FreightElevatorRealTimeExperiment>("freight_elevator_realtime",
+                                                                     feed, slice, stats, config, kpi);
+    auto rootCoordinator = cadmium::RootCoordinator(model);
+    auto logger = std::make_shared<cadmium::CSVLogger>("../simulation_results/freight_elevator_realtime.csv", ";");
+    rootCoordinator.setLogger(logger);
+
+    std::printf("listening on %s (x%g, %g ms slices)\n", argv[1], speed, tick_ms);
+    std::fflush(stdout);
+
+    rootCoordinator.start();
+    double stop_at = minutes;
+    run_paced(rootCoordinator, *stats, slice, [&](double now) {
+        if (exit_on_close && feed->closed() && stop_at == std::numeric_limits<double>::infinity()) {
+            stop_at = now + tail;
+        }
+        return stop_requested != 0 || now >= stop_at;
+    });
+    rootCoordinator.stop();
+
+    if (feed->malformed() != 0) {
+        std::printf("%llu malformed feed lines dropped\n", static_cast<unsigned long long>(feed->malformed()));
+    }
+    std::ofstream summary("../simulation_results/freight_elevator_realtime.txt");
+    for (std::ostream* os : {static_cast<std::ostream*>(&std::cout), static_cast<std::ostream*>(&summary)}) {
+        fe::write_summary(*os, *kpi);
+        fe::write_summary(*os, *stats);
+    }
+    return 0;
+}
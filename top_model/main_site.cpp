@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "batch.hpp"
+#include "site.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+// Simulates every freight tower of a site in one process: one FreightTower
+// per line of the site file, partitioned across threads (see fe::run_site),
+// or all of them in one fe::ElevatorBatch (--batch).
+
+namespace {
+    void usage(const char* argv0) {
+        std::fprintf(stderr,
+            "usage: %s <site_file> [options]\n"
+            "  site file: one 'tower <name> <calls.fetrace|traffic_profile.txt> [policy] [seed]' per line\n"
+            "  --threads N              worker threads (default: all cores)\n"
+            "  --horizon 600            simulated minutes\n"
+            "  --sync 0                 minutes between progress barriers (0: none)\n"
+            "  --sequential             one coordinator for the whole site (reference run)\n"
+            "  --fused                  towers run the EFused atomic\n"
+            "  --batch                  towers run in one fe::ElevatorBatch, no coordinator\n"
+            "                           (one thread, means only: no site_kpi.txt, no --log/--sync)\n"
+            "  --vehicle FILE           vehicle profile timing every trip\n"
+            "  --log                    CSV log per tower in ../simulation_results/site_<name>.csv\n",
+            argv0);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    fe::SiteOptions options;
+    std::string vehicle_path;
+    bool batch = false;
+    try {
+        for (int i = 2; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--sequential") {
+                options.sequential = true;
+            } else if (arg == "--fused") {
+                options.fused = true;
+            } else if (arg == "--batch") {
+                batch = true;
+            } else if (arg == "--log") {
+                options.log_prefix = "../simulation_results/site_";
+            } else if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            } else if (arg == "--threads") {
+                options.threads = std::stoul(argv[++i]);
+            } else if (arg == "--horizon") {
+                options.horizon = std::stod(argv[++i]);
+            } else if (arg == "--sync") {
+                options.sync = std::stod(argv[++i]);
+            } else if (arg == "--vehicle") {
+                vehicle_path = argv[++i];
+            } else {
+                throw std::invalid_argument("unknown option: " + arg);
+            }
+        }
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "%s\n", ex.what());
+        usage(argv[0]);
+        return 2;
+    }
+
+    try {
+        auto towers = fe::load_site(argv[1]);
+        if (!vehicle_path.empty()) {
+            auto travel = std::make_shared<const fe::TravelTable>(fe::VehicleProfile::load(vehicle_path));
+            for (auto& tower : towers) {
+                if (tower.control.bottom_floor < travel->lowest() || tower.control.top_floor > travel->top()) {
+                    throw std::invalid_argument(vehicle_path + " does not cover the floors of tower " + tower.name);
+                }
+                tower.control.travel = travel;
+            }
+        }
+
+        if (batch) {
+            const auto start = std::chrono::steady_clock::now();
+            fe::ElevatorBatch engine(towers);
+            engine.run(options.horizon);
+            const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+            std::printf("%-16s %8s %8s %10s %10s\n", "tower", "calls", "served", "mean_wait", "mean_trip");
+            std::uint64_t calls = 0;
+            std::uint64_t served = 0;
+            for (std::size_t i = 0; i < towers.size(); ++i) {
+                const fe::BatchKpi k = engine.kpi(i);
+                std::printf("%-16s %8llu %8llu %10.3f %10.3f\n", towers[i].name.c_str(),
+                            static_cast<unsigned long long>(k.calls), static_cast<unsigned long long>(k.served),
+                            k.wait.mean, k.trip.mean);
+                calls += k.calls;
+                served += k.served;
+            }
+            std::printf("%zu towers, %llu calls, %llu served in %.3f s in one batch (%.0f calls/s)\n",
+                        towers.size(), static_cast<unsigned long long>(calls),
+                        static_cast<unsigned long long>(served), wall.count(),
+                        static_cast<double>(calls) / wall.count());
+            return 0;
+        }
+
+        std::vector<std::shared_ptr<fe::RunKpi>> kpis;
+        for (std::size_t i = 0; i < towers.size(); ++i) {
+            kpis.push_back(std::make_shared<fe::RunKpi>());
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        fe::run_site(towers, options, kpis, [&](double now) {
+            if (now >= options.horizon) {
+                return;
+            }
+            std::uint64_t served = 0;
+            for (const auto& kpi : kpis) {
+                served += kpi->served;
+            }
+            const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+            std::printf("t=%g: %llu calls served (%.2f s)\n", now, static_cast<unsigned long long>(served),
+                        wall.count());
+            std::fflush(stdout);
+        });
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+        std::ofstream summary("../simulation_results/site_kpi.txt");
+        std::printf("%-16s %8s %8s %10s %10s\n", "tower", "calls", "served", "mean_wait", "mean_trip");
+        std::uint64_t calls = 0;
+        std::uint64_t served = 0;
+        for (std::size_t i = 0; i < towers.size(); ++i) {
+            const fe::RunKpi& k = *kpis[i];
+            std::printf("%-16s %8llu %8llu %10.3f %10.3f\n", towers[i].name.c_str(),
+                        static_cast<unsigned long long>(k.calls), static_cast<unsigned long long>(k.served),
+                        k.wait.mean, k.trip.mean);
+            summary << "# tower " << towers[i].name << "\n";
+            fe::write_summary(summary, k);
+            calls += k.calls;
+            served += k.served;
+        }
+        const std::size_t threads = options.sequential ? 1 : std::min(options.threads, towers.size());
+        std::printf("%zu towers, %llu calls, %llu served in %.3f s on %zu thread(s) (%.0f calls/s)\n",
+                    towers.size(), static_cast<unsigned long long>(calls), static_cast<unsigned long long>(served),
+                    wall.count(), threads, static_cast<double>(calls) / wall.count());
+    } catch (const std::exception& ex) {
+        std::fprintf(stderr, "error: %s\n", ex.what());
+        return 1;
+    }
+    return 0;
+}
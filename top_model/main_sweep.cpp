@@ -0,0 +1,226 @@
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sweep.hpp"
+#include "../data_structures/vehicle_profile.hpp"
+
+namespace {
+    void usage() {
+        std::cerr <<
+            "usage: freight_elevator_sweep [options]\n"
+            "  --cars 1,2,4             car counts\n"
+            "  --policy fifo,look       scheduling policies (fifo, scan, look, nearest, lookahead)\n"
+            "  --pattern up,down,inter  preset traffic patterns (default: up)\n"
+            "  --profile FILE           traffic profile file instead of --pattern;\n"
+            "                           --rate then scales its phase rates\n"
+            "  --rate 0.5,1             passengers per minute (or profile scale)\n"
+            "  --floors 10,20           top floor of the preset patterns\n"
+            "  --horizon 600            simulated minutes per replication\n"
+            "  --min-reps 5 --max-reps 200 --precision 0.05\n"
+            "                           stop once the 95% CI of mean wait is within\n"
+            "                           precision * mean\n"
+            "  --seed 1                 base seed\n"
+            "  --threads N              worker threads (default: all cores)\n"
+            "  --model coupled|fused    car model: ElevatorCoupled or the EFused atomic\n"
+            "  --vehicle FILE           vehicle profile timing every trip (default: 1 minute\n"
+            "                           per floor, no door dwell)\n"
+            "  --warmup 0               simulated minutes run once per point; replications\n"
+            "                           start from its snapshot instead of an empty building\n"
+            "  --out FILE               CSV output (default: ../simulation_results/sweep.csv)\n";
+    }
+
+    template <typename T>
+    std::vector<T> parse_list(const std::string& text) {
+        std::vector<T> values;
+        std::istringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            std::istringstream field(item);
+            T value;
+            if (!(field >> value)) {
+                throw std::invalid_argument("bad list value: " + item);
+            }
+            values.push_back(value);
+        }
+        return values;
+    }
+
+    std::vector<std::string> split(const std::string& text) {
+        std::vector<std::string> values;
+        std::istringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            values.push_back(item);
+        }
+        return values;
+    }
+
+    // Human-readable description of one grid point, kept next to its SweepPoint
+    struct PointLabel {
+        std::string pattern;
+        double rate;
+    };
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> cars = {1};
+    std::vector<std::string> policies = {"fifo"};
+    std::vector<std::string> patterns = {"up"};
+    std::vector<double> rates = {0.5};
+    std::vector<fe::Floor> floors = {10};
+    std::string profile_path;
+    std::string vehicle_path;
+    std::string out_path = "../simulation_results/sweep.csv";
+    fe::SweepOptions options;
+    std::size_t threads = std::thread::hardware_concurrency();
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                usage();
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (arg == "--cars") {
+                cars = parse_list<std::size_t>(value);
+            } else if (arg == "--policy") {
+                policies = split(value);
+            } else if (arg == "--pattern") {
+                patterns = split(value);
+            } else if (arg == "--profile") {
+                profile_path = value;
+            } else if (arg == "--rate") {
+                rates = parse_list<double>(value);
+            } else if (arg == "--floors") {
+                floors = parse_list<fe::Floor>(value);
+            } else if (arg == "--horizon") {
+                options.horizon = std::stod(value);
+            } else if (arg == "--min-reps") {
+                options.min_replications = std::stoul(value);
+            } else if (arg == "--max-reps") {
+                options.max_replications = std::stoul(value);
+            } else if (arg == "--precision") {
+                options.relative_precision = std::stod(value);
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (arg == "--threads") {
+                threads = std::stoul(value);
+            } else if (arg == "--model") {
+                if (value != "coupled" && value != "fused") {
+                    throw std::invalid_argument("unknown model: " + value);
+                }
+                options.fused = value == "fused";
+            } else if (arg == "--vehicle") {
+                vehicle_path = value;
+            } else if (arg == "--warmup") {
+                options.warmup = std::stod(value);
+            } else if (arg == "--out") {
+                out_path = value;
+            } else {
+                usage();
+                return 1;
+            }
+        }
+
+        // Build the grid: traffic x rate x cars x policy
+        std::vector<fe::TrafficProfile> traffics;
+        std::vector<std::string> traffic_names;
+        if (!profile_path.empty()) {
+            traffics.push_back(fe::TrafficProfile::load(profile_path));
+            traffic_names.push_back(profile_path);
+        } else {
+            for (const auto& pattern : patterns) {
+                for (fe::Floor top : floors) {
+                    if (pattern == "up") {
+                        traffics.push_back(fe::TrafficProfile::up_peak(top, 1.0));
+                    } else if (pattern == "down") {
+                        traffics.push_back(fe::TrafficProfile::down_peak(top, 1.0));
+                    } else if (pattern == "inter") {
+                        traffics.push_back(fe::TrafficProfile::inter_floor(top, 1.0));
+                    } else {
+                        throw std::invalid_argument("unknown pattern: " + pattern);
+                    }
+                    traffic_names.push_back(pattern);
+                }
+            }
+        }
+
+        // One table for the whole grid: every car of every point shares it
+        std::shared_ptr<const fe::TravelTable> travel;
+        if (!vehicle_path.empty()) {
+            travel = std::make_shared<const fe::TravelTable>(fe::VehicleProfile::load(vehicle_path));
+            for (const auto& traffic : traffics) {
+                if (traffic.lobby < travel->lowest() || traffic.top_floor > travel->top()) {
+                    throw std::invalid_argument(vehicle_path + " does not cover floors "
+                                                + std::to_string(traffic.lobby) + ".."
+                                                + std::to_string(traffic.top_floor));
+                }
+            }
+        }
+
+        std::vector<fe::SweepPoint> points;
+        std::vector<PointLabel> labels;
+        for (std::size_t t = 0; t < traffics.size(); ++t) {
+            for (double rate : rates) {
+                // Presets are built with rate 1, so the rate is a plain multiplier
+                fe::TrafficProfile traffic = traffics[t];
+                for (auto& phase : traffic.phases) {
+                    phase.rate *= rate;
+                }
+                for (std::size_t n : cars) {
+                    for (const auto& policy : policies) {
+                        fe::SweepPoint point;
+                        point.cars = n;
+                        point.control.policy = fe::parse_policy(policy);
+                        point.control.bottom_floor = traffic.lobby;
+                        point.control.top_floor = traffic.top_floor;
+                        point.control.travel = travel;
+                        point.traffic = traffic;
+                        points.push_back(point);
+                        labels.push_back(PointLabel{traffic_names[t], rate});
+                    }
+                }
+            }
+        }
+
+        fe::WorkStealingPool pool(threads);
+        const auto start = std::chrono::steady_clock::now();
+        const auto results = fe::run_sweep(points, options, pool);
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+        std::ofstream out(out_path);
+        if (!out) {
+            throw std::runtime_error("cannot write " + out_path);
+        }
+        out << "pattern;rate;floors;cars;policy;replications;converged;"
+               "mean_wait;ci95;wait_sd;wait_p95;mean_trip;served_per_hour;run_seconds\n";
+        std::size_t replications = 0;
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const auto& p = points[i];
+            const auto& r = results[i];
+            out << labels[i].pattern << ';' << labels[i].rate << ';' << p.traffic.top_floor << ';'
+                << p.cars << ';' << p.control.policy << ';' << r.replications << ';' << r.converged << ';'
+                << r.mean_wait.mean << ';' << r.ci_half_width << ';' << r.wait.stddev() << ';'
+                << r.wait_histogram.quantile(0.95) << ';'
+                << r.trip.mean << ';' << r.served_per_hour << ';' << r.wall_seconds << '\n';
+            replications += r.replications;
+        }
+
+        std::cout << points.size() << " points, " << replications << " replications on "
+                  << pool.size() << " threads in " << wall.count() << " s -> " << out_path << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
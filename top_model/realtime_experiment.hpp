@@ -0,0 +1,83 @@
+#ifndef FREIGHT_ELEVATOR_REALTIME_EXPERIMENT_HPP
+#define FREIGHT_ELEVATOR_REALTIME_EXPERIMENT_HPP
+
+#include "cadmium/modeling/devs/coupled.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "experiment.hpp"
+#include "freight_elevator_top.hpp"
+#include "../atomics/elive_feed.hpp"
+#include "../atomics/erealtime_probe.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/realtime.hpp"
+
+/**
+ * Shadow-controller experiment:
+ * - ELiveFeed injects the calls of a live feed (Unix socket or named pipe)
+ *   into FreightElevatorTop, polling every 'poll' simulated minutes
+ * - ERealTimeProbe measures call -> travel command latency and late events
+ *   into 'stats'; EMonitor collects the usual KPIs into 'kpi' (optional)
+ * - Exposes the reached floors and served requests for logging
+ * Run it under a wall-clock paced driver (top_model/main_realtime.cpp).
+ */
+struct FreightElevatorRealTimeExperiment : public Coupled {
+    Port<fe::Floor> floor_out;
+    Port<fe::Call> served_out;
+
+    FreightElevatorRealTimeExperiment(const std::string& id,
+                                      std::shared_ptr<fe::LiveFeed> feed,
+                                      double poll,
+                                      std::shared_ptr<fe::RealTimeStats> stats,
+                                      const fe::ControlConfig& config = fe::ControlConfig(),
+                                      std::shared_ptr<fe::RunKpi> kpi = nullptr)
+        : Coupled(id) {
+
+        floor_out = addOutPort<fe::Floor>("floor_out");
+        served_out = addOutPort<fe::Call>("served_out");
+
+        auto calls = addComponent<ELiveFeed>("calls", std::move(feed), poll, stats);
+        auto system = addComponent<FreightElevatorTop>("freight_elevator", config);
+        auto probe = addComponent<ERealTimeProbe>("probe", std::move(stats));
+
+        addCoupling(calls->inside_call, system->inside_call);
+        addCoupling(calls->outside_call, system->outside_call);
+        addCoupling(system->floor, floor_out);
+        addCoupling(system->served, served_out);
+
+        addCoupling(calls->inside_call, probe->inside_call);
+        addCoupling(calls->outside_call, probe->outside_call);
+        addCoupling(system->timem, probe->timem);
+        addCoupling(system->floor, probe->floor);
+
+        add_kpi_monitor(*this, calls->inside_call, calls->outside_call, system->served, system->rejected, std::move(kpi));
+    }
+};
+
+/**
+ * Runs 'root' (already started) against the wall clock in slices of 'slice'
+ * simulated minutes: the events of [t, t + slice) run once t is due on
+ * stats.clock, which starts now. Between slices the thread sleeps, so events
+ * inside a slice run up to one slice early and never late unless the model
+ * falls behind. 'stop(t)' is asked after every slice; the run ends when it
+ * returns true.
+ */
+template <typename Root, typename Stop>
+void run_paced(Root& root, fe::RealTimeStats& stats, double slice, Stop&& stop) {
+    stats.clock.start = fe::WallClock::now();
+    double now = 0.0;
+    for (std::uint64_t k = 1; !stop(now); ++k) {
+        const auto due = stats.clock.due(now);
+        std::this_thread::sleep_until(due);
+        stats.slices++;
+        if (fe::elapsed_ms(due, fe::WallClock::now()) > stats.tolerance_ms) {
+            stats.late_slices++;
+        }
+        root.simulate(slice);
+        now = static_cast<double>(k) * slice;
+    }
+}
+
+#endif
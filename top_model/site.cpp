@@ -0,0 +1,261 @@
+#include "site.hpp"
+
+#include <cadmium/core/logger/csv.hpp>
+#include <cadmium/core/simulation/root_coordinator.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+namespace fe {
+
+namespace {
+    // Reusable barrier for a fixed number of threads (std::barrier is C++20).
+    class Barrier {
+    public:
+        explicit Barrier(std::size_t parties) : parties(parties) {}
+
+        void arrive_and_wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            const std::uint64_t gen = generation;
+            if (++arrived == parties) {
+                arrived = 0;
+                ++generation;
+                cv.notify_all();
+                return;
+            }
+            cv.wait(lock, [&] { return generation != gen; });
+        }
+
+    private:
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::size_t parties;
+        std::size_t arrived = 0;
+        std::uint64_t generation = 0;
+    };
+
+    // Barrier times: every 'sync' minutes, then the horizon.
+    std::vector<double> window_ends(const SiteOptions& options) {
+        std::vector<double> ends;
+        if (options.sync > 0.0) {
+            for (std::size_t k = 1; static_cast<double>(k) * options.sync < options.horizon; ++k) {
+                ends.push_back(static_cast<double>(k) * options.sync);
+            }
+        }
+        ends.push_back(options.horizon);
+        return ends;
+    }
+
+    std::shared_ptr<cadmium::Logger> make_logger(const std::string& prefix, const std::string& name) {
+        if (prefix.empty()) {
+            return nullptr;
+        }
+        return std::make_shared<cadmium::CSVLogger>(prefix + name + ".csv", ";");
+    }
+
+    void run_sequential(const std::vector<TowerSpec>& towers, const SiteOptions& options,
+                        const std::vector<std::shared_ptr<RunKpi>>& kpis,
+                        const std::function<void(double)>& on_sync) {
+        auto model = std::make_shared<FreightSite>("site", towers, kpis, options.fused);
+        auto rootCoordinator = cadmium::RootCoordinator(model);
+        if (auto logger = make_logger(options.log_prefix, "site")) {
+            rootCoordinator.setLogger(logger);
+        }
+        rootCoordinator.start();
+        double now = 0.0;
+        for (double end : window_ends(options)) {
+            rootCoordinator.simulate(end - now);
+            now = end;
+            if (on_sync) {
+                on_sync(end);
+            }
+        }
+        rootCoordinator.stop();
+    }
+
+    // Towers of each thread: largest expected load first onto the least loaded thread.
+    std::vector<std::vector<std::size_t>> partition(const std::vector<TowerSpec>& towers, std::size_t threads,
+                                                    double horizon) {
+        std::vector<double> load(towers.size());
+        for (std::size_t i = 0; i < towers.size(); ++i) {
+            load[i] = expected_calls(towers[i], horizon);
+        }
+        std::vector<std::size_t> order(towers.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return load[a] > load[b]; });
+
+        std::vector<std::vector<std::size_t>> parts(threads);
+        std::vector<double> total(threads, 0.0);
+        for (std::size_t i : order) {
+            const auto t = static_cast<std::size_t>(std::min_element(total.begin(), total.end()) - total.begin());
+            parts[t].push_back(i);
+            total[t] += load[i];
+        }
+        return parts;
+    }
+}
+
+std::vector<TowerSpec> load_site(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open site file: " + path);
+    }
+
+    std::vector<TowerSpec> towers;
+    std::map<std::string, std::shared_ptr<const TraceFile>> traces;  // one mapping per file
+    const std::string trace_ext = ".fetrace";
+    std::string line;
+    int line_no = 0;
+    while (std::getline(file, line)) {
+        ++line_no;
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key) || key[0] == '#') {
+            continue;
+        }
+        TowerSpec tower;
+        std::string input;
+        if (key != "tower" || !(in >> tower.name >> input)) {
+            throw std::runtime_error(path + ":" + std::to_string(line_no) + ": malformed line: " + line);
+        }
+        std::string policy;
+        if (in >> policy) {
+            tower.control.policy = parse_policy(policy);
+        }
+        std::string seed;
+        tower.seed = (in >> seed) ? std::stoull(seed) : towers.size() + 1;
+
+        if (input.size() > trace_ext.size()
+            && input.compare(input.size() - trace_ext.size(), trace_ext.size(), trace_ext) == 0) {
+            auto& trace = traces[input];
+            if (!trace) {
+                trace = std::make_shared<const TraceFile>(input);
+            }
+            tower.trace = trace;
+            floor_range(*trace, tower.control.bottom_floor, tower.control.top_floor);
+        } else {
+            tower.traffic = TrafficProfile::load(input);
+            tower.control.bottom_floor = tower.traffic.lobby;
+            tower.control.top_floor = tower.traffic.top_floor;
+        }
+        towers.push_back(std::move(tower));
+    }
+    return towers;
+}
+
+double expected_calls(const TowerSpec& spec, double horizon) {
+    if (spec.trace) {
+        const auto end = std::lower_bound(spec.trace->begin(), spec.trace->end(), horizon,
+                                          [](const TraceRecord& r, double t) { return r.time < t; });
+        return static_cast<double>(end - spec.trace->begin());
+    }
+    // Two calls per passenger (car call, then hall call)
+    double passengers = 0.0;
+    const auto& phases = spec.traffic.phases;
+    for (std::size_t k = 0; k < phases.size(); ++k) {
+        const double start = std::max(phases[k].start, 0.0);
+        const double end = k + 1 < phases.size() ? std::min(phases[k + 1].start, horizon) : horizon;
+        if (end > start) {
+            passengers += phases[k].rate * (end - start);
+        }
+    }
+    return 2.0 * passengers;
+}
+
+void run_site(const std::vector<TowerSpec>& towers, const SiteOptions& options,
+              const std::vector<std::shared_ptr<RunKpi>>& kpis,
+              const std::function<void(double)>& on_sync) {
+    if (kpis.size() != towers.size()) {
+        throw std::invalid_argument("run_site needs one KPI sink (or nullptr) per tower");
+    }
+    if (options.sequential) {
+        run_sequential(towers, options, kpis, on_sync);
+        return;
+    }
+
+    const std::size_t threads = std::max<std::size_t>(1, std::min(options.threads, towers.size()));
+    const auto parts = partition(towers, threads, options.horizon);
+    const auto ends = window_ends(options);
+
+    // Each window: the workers advance their towers, everybody meets, the
+    // caller runs on_sync, everybody meets again
+    Barrier barrier(threads + 1);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto fail = [&] {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+            error = std::current_exception();
+        }
+    };
+
+    auto work = [&](const std::vector<std::size_t>& mine) {
+        // Built on the thread that runs them (per-thread instrumentation)
+        std::vector<std::shared_ptr<FreightTower>> models;
+        std::vector<std::unique_ptr<cadmium::RootCoordinator>> roots;
+        bool failed = false;
+        try {
+            for (std::size_t i : mine) {
+                models.push_back(std::make_shared<FreightTower>(towers[i].name, towers[i], kpis[i], options.fused));
+                roots.push_back(std::make_unique<cadmium::RootCoordinator>(models.back()));
+                if (auto logger = make_logger(options.log_prefix, towers[i].name)) {
+                    roots.back()->setLogger(logger);
+                }
+                roots.back()->start();
+            }
+        } catch (...) {
+            fail();
+            failed = true;
+        }
+        double now = 0.0;
+        for (double end : ends) {
+            if (!failed) {
+                try {
+                    for (auto& root : roots) {
+                        root->simulate(end - now);
+                    }
+                } catch (...) {
+                    fail();
+                    failed = true;
+                }
+            }
+            now = end;
+            barrier.arrive_and_wait();
+            barrier.arrive_and_wait();
+        }
+        for (auto& root : roots) {
+            root->stop();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (const auto& mine : parts) {
+        workers.emplace_back(work, std::cref(mine));
+    }
+    for (double end : ends) {
+        barrier.arrive_and_wait();
+        if (on_sync) {
+            try {
+                on_sync(end);
+            } catch (...) {
+                fail();
+            }
+        }
+        barrier.arrive_and_wait();
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+}
@@ -0,0 +1,127 @@
+#ifndef FE_SITE_HPP
+#define FE_SITE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cadmium/modeling/devs/coupled.hpp"
+#include "experiment.hpp"
+#include "../data_structures/call_trace.hpp"
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/traffic_profile.hpp"
+
+namespace fe {
+    /**
+     * One freight tower of a site: a single car (FreightElevatorTop) fed by
+     * a binary call trace, or by the ETraffic generator when 'trace' is null.
+     */
+    struct TowerSpec {
+        std::string name;
+        std::shared_ptr<const TraceFile> trace;  // shared read-only by every run
+        TrafficProfile traffic;
+        std::uint64_t seed = 1;
+        ControlConfig control;
+    };
+
+    /**
+     * Reads a site file, one tower per line:
+     *   tower <name> <calls.fetrace | traffic_profile.txt> [policy] [seed]
+     * Paths are relative to the working directory; towers without a policy
+     * use fifo, towers without a seed their position in the file (from 1).
+     * A trace sets the SCAN range to its floors, a profile to its own.
+     * Blank lines and lines starting with '#' are ignored.
+     * Throws std::runtime_error on a malformed file or an unreadable input.
+     */
+    std::vector<TowerSpec> load_site(const std::string& path);
+
+    // Expected number of calls tower 'spec' receives before 'horizon' (load balancing).
+    double expected_calls(const TowerSpec& spec, double horizon);
+}
+
+/**
+ * One tower: its call source, FreightElevatorTop (or EFused with 'fused')
+ * and, with 'kpi', an EMonitor. Built as a component of FreightSite for
+ * sequential runs, or on its own as the root model of a tower's thread.
+ */
+struct FreightTower : public Coupled {
+    Port<fe::Floor> floor_out;
+    Port<fe::Call> served_out;
+
+    FreightTower(const std::string& id, const fe::TowerSpec& spec, std::shared_ptr<fe::RunKpi> kpi = nullptr,
+                 bool fused = false)
+        : Coupled(id) {
+        floor_out = addOutPort<fe::Floor>("floor_out");
+        served_out = addOutPort<fe::Call>("served_out");
+
+        Port<fe::Call> inside_call;
+        Port<fe::Call> outside_call;
+        if (spec.trace) {
+            auto calls = addComponent<ETraceReader>("calls", spec.trace);
+            inside_call = calls->inside_call;
+            outside_call = calls->outside_call;
+        } else {
+            auto traffic = addComponent<ETraffic>("traffic", spec.traffic, spec.seed);
+            inside_call = traffic->inside_call;
+            outside_call = traffic->outside_call;
+        }
+        auto system = add_single_car(*this, inside_call, outside_call, spec.control, fused);
+        addCoupling(system.floor, floor_out);
+        addCoupling(system.served, served_out);
+
+        add_kpi_monitor(*this, inside_call, outside_call, system.served, system.rejected, std::move(kpi));
+    }
+};
+
+/**
+ * Site coupled model: independent towers side by side, with no couplings
+ * between them. Simulated under one RootCoordinator it is the sequential
+ * reference of fe::run_site.
+ */
+struct FreightSite : public Coupled {
+    FreightSite(const std::string& id, const std::vector<fe::TowerSpec>& towers,
+                const std::vector<std::shared_ptr<fe::RunKpi>>& kpis, bool fused = false)
+        : Coupled(id) {
+        for (std::size_t i = 0; i < towers.size(); ++i) {
+            addComponent<FreightTower>(towers[i].name, towers[i], kpis[i], fused);
+        }
+    }
+};
+
+namespace fe {
+    struct SiteOptions {
+        double horizon = 600.0;           // simulated minutes
+        double sync = 0.0;                // minutes between shared-clock barriers (0: horizon only)
+        std::size_t threads = std::thread::hardware_concurrency();
+        bool sequential = false;          // one FreightSite under one RootCoordinator
+        bool fused = false;               // towers run EFused instead of FreightElevatorTop
+        std::string log_prefix;           // CSV log per tower at <prefix><name>.csv (sequential:
+                                          // <prefix>site.csv); empty: no logging
+    };
+
+    /**
+     * Simulates every tower up to options.horizon, filling kpis[i] (may be
+     * null) for towers[i].
+     * - Towers exchange no messages, so the lookahead between them is
+     *   unbounded: each thread owns a fixed partition of towers (largest
+     *   expected load first onto the least loaded thread), builds them and
+     *   runs each one under its own RootCoordinator, and threads only meet
+     *   at the shared-clock barriers every options.sync minutes.
+     * - At each barrier every tower has processed exactly the events before
+     *   that time; 'on_sync' is then called on the caller's thread with the
+     *   time, while the towers are paused (the KPIs may be read).
+     * - Every tower sees the same events at the same times as in the
+     *   sequential FreightSite, so the KPIs are identical for any thread count.
+     * Rethrows the first exception a tower threw, once every thread stopped.
+     */
+    void run_site(const std::vector<TowerSpec>& towers, const SiteOptions& options,
+                  const std::vector<std::shared_ptr<RunKpi>>& kpis,
+                  const std::function<void(double)>& on_sync = nullptr);
+}
+
+#endif
@@ -0,0 +1,198 @@
+#include "sweep.hpp"
+
+#include <cadmium/core/simulation/root_coordinator.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "experiment.hpp"
+#include "../data_structures/rng.hpp"
+
+namespace fe {
+
+namespace {
+    // Two-sided 95% Student t quantile with 'df' degrees of freedom.
+    double t_quantile_95(std::size_t df) {
+        static const double table[] = {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+        };
+        if (df == 0) {
+            return std::numeric_limits<double>::infinity();
+        }
+        if (df <= 30) {
+            return table[df - 1];
+        }
+        // Cornish-Fisher expansion around the normal quantile
+        const double z = 1.959964;
+        const double n = static_cast<double>(df);
+        return z + (z * z * z + z) / (4.0 * n)
+                 + (5.0 * std::pow(z, 5) + 16.0 * z * z * z + 3.0 * z) / (96.0 * n * n);
+    }
+
+    double half_width(const RunningStats& s) {
+        if (s.n < 2) {
+            return std::numeric_limits<double>::infinity();
+        }
+        return t_quantile_95(s.n - 1) * s.stddev() / std::sqrt(static_cast<double>(s.n));
+    }
+
+    // Bookkeeping of one sweep point, the only state replications share.
+    struct PointRun {
+        std::mutex mutex;
+        std::vector<std::optional<RunKpi>> results;  // by replication index, released once accepted
+        std::vector<double> wall;                    // seconds, by replication index
+        std::size_t submitted = 0;
+        std::size_t accepted = 0;                    // length of the completed prefix
+        bool done = false;
+        SweepResult result;
+    };
+}
+
+std::uint64_t replication_seed(std::uint64_t base, std::size_t point, std::size_t rep) {
+    Rng mix(base ^ (0x9E3779B97F4A7C15ULL * (static_cast<std::uint64_t>(point) + 1)));
+    mix.state ^= Rng(static_cast<std::uint64_t>(rep)).next();
+    return mix.next();
+}
+
+RunKpi run_replication(const SweepPoint& point, double horizon, std::uint64_t seed, bool fused,
+                       std::shared_ptr<const Snapshot> warm) {
+    auto kpi = std::make_shared<RunKpi>();
+    auto checkpoint = warm ? std::make_shared<Checkpoint>(std::move(warm), true) : nullptr;
+    auto model = std::make_shared<ElevatorBankTrafficExperiment>("sweep",
+                                                                 point.cars,
+                                                                 point.traffic,
+                                                                 seed,
+                                                                 point.control,
+                                                                 kpi,
+                                                                 fused,
+                                                                 checkpoint);
+    auto rootCoordinator = cadmium::RootCoordinator(model, checkpoint ? checkpoint->start_time() : 0.0);
+    rootCoordinator.start();
+    rootCoordinator.simulate(horizon);
+    rootCoordinator.stop();
+    return *kpi;
+}
+
+Snapshot warm_up(const SweepPoint& point, double warmup, std::uint64_t seed, bool fused) {
+    auto checkpoint = std::make_shared<Checkpoint>();
+    auto model = std::make_shared<ElevatorBankTrafficExperiment>("sweep",
+                                                                 point.cars,
+                                                                 point.traffic,
+                                                                 seed,
+                                                                 point.control,
+                                                                 std::make_shared<RunKpi>(),
+                                                                 fused,
+                                                                 checkpoint);
+    auto rootCoordinator = cadmium::RootCoordinator(model);
+    rootCoordinator.start();
+    rootCoordinator.simulate(warmup);
+    rootCoordinator.stop();
+    return checkpoint->take(warmup);
+}
+
+std::vector<SweepResult> run_sweep(const std::vector<SweepPoint>& points,
+                                   const SweepOptions& options,
+                                   WorkStealingPool& pool) {
+    const std::size_t min_reps = std::max<std::size_t>(options.min_replications, 2);
+    const std::size_t max_reps = std::max(options.max_replications, min_reps);
+
+    // Keep enough replications in flight to fill the pool even with few points
+    const std::size_t n_points = std::max<std::size_t>(points.size(), 1);
+    const std::size_t window = std::max(min_reps, (pool.size() + n_points - 1) / n_points);
+
+    // Warm-up snapshots, one per point, shared read-only by its replications
+    std::vector<std::shared_ptr<const Snapshot>> warm(points.size());
+    if (options.warmup > 0.0) {
+        for (std::size_t p = 0; p < points.size(); ++p) {
+            pool.submit([&, p] {
+                // Seed outside the replications' sequence
+                const std::uint64_t seed = replication_seed(options.seed, p, max_reps);
+                warm[p] = std::make_shared<const Snapshot>(warm_up(points[p], options.warmup, seed, options.fused));
+            });
+        }
+        pool.wait();
+    }
+
+    std::vector<std::unique_ptr<PointRun>> runs;
+    runs.reserve(points.size());
+    for (std::size_t p = 0; p < points.size(); ++p) {
+        runs.push_back(std::make_unique<PointRun>());
+        runs.back()->results.resize(max_reps);
+        runs.back()->wall.resize(max_reps, 0.0);
+    }
+
+    // Runs replication 'rep' of point 'p', then accepts the completed prefix
+    // and decides whether to launch another replication.
+    std::function<void(std::size_t, std::size_t)> replicate = [&](std::size_t p, std::size_t rep) {
+        const auto start = std::chrono::steady_clock::now();
+        RunKpi kpi = run_replication(points[p], options.horizon, replication_seed(options.seed, p, rep),
+                                     options.fused, warm[p]);
+        const std::chrono::duration<double> wall = std::chrono::steady_clock::now() - start;
+
+        PointRun& run = *runs[p];
+        bool submit_next = false;
+        std::size_t next = 0;
+        {
+            std::lock_guard<std::mutex> lock(run.mutex);
+            run.results[rep] = kpi;
+            run.wall[rep] = wall.count();
+
+            SweepResult& r = run.result;
+            while (!run.done && run.accepted < max_reps && run.results[run.accepted]) {
+                const RunKpi& k = *run.results[run.accepted];
+                r.mean_wait.add(k.wait.mean);
+                r.wait.merge(k.wait);
+                r.trip.merge(k.trip);
+                r.wait_histogram.merge(k.overall.wait);
+                r.served_per_hour += (static_cast<double>(k.served) / (options.horizon / 60.0) - r.served_per_hour)
+                                     / static_cast<double>(r.mean_wait.n);
+                r.wall_seconds += run.wall[run.accepted];
+                run.results[run.accepted].reset();  // histograms are large; keep only in-flight ones
+                run.accepted++;
+
+                r.replications = run.accepted;
+                r.ci_half_width = half_width(r.mean_wait);
+                if (run.accepted >= min_reps
+                    && r.ci_half_width <= options.relative_precision * std::abs(r.mean_wait.mean)) {
+                    r.converged = true;
+                    run.done = true;
+                } else if (run.accepted == max_reps) {
+                    run.done = true;
+                }
+            }
+
+            if (!run.done && run.submitted < max_reps) {
+                next = run.submitted++;
+                submit_next = true;
+            }
+        }
+        if (submit_next) {
+            pool.submit([&replicate, p, next] { replicate(p, next); });
+        }
+    };
+
+    for (std::size_t p = 0; p < points.size(); ++p) {
+        PointRun& run = *runs[p];
+        run.submitted = std::min(window, max_reps);
+        for (std::size_t rep = 0; rep < run.submitted; ++rep) {
+            pool.submit([&replicate, p, rep] { replicate(p, rep); });
+        }
+    }
+    pool.wait();
+
+    std::vector<SweepResult> results;
+    results.reserve(points.size());
+    for (auto& run : runs) {
+        results.push_back(run->result);
+    }
+    return results;
+}
+
+}
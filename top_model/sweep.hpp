@@ -0,0 +1,75 @@
+#ifndef FE_SWEEP_HPP
+#define FE_SWEEP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../data_structures/kpi.hpp"
+#include "../data_structures/scheduling.hpp"
+#include "../data_structures/snapshot.hpp"
+#include "../data_structures/traffic_profile.hpp"
+#include "thread_pool.hpp"
+
+namespace fe {
+    // One configuration of the sweep grid.
+    struct SweepPoint {
+        std::size_t cars = 1;
+        ControlConfig control;
+        TrafficProfile traffic;
+    };
+
+    struct SweepOptions {
+        double horizon = 600.0;           // simulated minutes per replication
+        std::size_t min_replications = 5;
+        std::size_t max_replications = 200;
+        double relative_precision = 0.05; // stop when CI half-width <= this * |mean wait|
+        std::uint64_t seed = 1;           // base seed; replication seeds derive from it
+        bool fused = false;               // cars are EFused atomics (same floors, fewer events)
+        double warmup = 0.0;              // simulated minutes run once per point and snapshotted;
+                                          // replications branch from it (0: start empty)
+    };
+
+    // Aggregated result of one sweep point over its accepted replications.
+    struct SweepResult {
+        std::size_t replications = 0;
+        bool converged = false;            // CI target met before max_replications
+        RunningStats mean_wait;            // across replications (one sample per replication)
+        double ci_half_width = 0.0;        // 95% CI half-width of mean_wait.mean
+        RunningStats wait;                 // pooled over every served call
+        RunningStats trip;
+        Histogram wait_histogram;          // pooled, for percentiles
+        double served_per_hour = 0.0;      // mean over replications
+        double wall_seconds = 0.0;         // summed simulation wall time
+    };
+
+    // Seed of replication 'rep' of point 'point' (independent of scheduling order).
+    std::uint64_t replication_seed(std::uint64_t base, std::size_t point, std::size_t rep);
+
+    // Runs one replication; every call builds its own model, nothing is shared
+    // but the read-only 'warm' snapshot it starts from (if any), with its
+    // traffic reseeded from 'seed'.
+    RunKpi run_replication(const SweepPoint& point, double horizon, std::uint64_t seed, bool fused = false,
+                           std::shared_ptr<const Snapshot> warm = nullptr);
+
+    // Runs 'point' from an empty building for 'warmup' minutes and returns its snapshot.
+    Snapshot warm_up(const SweepPoint& point, double warmup, std::uint64_t seed, bool fused = false);
+
+    /**
+     * Runs every point on 'pool', replicating each one until the 95% CI of
+     * its mean wait is tight enough (or max_replications is reached).
+     * - Replications are accepted in index order and the stopping rule is
+     *   checked on the accepted prefix, so the results do not depend on the
+     *   number of threads or on completion order.
+     * - With options.warmup, every point is first warmed up once (in parallel)
+     *   and its replications restore that snapshot instead of starting empty.
+     * - Runs share nothing but their point's bookkeeping; the pool must not
+     *   be used by anybody else until run_sweep returns.
+     */
+    std::vector<SweepResult> run_sweep(const std::vector<SweepPoint>& points,
+                                       const SweepOptions& options,
+                                       WorkStealingPool& pool);
+}
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef FE_THREAD_POOL_HPP
+#define FE_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fe {
+    /**
+     * Work-stealing thread pool for coarse tasks (whole simulation runs).
+     * - Every worker owns a deque: it pops its own work LIFO and steals FIFO
+     *   from the others when it runs dry, so follow-up tasks submitted by a
+     *   running task stay on the same core unless another one is idle.
+     * - Tasks submitted from outside the pool are spread round-robin.
+     * - wait() blocks until every task, including tasks submitted by tasks,
+     *   has finished, then rethrows the first exception a task threw.
+     */
+    class WorkStealingPool {
+    public:
+        explicit WorkStealingPool(std::size_t threads = std::thread::hardware_concurrency()) {
+            threads = std::max<std::size_t>(threads, 1);
+            for (std::size_t i = 0; i < threads; ++i) {
+                queues.push_back(std::make_unique<Queue>());
+            }
+            for (std::size_t i = 0; i < threads; ++i) {
+                workers.emplace_back([this, i] { run(i); });
+            }
+        }
+
+        ~WorkStealingPool() {
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                stopping = true;
+            }
+            idle_cv.notify_all();
+            for (auto& w : workers) {
+                w.join();
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        [[nodiscard]] std::size_t size() const { return workers.size(); }
+
+        void submit(std::function<void()> task) {
+            const std::size_t q = (current_pool == this) ? current_worker
+                                                         : next_queue.fetch_add(1) % queues.size();
+            unfinished.fetch_add(1);
+            {
+                std::lock_guard<std::mutex> lock(queues[q]->mutex);
+                queues[q]->tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex);
+                ++queued;
+            }
+            idle_cv.notify_one();
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(idle_mutex);
+            done_cv.wait(lock, [this] { return unfinished.load() == 0; });
+            if (error) {
+                std::exception_ptr e = error;
+                error = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+    private:
+        struct Queue {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues;
+        std::vector<std::thread> workers;
+
+        std::mutex idle_mutex;               // guards queued, stopping, error
+        std::condition_variable idle_cv;     // workers: work available or stopping
+        std::condition_variable done_cv;     // wait(): everything finished
+        std::size_t queued = 0;              // tasks not yet claimed by a worker
+        bool stopping = false;
+        std::exception_ptr error;
+
+        std::atomic<std::size_t> unfinished{0};  // submitted and not yet finished
+        std::atomic<std::size_t> next_queue{0};
+
+        inline static thread_local const WorkStealingPool* current_pool = nullptr;
+        inline static thread_local std::size_t current_worker = 0;
+
+        bool try_take(std::size_t self, std::function<void()>& task) {
+            {
+                Queue& own = *queues[self];
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if (!own.tasks.empty()) {
+                    task = std::move(own.tasks.back());
+                    own.tasks.pop_back();
+                    return true;
+                }
+            }
+            for (std::size_t k = 1; k < queues.size(); ++k) {
+                Queue& victim = *queues[(self + k) % queues.size()];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.tasks.empty()) {
+                    task = std::move(victim.tasks.front());
+                    victim.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run(std::size_t self) {
+            current_pool = this;
+            current_worker = self;
+            for (;;) {
+                {
+                    // Claim one queued task; the claim guarantees a task is in some deque
+                    std::unique_lock<std::mutex> lock(idle_mutex);
+                    idle_cv.wait(lock, [this] { return queued > 0 || stopping; });
+                    if (queued == 0) {
+                        return;
+                    }
+                    --queued;
+                }
+
+                std::function<void()> task;
+                while (!try_take(self, task)) {
+                    std::this_thread::yield();  // a thief holds the deque we need
+                }
+
+                try {
+                    task();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(idle_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+
+                if (unfinished.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(idle_mutex);
+                    done_cv.notify_all();
+                }
+            }
+        }
+    };
+}
+
+#endif